@@ -60,6 +60,9 @@
 #include "peripheral/dmac/plib_dmac.h"
 #include "peripheral/cmcc/plib_cmcc.h"
 #include "peripheral/eic/plib_eic.h"
+#include "peripheral/tc/plib_tc0.h"
+#include "peripheral/tc/plib_tc4.h"
+#include "peripheral/adc/plib_adc0.h"
 #include "driver/i2c/drv_i2c.h"
 #include "driver/usart/drv_usart.h"
 #include "driver/spi/drv_spi.h"
@@ -386,6 +386,12 @@ void SYS_Initialize ( void* data )
 
     EIC_Initialize();
 
+    ADC0_Initialize();
+
+    TC0_TimerInitialize();
+
+    TC4_CaptureInitialize();
+
 
 
     /* MISRAC 2012 deviation block start */
@@ -72,6 +72,8 @@ void DMAC_2_InterruptHandler (void);
 void SERCOM0_SPI_InterruptHandler (void);
 void SERCOM1_USART_InterruptHandler (void);
 void SERCOM6_I2C_InterruptHandler (void);
+void TC0_TimerInterruptHandler (void);
+void TC4_CaptureInterruptHandler (void);
 
 
 
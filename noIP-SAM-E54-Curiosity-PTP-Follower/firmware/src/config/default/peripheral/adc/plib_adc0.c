@@ -0,0 +1,149 @@
+/*******************************************************************************
+  Analog-to-Digital Converter(ADC0) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_adc0.c
+
+  Summary
+    ADC0 PLIB Implementation File.
+
+  Description
+    This file defines the interface to the ADC peripheral library. This
+    library provides access to and control of the associated peripheral
+    instance. Conversions are started by software and polled.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "interrupts.h"
+#include "plib_adc0.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: ADC0 Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void ADC0_Initialize( void )
+{
+    uint32_t calib = SW0_FUSES_REGS->FUSES_SW0_WORD_0;
+
+    /* Reset ADC */
+    ADC0_REGS->ADC_CTRLA = (uint16_t)ADC_CTRLA_SWRST_Msk;
+
+    while((ADC0_REGS->ADC_SYNCBUSY & ADC_SYNCBUSY_SWRST_Msk) == ADC_SYNCBUSY_SWRST_Msk)
+    {
+        /* Wait for Synchronization */
+    }
+
+    /* Write linearity calibration */
+    ADC0_REGS->ADC_CALIB = (uint16_t)(ADC_CALIB_BIASCOMP((calib & FUSES_SW0_WORD_0_ADC0_BIASCOMP_Msk) >> FUSES_SW0_WORD_0_ADC0_BIASCOMP_Pos) |
+                                      ADC_CALIB_BIASREFBUF((calib & FUSES_SW0_WORD_0_ADC0_BIASREFBUF_Msk) >> FUSES_SW0_WORD_0_ADC0_BIASREFBUF_Pos) |
+                                      ADC_CALIB_BIASR2R((calib & FUSES_SW0_WORD_0_ADC0_BIASR2R_Msk) >> FUSES_SW0_WORD_0_ADC0_BIASR2R_Pos));
+
+    /* Prescaler: GCLK1 60 MHz / 8 = 7.5 MHz */
+    ADC0_REGS->ADC_CTRLA = (uint16_t)ADC_CTRLA_PRESCALER_DIV8;
+    /* Sampling length */
+    ADC0_REGS->ADC_SAMPCTRL = (uint8_t)ADC_SAMPCTRL_SAMPLEN(63U);
+    /* Reference */
+    ADC0_REGS->ADC_REFCTRL = (uint8_t)ADC_REFCTRL_REFSEL_INTREF;
+    /* Input pin */
+    ADC0_REGS->ADC_INPUTCTRL = (uint16_t) ADC_POSINPUT_PTAT | (uint16_t) ADC_NEGINPUT_GND;
+    /* Resolution & Operation Mode */
+    ADC0_REGS->ADC_CTRLB = (uint16_t)(ADC_CTRLB_RESSEL_16BIT);
+    /* Averaging: 16 samples, result adjusted back to 12 bit */
+    ADC0_REGS->ADC_AVGCTRL = (uint8_t)(ADC_AVGCTRL_SAMPLENUM_16 | ADC_AVGCTRL_ADJRES(4U));
+    /* Clear all interrupt flags */
+    ADC0_REGS->ADC_INTFLAG = (uint8_t)ADC_INTFLAG_Msk;
+
+    while(0U != ADC0_REGS->ADC_SYNCBUSY)
+    {
+        /* Wait for Synchronization */
+    }
+}
+
+/* Enable ADC module */
+void ADC0_Enable( void )
+{
+    ADC0_REGS->ADC_CTRLA |= (uint16_t)ADC_CTRLA_ENABLE_Msk;
+    while(0U != ADC0_REGS->ADC_SYNCBUSY)
+    {
+        /* Wait for Synchronization */
+    }
+}
+
+/* Disable ADC module */
+void ADC0_Disable( void )
+{
+    ADC0_REGS->ADC_CTRLA &= (uint16_t)(~ADC_CTRLA_ENABLE_Msk);
+    while(0U != ADC0_REGS->ADC_SYNCBUSY)
+    {
+        /* Wait for Synchronization */
+    }
+}
+
+/* Configure channel input */
+void ADC0_ChannelSelect( ADC_POSINPUT positiveInput, ADC_NEGINPUT negativeInput )
+{
+    ADC0_REGS->ADC_INPUTCTRL = (ADC0_REGS->ADC_INPUTCTRL & (uint16_t)(~(ADC_INPUTCTRL_MUXPOS_Msk | ADC_INPUTCTRL_MUXNEG_Msk))) |
+                               (uint16_t) positiveInput | (uint16_t) negativeInput;
+
+    while((ADC0_REGS->ADC_SYNCBUSY & ADC_SYNCBUSY_INPUTCTRL_Msk) == ADC_SYNCBUSY_INPUTCTRL_Msk)
+    {
+        /* Wait for Synchronization */
+    }
+}
+
+/* Start the ADC conversion by SW */
+void ADC0_ConversionStart( void )
+{
+    ADC0_REGS->ADC_INTFLAG = (uint8_t)ADC_INTFLAG_RESRDY_Msk;
+    ADC0_REGS->ADC_SWTRIG = (uint8_t)ADC_SWTRIG_START_Msk;
+
+    while((ADC0_REGS->ADC_SYNCBUSY & ADC_SYNCBUSY_SWTRIG_Msk) == ADC_SYNCBUSY_SWTRIG_Msk)
+    {
+        /* Wait for Synchronization */
+    }
+}
+
+/* Read the conversion result */
+uint16_t ADC0_ConversionResultGet( void )
+{
+    return (uint16_t)ADC0_REGS->ADC_RESULT;
+}
+
+/* Check whether result is ready */
+bool ADC0_ConversionStatusGet( void )
+{
+    return ((ADC0_REGS->ADC_INTFLAG & ADC_INTFLAG_RESRDY_Msk) == ADC_INTFLAG_RESRDY_Msk);
+}
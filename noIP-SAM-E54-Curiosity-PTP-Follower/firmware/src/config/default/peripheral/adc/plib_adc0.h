@@ -0,0 +1,76 @@
+/*******************************************************************************
+  Analog-to-Digital Converter(ADC0) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_adc0.h
+
+  Summary
+    ADC0 PLIB Header File.
+
+  Description
+    This file defines the interface to the ADC peripheral library. This
+    library provides access to and control of the associated peripheral
+    instance.
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#ifndef PLIB_ADC0_H      // Guards against multiple inclusion
+#define PLIB_ADC0_H
+
+#include "device.h"
+#include "plib_adc_common.h"
+
+#ifdef __cplusplus // Provide C++ Compatibility
+ extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void ADC0_Initialize( void );
+
+void ADC0_Enable( void );
+
+void ADC0_Disable( void );
+
+void ADC0_ChannelSelect( ADC_POSINPUT positiveInput, ADC_NEGINPUT negativeInput );
+
+void ADC0_ConversionStart( void );
+
+uint16_t ADC0_ConversionResultGet( void );
+
+bool ADC0_ConversionStatusGet( void );
+
+#ifdef __cplusplus // Provide C++ Compatibility
+ }
+#endif
+
+#endif /* PLIB_ADC0_H */
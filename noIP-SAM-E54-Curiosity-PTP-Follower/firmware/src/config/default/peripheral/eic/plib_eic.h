@@ -97,6 +97,9 @@
 */
 
 
+    /* External Interrupt Controller Pin 7, event output only */
+#define    EIC_PIN_7    (7U)
+
     /* External Interrupt Controller Pin 14 */
 #define    EIC_PIN_14   (14U)
 
@@ -46,7 +46,11 @@
 
 void EVSYS_Initialize( void )
 {
+    /* Event Channel 0: EIC EXTINT7 (MAC-PHY 1PPS) -> TC4 capture channel 0 */
+    EVSYS_REGS->CHANNEL[0].EVSYS_CHANNEL = EVSYS_CHANNEL_EVGEN(0x19U) | EVSYS_CHANNEL_PATH(2U) | EVSYS_CHANNEL_EDGSEL(0U);
+
     /*Event Channel User Configuration*/
+    EVSYS_REGS->EVSYS_USER[48] = EVSYS_USER_CHANNEL(0x1U);
 
 }
 
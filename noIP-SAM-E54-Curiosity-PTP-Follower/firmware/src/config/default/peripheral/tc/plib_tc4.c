@@ -0,0 +1,166 @@
+/*******************************************************************************
+  Timer/Counter(TC4) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_tc4.c
+
+  Summary
+    TC4 PLIB Implementation File.
+
+  Description
+    This file defines the interface to the TC peripheral library. This
+    library provides access to and control of the associated peripheral
+    instance. TC4 runs as a free running 32-bit capture counter together
+    with TC5. Channel 0 captures on the event input, channel 1 on pin WO[1].
+*******************************************************************************/
+
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "interrupts.h"
+#include "plib_tc4.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data
+// *****************************************************************************
+// *****************************************************************************
+
+static TC_CAPTURE_CALLBACK_OBJ TC4_CallbackObject;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TC4 Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void TC4_CaptureInitialize( void )
+{
+    /* Reset TC */
+    TC4_REGS->COUNT32.TC_CTRLA = TC_CTRLA_SWRST_Msk;
+
+    while((TC4_REGS->COUNT32.TC_SYNCBUSY & TC_SYNCBUSY_SWRST_Msk) == TC_SYNCBUSY_SWRST_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+
+    /* Configure counter mode & prescaler: GCLK1 60 MHz / 1, free running.
+     * CC0 captures on the event input (EIC EXTINT7 via EVSYS channel 0) */
+    TC4_REGS->COUNT32.TC_CTRLA = TC_CTRLA_MODE_COUNT32 | TC_CTRLA_PRESCALER_DIV1 | TC_CTRLA_PRESCSYNC_PRESC |
+                                 TC_CTRLA_CAPTEN0_Msk;
+
+    /* Capture on the rising edge */
+    TC4_REGS->COUNT32.TC_DRVCTRL = 0U;
+
+    /* Event input for channel 0 */
+    TC4_REGS->COUNT32.TC_EVCTRL = (uint16_t)(TC_EVCTRL_TCEI_Msk | TC_EVCTRL_EVACT_OFF);
+
+    /* Clear all interrupt flags */
+    TC4_REGS->COUNT32.TC_INTFLAG = (uint8_t)TC_INTFLAG_Msk;
+
+    TC4_CallbackObject.callback = NULL;
+    /* Enable capture and error interrupts */
+    TC4_REGS->COUNT32.TC_INTENSET = (uint8_t)(TC_INTENSET_MC0_Msk | TC_INTENSET_ERR_Msk);
+
+    while((TC4_REGS->COUNT32.TC_SYNCBUSY) != 0U)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+void TC4_CaptureStart( void )
+{
+    TC4_REGS->COUNT32.TC_CTRLA |= TC_CTRLA_ENABLE_Msk;
+    while((TC4_REGS->COUNT32.TC_SYNCBUSY & TC_SYNCBUSY_ENABLE_Msk) == TC_SYNCBUSY_ENABLE_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+void TC4_CaptureStop( void )
+{
+    TC4_REGS->COUNT32.TC_CTRLA &= ~TC_CTRLA_ENABLE_Msk;
+    while((TC4_REGS->COUNT32.TC_SYNCBUSY & TC_SYNCBUSY_ENABLE_Msk) == TC_SYNCBUSY_ENABLE_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+}
+
+uint32_t TC4_CaptureFrequencyGet( void )
+{
+    return (uint32_t)(60000000UL);
+}
+
+uint32_t TC4_Capture32bitChannel0Get( void )
+{
+    return TC4_REGS->COUNT32.TC_CC[0];
+}
+
+uint32_t TC4_Capture32bitCounterGet( void )
+{
+    /* Write command to force COUNT register read synchronization */
+    TC4_REGS->COUNT32.TC_CTRLBSET |= (uint8_t)TC_CTRLBSET_CMD_READSYNC;
+
+    while((TC4_REGS->COUNT32.TC_SYNCBUSY & TC_SYNCBUSY_CTRLB_Msk) == TC_SYNCBUSY_CTRLB_Msk)
+    {
+        /* Wait for Write Synchronization */
+    }
+
+    while((TC4_REGS->COUNT32.TC_CTRLBSET & TC_CTRLBSET_CMD_Msk) != 0U)
+    {
+        /* Wait for CMD to become zero */
+    }
+
+    /* Read current count value */
+    return TC4_REGS->COUNT32.TC_COUNT;
+}
+
+void TC4_CaptureCallbackRegister( TC_CAPTURE_CALLBACK callback, uintptr_t context )
+{
+    TC4_CallbackObject.callback = callback;
+    TC4_CallbackObject.context = context;
+}
+
+void TC4_CaptureInterruptHandler( void )
+{
+    if (TC4_REGS->COUNT32.TC_INTENSET != 0U)
+    {
+        TC_CAPTURE_STATUS status;
+        status = (TC_CAPTURE_STATUS) TC4_REGS->COUNT32.TC_INTFLAG;
+        /* Clear interrupt flags, reading CCx in the callback clears MCx as well */
+        TC4_REGS->COUNT32.TC_INTFLAG = (uint8_t)TC_INTFLAG_Msk;
+        if((status != TC_CAPTURE_STATUS_NONE) && (TC4_CallbackObject.callback != NULL))
+        {
+            TC4_CallbackObject.callback(status, TC4_CallbackObject.context);
+        }
+    }
+}
@@ -31,7 +31,7 @@ double lowPassExponential(double input, double average, double factor)
   return input*factor + (1-factor)*average;  // ensure factor belongs to  [0,1]
 }
 
-const double fine_filter_coeff[FIR_FILER_SIZE_FINE] = {1.0, 1.0, 1.0};
+const double fine_filter_coeff[FIR_FILER_SIZE_FINE_MAX] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
 double firLowPassFilter(int32_t input, lpfState* state)
 {
   double ret = 0.0;
@@ -57,7 +57,7 @@ double firLowPassFilter(int32_t input, lpfState* state)
         temp = (double)state->buffer[last_pos] - (double)state->buffer[pos];
         if( (temp<((-1)*(CLOCK_CYCLE_NS-CLOCK_OFFsET_NS)) ) || (temp>(CLOCK_CYCLE_NS-CLOCK_OFFsET_NS)) )
         {
-            diffs += SGN(temp)*(CLOCK_CYCLE_NS/(FIR_FILER_SIZE_FINE-1));
+            diffs += SGN(temp)*(CLOCK_CYCLE_NS/(state->filterSize-1));
         }
     }
     last_pos = pos;
@@ -104,3 +104,20 @@ double firLowPassFilterF(double input, lpfStateF* state)
   return ret / state->filled;
 }
 
+void lpfResize(lpfState* state, uint32_t size)
+{
+  state->filterSize = size;
+  state->head = 0;
+  state->filled = 0;
+}
+
+void lpfResizeF(lpfStateF* state, uint32_t size, double value)
+{
+  state->filterSize = size;
+  state->head = 0;
+  state->filled = size;
+  for(uint32_t i = 0; i < size; i++)
+  {
+    state->buffer[i] = value;
+  }
+}
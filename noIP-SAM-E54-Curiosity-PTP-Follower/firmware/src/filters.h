@@ -37,8 +37,11 @@ extern "C" {
 #define CLOCK_CYCLE_NS      40.0
 #define CLOCK_OFFsET_NS     4.0
     
+/* Default lengths, servo_tune may change them at run time up to the maximum */
 #define FIR_FILER_SIZE 16
 #define FIR_FILER_SIZE_FINE 3
+#define FIR_FILER_SIZE_MAX 64
+#define FIR_FILER_SIZE_FINE_MAX 8
 
 typedef struct lpfState
 {
@@ -64,6 +67,12 @@ double firLowPassFilterF(double input, lpfStateF* state);
 
 double lowPassExponential(double input, double average, double factor);
 
+/* Changes the length of a filter, its buffer has to hold at least size values */
+void lpfResize(lpfState* state, uint32_t size);
+
+/* Changes the length of a filter and fills it with value */
+void lpfResizeF(lpfStateF* state, uint32_t size, double value);
+
 
 #ifdef	__cplusplus
 }
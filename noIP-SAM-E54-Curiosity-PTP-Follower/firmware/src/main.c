@@ -52,6 +52,14 @@ Microchip or any third party.
 #include "tc6.h"
 #include "tc6-noip.h"
 #include "ptp_task.h"
+#include "ptp_domain.h"
+#include "servo_tune.h"
+#include "temp_comp.h"
+#include "pps_phase.h"
+#include "ptp_clock.h"
+#include "ptp_sched.h"
+#include "pd_exchange.h"
+#include "media_clock.h"
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                          USER ADJUSTABLE                             */
@@ -74,6 +82,7 @@ Microchip or any third party.
 #define DELAY_BEACON_CHECK          (2000)
 #define DELAY_STAT_PRINT            (1000)
 #define DELAY_LED                   (333)
+#define SCHED_DEMO_PERIOD_NS        (1000000u)
 
 #define UDP_PAYLOAD_OFFSET          (42)
 
@@ -126,6 +135,7 @@ typedef struct
     bool lastBeaconState;
     bool txBusy;
     bool allowTxStress;
+    int8_t schedDemoSlot;
 } MainLocal_t;
 
 static MainLocal_t m;
@@ -337,6 +347,9 @@ static void PrintStat(void);
 static void SendIperfPacket(void);
 static void CheckButton(uint8_t instance, bool newLevel, bool *oldLevel);
 static void OnPlcaStatus(int8_t idx, bool success, bool plcaStatus);
+static void ToggleSchedDemo(void);
+static void ToggleTxGate(void);
+static void ToggleProcessData(void);
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                         PUBLIC FUNCTIONS                             */
@@ -367,16 +380,31 @@ int main(void)
     m.nextStat = DELAY_STAT_PRINT;
     m.nextBeaconCheck = DELAY_BEACON_CHECK;
     m.allowTxStress = false;
+    m.schedDemoSlot = -1;
 
     PrintMenu();
 
     ptpTask();
+    tempCompInit();
+    ppsPhaseInit();
+    ptpClockInit();
+    ptpSchedInit();
+    TC6NoIP_TxGateSetup(m.idxNoIp, PTP_GetTimeNow, PTP_TX_GATE_PRE_NS, PTP_TX_GATE_POST_NS);
+    TC6NoIP_TxGateEnable(m.idxNoIp, true);
     while (true) {
         uint32_t now;
         SYS_Tasks();
 
         TC6NoIP_Service();
         now = systick.tickCounter;
+        tempCompService(now);
+        ppsPhaseService(now);
+        ptpClockService(now);
+        ptpService(now);
+        /* Bulk data, the TX gate keeps it off the Sync arrivals */
+        SendIperfPacket();
+        pdService();
+        mcService(now);
         
         CheckUartInput();
 
@@ -419,6 +447,23 @@ static void PrintMenu(void)
     PRINT("%s s - clear statisitcs", MoveCursor(true));
     PRINT("%s i - toggle stress tx test", MoveCursor(true));
     PRINT("%s p - print offset information", MoveCursor(true));
+    PRINT("%s d - print gPTP domain status", MoveCursor(true));
+    PRINT("%s a - print servo tuning (Allan deviation)", MoveCursor(true));
+    PRINT("%s t - print temperature model", MoveCursor(true));
+    PRINT("%s g - print grandmaster / switchover status", MoveCursor(true));
+    PRINT("%s o - print PPS phase self-measurement", MoveCursor(true));
+    PRINT("%s e - toggle 1 Hz event generator output (DIOA0)", MoveCursor(true));
+    PRINT("%s x - print event captures (DIOA1)", MoveCursor(true));
+    PRINT("%s k - print local PTP clock (cycle counter)", MoveCursor(true));
+    PRINT("%s j - toggle 1 ms scheduled LED2 toggle", MoveCursor(true));
+    PRINT("%s h - print callback scheduler", MoveCursor(true));
+    PRINT("%s w - toggle TX gate, print gate on/off statistics", MoveCursor(true));
+    PRINT("%s y - toggle cyclic process data exchange", MoveCursor(true));
+    PRINT("%s u - print process data exchange", MoveCursor(true));
+    PRINT("%s b - run process data benchmark (simulated bus)", MoveCursor(true));
+    PRINT("%s v - toggle media clock talker (CRF stream)", MoveCursor(true));
+    PRINT("%s l - toggle media clock listener (output DIOA0, measure DIOA1)", MoveCursor(true));
+    PRINT("%s n - print media clock recovery", MoveCursor(true));
     PRINT("%s======================\r\n", MoveCursor(true));
 }
 
@@ -454,6 +499,74 @@ static void CheckUartInput(void)
             case 'p':
                 prr = !prr;
                 break;
+            case 'D':
+            case 'd':
+                ptpDomainPrintStatus();
+                break;
+            case 'A':
+            case 'a':
+                servoTunePrintStatus();
+                break;
+            case 'T':
+            case 't':
+                tempCompPrintStatus();
+                break;
+            case 'G':
+            case 'g':
+                ptpPrintGmStatus();
+                break;
+            case 'O':
+            case 'o':
+                ppsPhasePrintStatus();
+                break;
+            case 'E':
+            case 'e':
+                ptpEventOutputToggle();
+                break;
+            case 'X':
+            case 'x':
+                ptpEventCapturePrint();
+                break;
+            case 'K':
+            case 'k':
+                ptpClockPrintStatus();
+                break;
+            case 'J':
+            case 'j':
+                ToggleSchedDemo();
+                break;
+            case 'H':
+            case 'h':
+                ptpSchedPrintStatus();
+                break;
+            case 'W':
+            case 'w':
+                ToggleTxGate();
+                break;
+            case 'Y':
+            case 'y':
+                ToggleProcessData();
+                break;
+            case 'U':
+            case 'u':
+                pdPrintStatus();
+                break;
+            case 'B':
+            case 'b':
+                pdBenchmark();
+                break;
+            case 'V':
+            case 'v':
+                mcTalkerToggle();
+                break;
+            case 'L':
+            case 'l':
+                mcListenerToggle();
+                break;
+            case 'N':
+            case 'n':
+                mcPrintStatus();
+                break;
             default:
                 PRINT("%sUnknown key='%c'(0x%X)\r\n", MoveCursor(true), m_rx, m_rx);
                 break;
@@ -503,7 +616,7 @@ static void SendIperfPacket(void)
         iperf[i++] = (m.iperfTx >> 8) & 0xFF;
         iperf[i++] = (m.iperfTx) & 0xFF;
         m.txBusy = true;
-        if (TC6NoIP_SendEthernetPacket(m.idxNoIp, iperf, len, OnSendIperf)) {
+        if (TC6NoIP_SendBulkEthernetPacket(m.idxNoIp, iperf, len, OnSendIperf)) {
             m.iperfTx++;
             m.stats[BOARD_INSTANCE].packetCntCurrent++;
             m.stats[BOARD_INSTANCE].packetCntTotal++;
@@ -573,4 +686,66 @@ void TC6NoIP_CB_OnEthernetReceive(int8_t idx, const uint8_t *pRx, uint16_t len)
             m.stats[idx].packetCntTotal++;
         }
     }
-}
\ No newline at end of file
+}
+
+static void OnSchedDemo(uint64_t targetNs, uint64_t nowNs, void *pTag)
+{
+    (void)targetNs;
+    (void)nowNs;
+    (void)pTag;
+    GPIO_USER_LED_2_Toggle();
+}
+
+static void ToggleSchedDemo(void)
+{
+    uint64_t now;
+    if (m.schedDemoSlot >= 0) {
+        ptpSchedRemove(m.schedDemoSlot);
+        m.schedDemoSlot = -1;
+        PRINT("%sScheduled LED2 toggle stopped\r\n", MoveCursor(true));
+        return;
+    }
+    now = PTP_GetTimeNow();
+    if (0u == now) {
+        PRINT(ESC_RED "%sLocal PTP clock not aligned yet" ESC_RESETCOLOR "\r\n", MoveCursor(true));
+        return;
+    }
+    /* First full millisecond at least 10 ms ahead, so every node toggles on the same edge */
+    now = ((now / SCHED_DEMO_PERIOD_NS) + 10u) * SCHED_DEMO_PERIOD_NS;
+    m.schedDemoSlot = ptpSchedAdd(now, SCHED_DEMO_PERIOD_NS, OnSchedDemo, NULL);
+    PRINT("%sScheduled LED2 toggle %s\r\n", MoveCursor(true), (m.schedDemoSlot >= 0) ? "started" : "failed, no free slot");
+}
+
+static void ToggleTxGate(void)
+{
+    TC6NoIP_TxGateStats_t st;
+    uint8_t on;
+    for (on = 0; on < 2u; on++) {
+        if (TC6NoIP_GetTxGateStats(m.idxNoIp, (0u != on), &st) && (st.ms > 0u)) {
+            PRINT("%sTX gate %s: bulk %lu kbit/s (%lu frames, held off %lu, no time %lu), FollowUp after Sync avg=%lu max=%lu us (%lu)\r\n",
+                  MoveCursor(true), on ? "on " : "off", (uint32_t)(((uint64_t)st.bulkBytes * 8u) / st.ms),
+                  st.bulkFrames, st.heldOff, st.noTime,
+                  (st.ptpFrames > 0u) ? (uint32_t)(st.ptpLatencySumNs / st.ptpFrames / 1000u) : 0u,
+                  st.ptpLatencyMaxNs / 1000u, st.ptpFrames);
+        }
+    }
+    TC6NoIP_TxGateEnable(m.idxNoIp, !TC6NoIP_TxGateIsEnabled(m.idxNoIp));
+    PRINT("%sTX gate is %s\r\n", MoveCursor(true), TC6NoIP_TxGateIsEnabled(m.idxNoIp) ? "on" : "off");
+}
+
+static void ToggleProcessData(void)
+{
+    uint8_t data[PD_DATA_LEN] = { 0 };
+    if (pdIsRunning()) {
+        pdStop();
+        PRINT("%sProcess data exchange stopped\r\n", MoveCursor(true));
+        return;
+    }
+    data[0] = T1S_PLCA_NODE_ID;
+    pdSetTxData(data, sizeof(data));
+    if (pdStart(T1S_PLCA_NODE_ID, T1S_PLCA_NODE_COUNT, PD_CYCLE_NS, PD_SLOT_NS)) {
+        PRINT("%sProcess data exchange started, node %u of %u\r\n", MoveCursor(true), T1S_PLCA_NODE_ID, T1S_PLCA_NODE_COUNT);
+    } else {
+        PRINT(ESC_RED "%sProcess data exchange not started, local PTP clock not aligned or no free slot" ESC_RESETCOLOR "\r\n", MoveCursor(true));
+    }
+}
@@ -0,0 +1,540 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Media clock recovery
+
+  File Name:
+    media_clock.c
+
+  Summary:
+    Recovers an audio sample clock from presentation timestamps on gPTP time
+
+  Description:
+    Timestamps are numbered from the first received frame on, the CRF
+    sequence number advances the count by the timestamps per frame, so lost
+    frames do not shift the sample count. The loop runs on the timestamp
+    index n:
+      t(n) = anchor + phase + period * (n - nPhase)
+    The recovered rate against gPTP is the nominal over the tracked period.
+
+    Edge time errors are matched to the received timestamps, which are kept
+    in a ring for the presentation offset plus the capture read-out.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "definitions.h"
+#include "media_clock.h"
+#include "ptp_clock.h"
+#include "ptp_task.h"
+#include "tc6.h"
+#include "tc6-events.h"
+#include "tc6-noip.h"
+
+#define PTP_LOG printf
+
+#define MC_NOMINAL_PERIOD_NS    (1e9 * (double)MC_TS_INTERVAL / (double)MC_SAMPLE_RATE_HZ)
+#define MC_ETH_HEADER_LEN       14u
+#define MC_CRF_HEADER_LEN       20u
+#define MC_CRF_SUBTYPE          0x04u
+#define MC_CRF_SV_VERSION       0x80u   /* stream id valid, version 0 */
+#define MC_CRF_TYPE_AUDIO       0x01u
+#define MC_CRF_BASE_FREQ_MASK   0x1FFFFFFFu
+#define MC_FRAME_LEN            (MC_ETH_HEADER_LEN + MC_CRF_HEADER_LEN + (8u * MC_TS_PER_FRAME))
+#define MC_TS_RING              64u
+#define MC_WANDER_ALPHA         (6.2832 * (double)MC_WANDER_CORNER_HZ * (double)MC_TS_INTERVAL / (double)MC_SAMPLE_RATE_HZ)
+/* Minimum distance between two armings, the register writes must go through first */
+#define MC_REARM_HOLD_MS        (MC_REARM_LEAD_TS + 5u)
+
+typedef struct
+{
+  bool active;
+  volatile bool busy;
+  uint64_t anchorNs;
+  double periodNs;
+  uint32_t nextIdx;
+  uint8_t seq;
+  uint32_t frames;
+  uint32_t failed;
+  uint8_t frame[MC_FRAME_LEN];
+} mcTalker_t;
+
+typedef struct
+{
+  bool active;
+  uint8_t streamId[8];
+  bool haveStream;
+  uint8_t lastSeq;
+  uint32_t baseIdx;         /* index of the first timestamp of the last frame */
+  uint32_t frames;
+  uint32_t seqGaps;
+  uint32_t dropped;         /* other streams or wrong format */
+  /* Recovery loop */
+  uint32_t tracked;
+  uint64_t anchorNs;
+  double phaseNs;
+  double periodNs;
+  uint32_t phaseIdx;
+  double errMaxNs;
+  uint32_t reseeds;
+  /* Received timestamps for the edge measurement */
+  uint64_t ringNs[MC_TS_RING];
+  uint8_t ringIn;
+  uint8_t ringFill;
+  /* Output */
+  bool armed;
+  uint64_t egStartNs;
+  uint32_t egIdx;
+  uint32_t egIntervalNs;
+  uint32_t rearms;
+  uint32_t armFailed;
+  uint32_t lastArmMs;
+} mcListener_t;
+
+typedef struct
+{
+  uint32_t edges;
+  uint32_t unmatched;
+  int64_t sumNs;
+  double lowPassNs;
+  double jitterSqSum;
+  double jitterMinNs;
+  double jitterMaxNs;
+  double wanderMinNs;
+  double wanderMaxNs;
+  uint64_t windowStartNs;
+  double windowMinNs;
+  double windowMaxNs;
+  double mtieNs;
+} mcMeasure_t;
+
+static const uint8_t MC_DEST_MAC[6] = {0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu};
+
+static mcTalker_t tx;
+static mcListener_t rx;
+static mcMeasure_t meas;
+
+static void wr32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static uint32_t rd32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                              TALKER                                  */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static uint64_t talkerTs(uint32_t n)
+{
+  return tx.anchorNs + (uint64_t)llround((double)n * tx.periodNs);
+}
+
+static void onTalkerSent(void *pDummy, const uint8_t *pTx, uint16_t len, uint32_t idx, void *pDummy2)
+{
+  tx.busy = false;
+}
+
+static void talkerSend(void)
+{
+  uint8_t* p = &tx.frame[MC_ETH_HEADER_LEN];
+  uint8_t i;
+
+  if(tx.busy)
+  {
+    return;
+  }
+  p[2] = tx.seq;
+  for(i = 0; i < MC_TS_PER_FRAME; i++)
+  {
+    uint64_t ts = talkerTs(tx.nextIdx + i);
+    wr32(&p[MC_CRF_HEADER_LEN + (8u * i)], (uint32_t)(ts >> 32));
+    wr32(&p[MC_CRF_HEADER_LEN + (8u * i) + 4u], (uint32_t)ts);
+  }
+  tx.busy = true;
+  if(TC6NoIP_SendEthernetPacket(0, tx.frame, MC_FRAME_LEN, onTalkerSent))
+  {
+    tx.frames++;
+  }
+  else
+  {
+    tx.busy = false;
+    tx.failed++;
+  }
+  /* A frame the driver did not take is lost like on the wire, the listener counts the gap */
+  tx.seq++;
+  tx.nextIdx += MC_TS_PER_FRAME;
+}
+
+bool mcTalkerToggle(void)
+{
+  uint64_t now = PTP_GetTimeNow();
+  uint8_t* p = &tx.frame[MC_ETH_HEADER_LEN];
+
+  if(tx.active)
+  {
+    tx.active = false;
+    PTP_LOG("Media clock talker stopped after %lu frames\r\n", tx.frames);
+    return true;
+  }
+  if(0u == now)
+  {
+    PTP_LOG("Media clock talker not started, local PTP clock not aligned\r\n");
+    return false;
+  }
+  memset(&tx, 0, sizeof(tx));
+  memcpy(&tx.frame[0], MC_DEST_MAC, 6);
+  TC6NoIP_GetMacAddress(0, &tx.frame[6]);
+  tx.frame[12] = (uint8_t)(MC_ETH_TYPE >> 8);
+  tx.frame[13] = (uint8_t)MC_ETH_TYPE;
+  p[0] = MC_CRF_SUBTYPE;
+  p[1] = MC_CRF_SV_VERSION;
+  p[3] = MC_CRF_TYPE_AUDIO;
+  memcpy(&p[4], &tx.frame[6], 6);         /* stream id: MAC and unique id 1 */
+  p[10] = 0u;
+  p[11] = 1u;
+  wr32(&p[12], MC_SAMPLE_RATE_HZ);        /* pull 0, multiply by 1.0 */
+  p[16] = 0u;
+  p[17] = (uint8_t)(8u * MC_TS_PER_FRAME);
+  p[18] = 0u;
+  p[19] = MC_TS_INTERVAL;
+
+  /* A faster audio clock gives shorter timestamp periods */
+  tx.periodNs = MC_NOMINAL_PERIOD_NS / (1.0 + (MC_TALKER_PPM * 1e-6));
+  tx.anchorNs = ((now / SEC_IN_NS) + 1u) * SEC_IN_NS + MC_PRESENTATION_NS;
+  tx.active = true;
+  PTP_LOG("Media clock talker started, %u Hz at %+.1f ppm, first sample at %llu s\r\n",
+          MC_SAMPLE_RATE_HZ, MC_TALKER_PPM, (now / SEC_IN_NS) + 1u);
+  return true;
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                             LISTENER                                 */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/* Recovered presentation time of timestamp n */
+static uint64_t recoveredTs(uint32_t n)
+{
+  int32_t dn = (int32_t)(n - rx.phaseIdx);
+  return rx.anchorNs + (uint64_t)llround(rx.phaseNs + (rx.periodNs * (double)dn));
+}
+
+static void trackTimestamp(uint32_t n, uint64_t tsNs)
+{
+  int32_t dn;
+  double pred;
+  double err;
+
+  dn = (int32_t)(n - rx.phaseIdx);
+  if((0u == rx.tracked) || (dn <= 0) || (dn > (int32_t)MC_LOCK_TS))
+  {
+    rx.anchorNs = tsNs;
+    rx.phaseNs = 0.0;
+    rx.phaseIdx = n;
+    if(0u == rx.tracked)
+    {
+      rx.periodNs = MC_NOMINAL_PERIOD_NS;
+    }
+    rx.tracked = 1u;
+    return;
+  }
+  pred = rx.phaseNs + (rx.periodNs * (double)dn);
+  err = (double)(int64_t)(tsNs - rx.anchorNs) - pred;
+  if(fabs(err) > MC_RESEED_NS)
+  {
+    rx.reseeds++;
+    rx.tracked = 0u;
+    rx.armed = false;
+    trackTimestamp(n, tsNs);
+    return;
+  }
+  rx.phaseNs = pred + (MC_ALPHA * err);
+  rx.periodNs += (MC_BETA * err) / (double)dn;
+  rx.phaseIdx = n;
+  rx.tracked++;
+  if((rx.tracked > MC_LOCK_TS) && (fabs(err) > rx.errMaxNs))
+  {
+    rx.errMaxNs = fabs(err);
+  }
+}
+
+void mcHandleFrame(const uint8_t* pFrame, uint16_t len)
+{
+  const uint8_t* p = &pFrame[MC_ETH_HEADER_LEN];
+  uint16_t dataLen;
+  uint8_t count;
+  uint8_t i;
+
+  if(!rx.active)
+  {
+    return;
+  }
+  if((len < (MC_ETH_HEADER_LEN + MC_CRF_HEADER_LEN)) || (MC_CRF_SUBTYPE != p[0]) || (MC_CRF_TYPE_AUDIO != p[3]) ||
+     ((rd32(&p[12]) & MC_CRF_BASE_FREQ_MASK) != MC_SAMPLE_RATE_HZ) || (MC_TS_INTERVAL != (((uint16_t)p[18] << 8) | p[19])))
+  {
+    rx.dropped++;
+    return;
+  }
+  dataLen = ((uint16_t)p[16] << 8) | p[17];
+  count = (uint8_t)(dataLen / 8u);
+  if((0u == count) || (count > MC_TS_PER_FRAME) || (len < (MC_ETH_HEADER_LEN + MC_CRF_HEADER_LEN + dataLen)))
+  {
+    rx.dropped++;
+    return;
+  }
+  if(!rx.haveStream)
+  {
+    memcpy(rx.streamId, &p[4], 8);
+    rx.haveStream = true;
+    rx.lastSeq = (uint8_t)(p[2] - 1u);
+    rx.baseIdx = 0u - count;
+  }
+  else if(0 != memcmp(rx.streamId, &p[4], 8))
+  {
+    rx.dropped++;
+    return;
+  }
+  else if(p[2] == rx.lastSeq)
+  {
+    return;
+  }
+  if((uint8_t)(p[2] - rx.lastSeq) > 1u)
+  {
+    rx.seqGaps += (uint8_t)(p[2] - rx.lastSeq) - 1u;
+  }
+  rx.baseIdx += (uint32_t)(uint8_t)(p[2] - rx.lastSeq) * count;
+  rx.lastSeq = p[2];
+  rx.frames++;
+
+  for(i = 0; i < count; i++)
+  {
+    const uint8_t* pTs = &p[MC_CRF_HEADER_LEN + (8u * i)];
+    uint64_t ts = ((uint64_t)rd32(pTs) << 32) | rd32(&pTs[4]);
+    rx.ringNs[rx.ringIn] = ts;
+    rx.ringIn = (uint8_t)((rx.ringIn + 1u) % MC_TS_RING);
+    if(rx.ringFill < MC_TS_RING) rx.ringFill++;
+    trackTimestamp(rx.baseIdx + i, ts);
+  }
+}
+
+static void onOutputPulse(TC6_t *pInst, uint8_t eg, bool success, void *pTag)
+{
+  if(!success)
+  {
+    rx.armed = false;
+  }
+}
+
+/* Every edge of the output is compared to the presentation time it stands for */
+static void onCapture(TC6_t *pInst, uint8_t input, uint64_t timestampNs, void *pTag)
+{
+  const int64_t half = (int64_t)(MC_NOMINAL_PERIOD_NS / 2.0);
+  double te;
+  double hp;
+  uint8_t i;
+  bool found = false;
+
+  if(!rx.active || !rx.armed)
+  {
+    return;
+  }
+  for(i = 0; (i < rx.ringFill) && !found; i++)
+  {
+    int64_t d = (int64_t)(timestampNs - rx.ringNs[(rx.ringIn + MC_TS_RING - 1u - i) % MC_TS_RING]);
+    if((d > -half) && (d < half))
+    {
+      te = (double)d;
+      found = true;
+    }
+  }
+  if(!found)
+  {
+    meas.unmatched++;
+    return;
+  }
+  if(0u == meas.edges)
+  {
+    meas.lowPassNs = te;
+    meas.jitterMinNs = meas.jitterMaxNs = 0.0;
+    meas.wanderMinNs = meas.wanderMaxNs = te;
+    meas.windowStartNs = timestampNs;
+    meas.windowMinNs = meas.windowMaxNs = te;
+  }
+  meas.edges++;
+  meas.sumNs += (int64_t)te;
+  meas.lowPassNs += MC_WANDER_ALPHA * (te - meas.lowPassNs);
+  hp = te - meas.lowPassNs;
+  meas.jitterSqSum += hp * hp;
+  if(hp < meas.jitterMinNs) meas.jitterMinNs = hp;
+  if(hp > meas.jitterMaxNs) meas.jitterMaxNs = hp;
+  if(meas.lowPassNs < meas.wanderMinNs) meas.wanderMinNs = meas.lowPassNs;
+  if(meas.lowPassNs > meas.wanderMaxNs) meas.wanderMaxNs = meas.lowPassNs;
+
+  if(meas.lowPassNs < meas.windowMinNs) meas.windowMinNs = meas.lowPassNs;
+  if(meas.lowPassNs > meas.windowMaxNs) meas.windowMaxNs = meas.lowPassNs;
+  if((timestampNs - meas.windowStartNs) >= ((uint64_t)MC_MTIE_WINDOW_MS * 1000000u))
+  {
+    if((meas.windowMaxNs - meas.windowMinNs) > meas.mtieNs)
+    {
+      meas.mtieNs = meas.windowMaxNs - meas.windowMinNs;
+    }
+    meas.windowStartNs = timestampNs;
+    meas.windowMinNs = meas.windowMaxNs = meas.lowPassNs;
+  }
+}
+
+/* (Re-)arms EG0 when it runs off the recovered clock */
+static void serviceOutput(uint32_t nowMs)
+{
+  TC6_t* pInst = get_macPhy_inst();
+  TC6Events_EgState_t state;
+  uint32_t n = rx.phaseIdx;
+  uint32_t interval;
+  uint64_t start;
+
+  if((rx.tracked < MC_LOCK_TS) || ((nowMs - rx.lastArmMs) < MC_REARM_HOLD_MS))
+  {
+    return;
+  }
+  state = TC6Events_GetEgState(pInst, PTP_EVENT_OUTPUT_EG, NULL);
+  if(rx.armed && (state != TC6Events_EgState_Failed) && (state != TC6Events_EgState_Idle))
+  {
+    int64_t egEdge = (int64_t)rx.egStartNs + ((int64_t)(int32_t)(n - rx.egIdx) * rx.egIntervalNs);
+    int64_t dev = egEdge - (int64_t)recoveredTs(n);
+    if((dev >= -MC_REARM_NS) && (dev <= MC_REARM_NS))
+    {
+      return;
+    }
+  }
+  n += MC_REARM_LEAD_TS;
+  start = recoveredTs(n);
+  interval = (uint32_t)llround(rx.periodNs);
+  rx.lastArmMs = nowMs;
+  if(TC6Events_EgPeriodic(pInst, PTP_EVENT_OUTPUT_EG, start / SEC_IN_NS, (uint32_t)(start % SEC_IN_NS), MC_OUTPUT_WIDTH_NS,
+                          interval, true, onOutputPulse, NULL))
+  {
+    rx.armed = true;
+    rx.egStartNs = start;
+    rx.egIdx = n;
+    rx.egIntervalNs = interval;
+    rx.rearms++;
+  }
+  else
+  {
+    rx.armFailed++;
+  }
+}
+
+bool mcListenerToggle(void)
+{
+  TC6_t* pInst = get_macPhy_inst();
+
+  if(rx.active)
+  {
+    rx.active = false;
+    (void)TC6Events_EgStop(pInst, PTP_EVENT_OUTPUT_EG);
+    /* Back to the capture ring of the 'x' print */
+    (void)TC6Events_CaptureEnable(pInst, PTP_EVENT_CAPTURE_INPUT, TC6Events_Edge_Rising, NULL, NULL);
+    PTP_LOG("Media clock listener stopped\r\n");
+    return true;
+  }
+  memset(&rx, 0, sizeof(rx));
+  memset(&meas, 0, sizeof(meas));
+  if(!TC6Events_CaptureEnable(pInst, PTP_EVENT_CAPTURE_INPUT, TC6Events_Edge_Rising, onCapture, NULL))
+  {
+    PTP_LOG("Media clock listener not started, capture input busy\r\n");
+    return false;
+  }
+  rx.active = true;
+  PTP_LOG("Media clock listener started, output on DIOA0 (EG%u), wire it to DIOA1 for the measurement\r\n",
+          PTP_EVENT_OUTPUT_EG);
+  return true;
+}
+
+void mcService(uint32_t nowMs)
+{
+  if(tx.active)
+  {
+    uint64_t now = PTP_GetTimeNow();
+    /* The frame leaves once its last sample was taken */
+    if((0u != now) && ((now + MC_PRESENTATION_NS) >= talkerTs(tx.nextIdx + MC_TS_PER_FRAME - 1u)))
+    {
+      talkerSend();
+    }
+  }
+  if(rx.active)
+  {
+    serviceOutput(nowMs);
+  }
+}
+
+void mcPrintStatus(void)
+{
+  if(tx.active)
+  {
+    PTP_LOG("Media clock talker: %lu frames, %lu failed, %+.1f ppm against gPTP\r\n", tx.frames, tx.failed, MC_TALKER_PPM);
+  }
+  if(!rx.active)
+  {
+    if(!tx.active)
+    {
+      PTP_LOG("Media clock talker and listener stopped\r\n");
+    }
+    return;
+  }
+  PTP_LOG("Media clock listener: %lu frames, %lu sequence gaps, %lu dropped, %lu timestamps, %lu reseeds\r\n",
+          rx.frames, rx.seqGaps, rx.dropped, rx.tracked, rx.reseeds);
+  if(rx.tracked >= MC_LOCK_TS)
+  {
+    PTP_LOG("  recovered %+.3f ppm against gPTP, loop error max %.0f ns\r\n",
+            ((MC_NOMINAL_PERIOD_NS / rx.periodNs) - 1.0) * 1e6, rx.errMaxNs);
+  }
+  else
+  {
+    PTP_LOG("  not locked\r\n");
+  }
+  PTP_LOG("  output %s, interval %lu ns, %lu armings, %lu failed\r\n", rx.armed ? "running" : "stopped",
+          rx.egIntervalNs, rx.rearms, rx.armFailed);
+  if(meas.edges > 0u)
+  {
+    PTP_LOG("  time error against the GM: %lu edges (%lu unmatched), mean %ld ns\r\n", meas.edges, meas.unmatched,
+            (int32_t)(meas.sumNs / (int64_t)meas.edges));
+    PTP_LOG("  jitter (>%u Hz): rms %.1f ns, pk-pk %.0f ns; wander: pk-pk %.0f ns, MTIE(%lu ms) %.0f ns\r\n",
+            MC_WANDER_CORNER_HZ, sqrt(meas.jitterSqSum / (double)meas.edges), meas.jitterMaxNs - meas.jitterMinNs,
+            meas.wanderMaxNs - meas.wanderMinNs, MC_MTIE_WINDOW_MS, meas.mtieNs);
+  }
+  else if(rx.armed)
+  {
+    PTP_LOG("  no output edges captured, DIOA0 not wired to DIOA1?\r\n");
+  }
+}
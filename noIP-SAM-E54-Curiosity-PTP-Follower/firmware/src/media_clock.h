@@ -0,0 +1,110 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Media clock recovery
+
+  File Name:
+    media_clock.h
+
+  Summary:
+    Recovers an audio sample clock from presentation timestamps on gPTP time
+
+  Description:
+    A talker publishes a clock reference stream (IEEE 1722 CRF, audio sample
+    timestamps): one presentation time per MC_TS_INTERVAL samples of a
+    MC_SAMPLE_RATE_HZ media clock, MC_TS_PER_FRAME timestamps per frame. The
+    talker emulates an audio clock running MC_TALKER_PPM off gPTP.
+
+    A listener tracks the timestamps with an alpha-beta loop on phase and
+    timestamp period. Once locked, EG0 (DIOA0) outputs the recovered clock
+    divided by MC_TS_INTERVAL, every rising edge on a recovered presentation
+    time. The generator interval has 1 ns resolution, so the train is re-armed
+    whenever it ran MC_REARM_NS off the recovered clock.
+
+    With DIOA0 wired to DIOA1 every output edge is captured on the PTP time
+    and compared to the presentation time from the talker, which is on the GM
+    time: this time error is split into jitter (above MC_WANDER_CORNER_HZ)
+    and wander (below), the wander also as MTIE over MC_MTIE_WINDOW_MS.
+
+    The LAN865x ACMA and packet matcher set up in tc6-regs are timed TX and a
+    receive match pulse, there is no media clock unit in the MAC-PHY; the
+    recovery runs on the MCU and the event generator is its output stage.
+*******************************************************************************/
+
+#ifndef MEDIA_CLOCK_H
+#define	MEDIA_CLOCK_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* AVTP EtherType, the frames carry a CRF PDU */
+#define MC_ETH_TYPE                     0x22F0u
+#define MC_SAMPLE_RATE_HZ               48000u
+/* Samples per presentation timestamp, gives a 1 kHz output */
+#define MC_TS_INTERVAL                  48u
+#define MC_TS_PER_FRAME                 6u
+/* Presentation time ahead of the sample, covers PLCA access and reception */
+#define MC_PRESENTATION_NS              2000000u
+/* Audio clock of the emulated talker against gPTP */
+#define MC_TALKER_PPM                   25.0
+/* Recovery loop, critically damped for ALPHA */
+#define MC_ALPHA                        0.0625
+#define MC_BETA                         0.002
+/* A timestamp further off the loop restarts it */
+#define MC_RESEED_NS                    20000
+/* Timestamps tracked before the output is started */
+#define MC_LOCK_TS                      500u
+/* Output re-armed when it runs this far off the recovered clock */
+#define MC_REARM_NS                     100
+/* First edge of a re-armed train, in timestamps ahead */
+#define MC_REARM_LEAD_TS                20u
+#define MC_OUTPUT_WIDTH_NS              100000u
+/* Jitter / wander split of the measured time error */
+#define MC_WANDER_CORNER_HZ             10u
+#define MC_MTIE_WINDOW_MS               1000u
+
+/* Starts or stops publishing the clock reference stream */
+bool mcTalkerToggle(void);
+
+/* Starts or stops the recovery, the output on EG0 and the time error measurement on DIOA1 */
+bool mcListenerToggle(void);
+
+/* Sends due frames and re-arms the output, to be called from the main loop */
+void mcService(uint32_t nowMs);
+
+/* A frame with MC_ETH_TYPE was received */
+void mcHandleFrame(const uint8_t* pFrame, uint16_t len);
+
+void mcPrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MEDIA_CLOCK_H */
@@ -0,0 +1,586 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Cyclic process-data exchange
+
+  File Name:
+    pd_exchange.c
+
+  Summary:
+    Time-triggered publish/consume of small process-data frames over PLCA
+
+  Description:
+    The scheduler callback only records the due publish time, the frame is
+    built and handed to the MAC-PHY by pdService() in the main loop, as the
+    TC6 driver must not be entered from an interrupt. The publish time goes
+    into the frame, so the consumers measure the whole path including this
+    hand-over.
+
+    Every node keeps a receive mask over the last 32 cycles, one bit per
+    cycle. Cycles are checked PD_CHECK_DELAY_CYCLES after they started, a
+    missing bit counts the frame as missing. Nodes are only checked once a
+    first frame was seen from them.
+
+    Frame after the Ethernet header (padded to the minimum frame size):
+      [0]      publisher node id
+      [1]      PD_FRAME_VERSION
+      [2..5]   cycle number, big endian
+      [6..13]  publish time in ns, big endian
+      [14..]   PD_DATA_LEN bytes process data
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "definitions.h"
+#include "pd_exchange.h"
+#include "ptp_sched.h"
+#include "ptp_clock.h"
+#include "ptp_task.h"
+#include "tc6-noip.h"
+
+#define PTP_LOG printf
+
+#define PD_FRAME_VERSION        1u
+#define PD_ETH_HEADER_LEN       14u
+#define PD_PAYLOAD_LEN          (14u + PD_DATA_LEN)
+#define PD_FRAME_LEN            60u
+#define PD_RX_WINDOW            32u
+
+/* Simulated bus: 10 Mbit/s, PLCA with PD_MAX_NODES transmit opportunities */
+#define PD_BENCH_BIT_NS         100u
+#define PD_BENCH_BEACON_NS      (20u * PD_BENCH_BIT_NS)
+#define PD_BENCH_TO_NS          (32u * PD_BENCH_BIT_NS)
+/* Preamble/SFD, FCS and inter packet gap around each frame */
+#define PD_BENCH_OVERHEAD       (8u + 4u + 12u)
+/* Publish time to first bit: main loop hand-over and SPI, plus its spread */
+#define PD_BENCH_DISPATCH_NS    150000u
+#define PD_BENCH_JITTER_NS      100000u
+/* Last bit to pdHandleFrame() */
+#define PD_BENCH_RX_NS          100000u
+/* Sync/FollowUp of the GM on node 0 while locking (2^-4 s) */
+#define PD_BENCH_SYNC_NS        62500000u
+#define PD_BENCH_FOLLOWUP_NS    500000u
+#define PD_BENCH_PTP_LEN        90u
+#define PD_BENCH_FIFO           4u
+#define PD_BENCH_CYCLE_MIN_NS   100000u
+#define PD_BENCH_CYCLE_STEP_NS  50000u
+#define PD_BENCH_CYCLE_MAX_NS   (2u * PD_CYCLE_NS)
+/* Consecutive clean steps before a cycle time counts, the jitter is random */
+#define PD_BENCH_CLEAN_STEPS    4u
+
+_Static_assert((PD_ETH_HEADER_LEN + PD_PAYLOAD_LEN) <= PD_FRAME_LEN, "process data exceeds the minimum frame");
+
+typedef struct
+{
+  pdNodeStats_t stats;
+  uint8_t data[PD_DATA_LEN];
+  uint32_t rxMask;        /* bit (cycle % PD_RX_WINDOW) per received cycle */
+  uint32_t checkCycle;    /* next cycle to check */
+  bool seen;
+  bool dataValid;
+} pdNode_t;
+
+/* Broadcast, the MAC-PHYs run without multicast hash filter */
+static const uint8_t PD_DEST_MAC[6] = {0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu};
+
+static pdNode_t nodes[PD_MAX_NODES];
+static uint8_t txFrame[PD_FRAME_LEN];
+static uint8_t txData[PD_DATA_LEN];
+static uint32_t cycleNs = PD_CYCLE_NS;
+static uint32_t slotNs = PD_SLOT_NS;
+static uint8_t ownId = 0;
+static uint8_t nodeCnt = 0;
+static int8_t schedSlot = -1;
+static bool running = false;
+
+/* Handed over by the scheduler interrupt */
+static volatile uint64_t dueTarget = 0;
+static volatile uint32_t dueSeq = 0;
+static uint32_t doneSeq = 0;
+
+static volatile bool txBusy = false;
+static uint32_t txFrames = 0;
+static uint32_t txSkipped = 0;     /* previous frame still with the driver, or not handed over in time */
+static uint32_t txFailed = 0;
+static uint32_t txDispatchMaxNs = 0;
+static uint32_t currentCycle = 0;
+
+static void wr32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static uint32_t rd32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void onCycle(uint64_t targetNs, uint64_t nowNs, void* pTag)
+{
+  (void)nowNs;
+  (void)pTag;
+  dueTarget = targetNs;
+  dueSeq++;
+}
+
+static void onSent(void *pDummy, const uint8_t *pTx, uint16_t len, uint32_t idx, void *pDummy2)
+{
+  txBusy = false;
+}
+
+static void sendFrame(uint64_t target, uint32_t cycle)
+{
+  uint8_t* p = &txFrame[PD_ETH_HEADER_LEN];
+  uint64_t now;
+
+  if(txBusy)
+  {
+    txSkipped++;
+    return;
+  }
+  p[0] = ownId;
+  p[1] = PD_FRAME_VERSION;
+  wr32(&p[2], cycle);
+  wr32(&p[6], (uint32_t)(target >> 32));
+  wr32(&p[10], (uint32_t)target);
+  memcpy(&p[14], txData, PD_DATA_LEN);
+
+  txBusy = true;
+  if(!TC6NoIP_SendEthernetPacket(0, txFrame, PD_FRAME_LEN, onSent))
+  {
+    txBusy = false;
+    txFailed++;
+    return;
+  }
+  txFrames++;
+  now = PTP_GetTimeNow();
+  if((now > target) && ((now - target) > txDispatchMaxNs) && ((now - target) < SEC_IN_NS))
+  {
+    txDispatchMaxNs = (uint32_t)(now - target);
+  }
+}
+
+/* Checks all cycles up to limit for the nodes seen so far */
+static void checkCycles(uint32_t limit)
+{
+  uint8_t i;
+  for(i = 0; i < nodeCnt; i++)
+  {
+    pdNode_t* n = &nodes[i];
+    if((i == ownId) || !n->seen)
+    {
+      continue;
+    }
+    if((int32_t)(limit - n->checkCycle) >= (int32_t)PD_RX_WINDOW)
+    {
+      /* Gap beyond the receive window, e.g. a clock step */
+      n->stats.missing += limit - n->checkCycle + 1u;
+      n->checkCycle = limit + 1u;
+      n->rxMask = 0;
+      continue;
+    }
+    while((int32_t)(limit - n->checkCycle) >= 0)
+    {
+      uint32_t bit = 1u << (n->checkCycle % PD_RX_WINDOW);
+      if(0u != (n->rxMask & bit))
+      {
+        n->rxMask &= ~bit;
+      }
+      else
+      {
+        n->stats.missing++;
+      }
+      n->checkCycle++;
+    }
+  }
+}
+
+bool pdStart(uint8_t nodeId, uint8_t nodeCount, uint32_t cycle, uint32_t slot)
+{
+  uint64_t now = PTP_GetTimeNow();
+  uint64_t start;
+
+  if(running || (0u == now) || (0u == cycle) || (nodeCount > PD_MAX_NODES) || (nodeId >= nodeCount) ||
+     ((uint64_t)slot * nodeCount > cycle))
+  {
+    return false;
+  }
+  memset(nodes, 0, sizeof(nodes));
+  cycleNs = cycle;
+  slotNs = slot;
+  ownId = nodeId;
+  nodeCnt = nodeCount;
+  txFrames = 0;
+  txSkipped = 0;
+  txFailed = 0;
+  txDispatchMaxNs = 0;
+  txBusy = false;
+
+  memset(txFrame, 0, sizeof(txFrame));
+  memcpy(&txFrame[0], PD_DEST_MAC, 6);
+  TC6NoIP_GetMacAddress(0, &txFrame[6]);
+  txFrame[12] = (uint8_t)(PD_ETH_TYPE >> 8);
+  txFrame[13] = (uint8_t)PD_ETH_TYPE;
+
+  /* Two cycles ahead, the first call must not be in the past */
+  start = (((now / cycleNs) + 2u) * cycleNs) + ((uint64_t)ownId * slotNs);
+  currentCycle = (uint32_t)(start / cycleNs);
+  doneSeq = dueSeq;
+  schedSlot = ptpSchedAdd(start, cycleNs, onCycle, NULL);
+  running = (schedSlot >= 0);
+  return running;
+}
+
+void pdStop(void)
+{
+  if(running)
+  {
+    ptpSchedRemove(schedSlot);
+    schedSlot = -1;
+    running = false;
+  }
+}
+
+bool pdIsRunning(void)
+{
+  return running;
+}
+
+void pdSetTxData(const uint8_t* pData, uint8_t len)
+{
+  if(len > PD_DATA_LEN) len = PD_DATA_LEN;
+  memcpy(txData, pData, len);
+}
+
+bool pdGetRxData(uint8_t node, uint8_t pData[PD_DATA_LEN], uint32_t* pCycle)
+{
+  if((node >= PD_MAX_NODES) || !nodes[node].dataValid)
+  {
+    return false;
+  }
+  memcpy(pData, nodes[node].data, PD_DATA_LEN);
+  if(NULL != pCycle) *pCycle = nodes[node].stats.lastCycle;
+  return true;
+}
+
+void pdService(void)
+{
+  uint32_t seq;
+  uint64_t target;
+
+  if(!running || (dueSeq == doneSeq))
+  {
+    return;
+  }
+  /* The interrupt may update the target while it is read */
+  do
+  {
+    seq = dueSeq;
+    target = dueTarget;
+  } while(seq != dueSeq);
+  if((seq - doneSeq) > 1u)
+  {
+    txSkipped += seq - doneSeq - 1u;
+  }
+  doneSeq = seq;
+
+  currentCycle = (uint32_t)(target / cycleNs);
+  sendFrame(target, currentCycle);
+  checkCycles(currentCycle - PD_CHECK_DELAY_CYCLES);
+}
+
+void pdHandleFrame(const uint8_t* pFrame, uint16_t len, uint64_t rxNs)
+{
+  const uint8_t* p = &pFrame[PD_ETH_HEADER_LEN];
+  pdNode_t* n;
+  uint32_t cycle;
+  uint64_t target;
+  int64_t latency;
+
+  if(!running || (len < (PD_ETH_HEADER_LEN + PD_PAYLOAD_LEN)) || (p[0] >= nodeCnt) || (p[0] == ownId) ||
+     (PD_FRAME_VERSION != p[1]))
+  {
+    return;
+  }
+  if(0u == rxNs)
+  {
+    rxNs = PTP_GetTimeNow();
+  }
+  n = &nodes[p[0]];
+  cycle = rd32(&p[2]);
+  target = ((uint64_t)rd32(&p[6]) << 32) | rd32(&p[10]);
+
+  if(!n->seen)
+  {
+    n->seen = true;
+    n->checkCycle = cycle;
+    n->rxMask = 0;
+  }
+  if(((int32_t)(cycle - n->checkCycle) < 0) || ((cycle - n->checkCycle) >= PD_RX_WINDOW))
+  {
+    n->stats.stale++;
+    return;
+  }
+  n->rxMask |= 1u << (cycle % PD_RX_WINDOW);
+
+  latency = (int64_t)(rxNs - target);
+  if((latency > INT32_MIN) && (latency < INT32_MAX))
+  {
+    if((0u == n->stats.received) || (latency < n->stats.latencyMinNs)) n->stats.latencyMinNs = (int32_t)latency;
+    if((0u == n->stats.received) || (latency > n->stats.latencyMaxNs)) n->stats.latencyMaxNs = (int32_t)latency;
+    n->stats.latencySumNs += latency;
+  }
+  if(latency > (int64_t)PD_MAX_LATENCY_NS)
+  {
+    n->stats.late++;
+  }
+  n->stats.received++;
+  n->stats.lastCycle = cycle;
+  memcpy(n->data, &p[14], PD_DATA_LEN);
+  n->dataValid = true;
+}
+
+bool pdGetNodeStats(uint8_t node, pdNodeStats_t* stats)
+{
+  if((node >= PD_MAX_NODES) || !nodes[node].seen)
+  {
+    return false;
+  }
+  *stats = nodes[node].stats;
+  return true;
+}
+
+void pdPrintStatus(void)
+{
+  pdNodeStats_t st;
+  uint8_t i;
+  PTP_LOG("Process data: %s, node %u of %u, cycle %lu us, slot %lu us, cycle #%lu\r\n",
+          running ? "running" : "stopped", ownId, nodeCnt, cycleNs / 1000u, slotNs / 1000u, currentCycle);
+  PTP_LOG("  tx %lu, skipped %lu, failed %lu, hand-over max %lu us\r\n",
+          txFrames, txSkipped, txFailed, txDispatchMaxNs / 1000u);
+  for(i = 0; i < nodeCnt; i++)
+  {
+    if(i == ownId)
+    {
+      continue;
+    }
+    if(!pdGetNodeStats(i, &st))
+    {
+      PTP_LOG("  node %u: not seen\r\n", i);
+      continue;
+    }
+    PTP_LOG("  node %u: rx %lu, late %lu, missing %lu, stale %lu, latency min %ld avg %ld max %ld us\r\n",
+            i, st.received, st.late, st.missing, st.stale, st.latencyMinNs / 1000, 
+            (st.received > 0u) ? (int32_t)(st.latencySumNs / (int64_t)st.received / 1000) : 0,
+            st.latencyMaxNs / 1000);
+  }
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         SIMULATED BUS                                */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+typedef struct
+{
+  uint64_t publishNs;     /* 0 for a PTP frame */
+  uint64_t readyNs;
+  uint16_t len;
+} pdBenchFrame_t;
+
+typedef struct
+{
+  pdBenchFrame_t fifo[PD_BENCH_FIFO];
+  uint8_t count;
+  bool pdQueued;
+  uint64_t nextPublishNs;
+  uint64_t nextReadyNs;
+} pdBenchNode_t;
+
+typedef struct
+{
+  uint32_t frames;
+  uint32_t late;
+  uint32_t missing;
+  uint32_t latencyMaxNs;
+} pdBenchResult_t;
+
+static uint32_t benchRand = 1u;
+
+static uint32_t benchNext(void)
+{
+  benchRand ^= benchRand << 13;
+  benchRand ^= benchRand >> 17;
+  benchRand ^= benchRand << 5;
+  return benchRand;
+}
+
+static bool benchPush(pdBenchNode_t* bn, uint64_t publish, uint64_t ready, uint16_t len)
+{
+  if(bn->count >= PD_BENCH_FIFO)
+  {
+    return false;
+  }
+  bn->fifo[bn->count].publishNs = publish;
+  bn->fifo[bn->count].readyNs = ready;
+  bn->fifo[bn->count].len = len;
+  bn->count++;
+  return true;
+}
+
+/* Plans the next publish of node i, one per cycle at i * slot */
+static void benchPlan(pdBenchNode_t* bn, uint8_t i, uint32_t k, uint32_t cycle, uint32_t slot)
+{
+  bn->nextPublishNs = ((uint64_t)k * cycle) + ((uint64_t)i * slot);
+  bn->nextReadyNs = bn->nextPublishNs + PD_BENCH_DISPATCH_NS + (benchNext() % PD_BENCH_JITTER_NS);
+}
+
+/* n publishers on a bus of PD_MAX_NODES PLCA nodes, node 0 also carries the GM traffic */
+static void benchRun(uint8_t n, uint32_t cycle, pdBenchResult_t* r)
+{
+  pdBenchNode_t bn[PD_MAX_NODES];
+  uint32_t slot = cycle / n;
+  uint64_t end = (uint64_t)PD_BENCH_CYCLES * cycle;
+  uint64_t nextSync = PD_BENCH_SYNC_NS / 2u;
+  uint64_t nextFollowUp = 0;
+  uint64_t t = 0;
+  uint32_t k[PD_MAX_NODES];
+  uint8_t to = 0;
+  uint8_t i;
+
+  memset(bn, 0, sizeof(bn));
+  memset(r, 0, sizeof(*r));
+  for(i = 0; i < n; i++)
+  {
+    k[i] = 1u;
+    benchPlan(&bn[i], i, k[i], cycle, slot);
+  }
+
+  while(t < end)
+  {
+    /* Frames handed to the MAC-PHYs until now */
+    for(i = 0; i < n; i++)
+    {
+      while(bn[i].nextReadyNs <= t)
+      {
+        /* Like sendFrame(): the previous frame is still queued, the new one is dropped */
+        if(bn[i].pdQueued || !benchPush(&bn[i], bn[i].nextPublishNs, bn[i].nextReadyNs, PD_FRAME_LEN))
+        {
+          r->missing++;
+        }
+        else
+        {
+          bn[i].pdQueued = true;
+        }
+        k[i]++;
+        benchPlan(&bn[i], i, k[i], cycle, slot);
+      }
+    }
+    if(nextSync <= t)
+    {
+      (void)benchPush(&bn[0], 0u, nextSync, PD_BENCH_PTP_LEN);
+      nextFollowUp = nextSync + PD_BENCH_FOLLOWUP_NS;
+      nextSync += PD_BENCH_SYNC_NS;
+    }
+    if((0u != nextFollowUp) && (nextFollowUp <= t))
+    {
+      (void)benchPush(&bn[0], 0u, nextFollowUp, PD_BENCH_PTP_LEN);
+      nextFollowUp = 0;
+    }
+
+    if(0u == to)
+    {
+      t += PD_BENCH_BEACON_NS;
+    }
+    if((bn[to].count > 0u) && (bn[to].fifo[0].readyNs <= t))
+    {
+      pdBenchFrame_t f = bn[to].fifo[0];
+      bn[to].count--;
+      memmove(&bn[to].fifo[0], &bn[to].fifo[1], bn[to].count * sizeof(pdBenchFrame_t));
+      t += (uint64_t)(f.len + PD_BENCH_OVERHEAD) * 8u * PD_BENCH_BIT_NS;
+      if(0u != f.publishNs)
+      {
+        uint64_t latency = t + PD_BENCH_RX_NS - f.publishNs;
+        bn[to].pdQueued = false;
+        r->frames++;
+        if(latency > r->latencyMaxNs) r->latencyMaxNs = (uint32_t)latency;
+        if(latency > PD_MAX_LATENCY_NS) r->late++;
+      }
+    }
+    else
+    {
+      t += PD_BENCH_TO_NS;
+    }
+    to = (uint8_t)((to + 1u) % PD_MAX_NODES);
+  }
+}
+
+void pdBenchmark(void)
+{
+  pdBenchResult_t r;
+  uint32_t cycle;
+  uint32_t best;
+  uint32_t bestLatencyNs = 0;
+  uint8_t clean;
+  uint8_t n;
+
+  PTP_LOG("Process data benchmark: %u PLCA nodes, %u byte frames, max latency %lu us, %u cycles per point\r\n",
+          PD_MAX_NODES, PD_FRAME_LEN, PD_MAX_LATENCY_NS / 1000u, PD_BENCH_CYCLES);
+  for(n = 1; n <= PD_MAX_NODES; n++)
+  {
+    benchRand = 1u;
+    best = 0;
+    clean = 0;
+    for(cycle = PD_BENCH_CYCLE_MIN_NS; (cycle <= PD_BENCH_CYCLE_MAX_NS) && (clean < PD_BENCH_CLEAN_STEPS);
+        cycle += PD_BENCH_CYCLE_STEP_NS)
+    {
+      benchRun(n, cycle, &r);
+      if((0u == r.late) && (0u == r.missing))
+      {
+        if(0u == clean++)
+        {
+          best = cycle;
+          bestLatencyNs = r.latencyMaxNs;
+        }
+      }
+      else
+      {
+        clean = 0;
+      }
+    }
+    if(clean < PD_BENCH_CLEAN_STEPS)
+    {
+      PTP_LOG("  %u nodes: no cycle up to %lu us\r\n", n, PD_BENCH_CYCLE_MAX_NS / 1000u);
+    }
+    else
+    {
+      PTP_LOG("  %u nodes: min cycle %lu us, bus load %lu%%, max latency %lu us\r\n", n, best / 1000u,
+              (n * (PD_FRAME_LEN + PD_BENCH_OVERHEAD) * 8u * PD_BENCH_BIT_NS * 100u) / best, bestLatencyNs / 1000u);
+    }
+  }
+}
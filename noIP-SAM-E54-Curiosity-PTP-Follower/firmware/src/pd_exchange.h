@@ -0,0 +1,115 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Cyclic process-data exchange
+
+  File Name:
+    pd_exchange.h
+
+  Summary:
+    Time-triggered publish/consume of small process-data frames over PLCA
+
+  Description:
+    All nodes share a global cycle on the synchronized time: cycle k starts at
+    PTP time k * cycleNs. Node n publishes one frame per cycle at offset
+    n * slotNs, driven by the callback scheduler. The frames of the other
+    nodes are consumed on reception and checked against their publish time:
+    a frame arriving more than PD_MAX_LATENCY_NS after it was due is late, a
+    cycle without a frame from a node is missing once PD_CHECK_DELAY_CYCLES
+    have passed.
+
+    pdBenchmark() runs the same exchange on a simulated PLCA bus of up to
+    PD_MAX_NODES nodes and reports the shortest cycle time without late or
+    missing frames per node count.
+*******************************************************************************/
+
+#ifndef PD_EXCHANGE_H
+#define	PD_EXCHANGE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PD_MAX_NODES                    8u
+/* Process data per frame, the frame stays at the Ethernet minimum */
+#define PD_DATA_LEN                     16u
+/* IEEE 802 local experimental EtherType */
+#define PD_ETH_TYPE                     0x88B5u
+/* Default cycle, 8 nodes at 1 ms each plus room for Sync/FollowUp */
+#define PD_CYCLE_NS                     10000000u
+#define PD_SLOT_NS                      1000000u
+/* Publish to reception, beyond this a frame counts as late */
+#define PD_MAX_LATENCY_NS               800000u
+/* A cycle is checked for missing frames this many cycles after it started */
+#define PD_CHECK_DELAY_CYCLES           2u
+/* Simulated cycles per benchmark point */
+#define PD_BENCH_CYCLES                 200u
+
+typedef struct
+{
+  uint32_t received;
+  uint32_t late;
+  uint32_t missing;
+  uint32_t stale;         /* older than the receive window, dropped */
+  int32_t latencyMinNs;   /* reception minus publish time */
+  int32_t latencyMaxNs;
+  int64_t latencySumNs;
+  uint32_t lastCycle;
+} pdNodeStats_t;
+
+/* Starts publishing as node nodeId of nodeCount, the local PTP clock must be aligned */
+bool pdStart(uint8_t nodeId, uint8_t nodeCount, uint32_t cycleNs, uint32_t slotNs);
+
+void pdStop(void);
+
+bool pdIsRunning(void);
+
+/* Data published from the next cycle on, up to PD_DATA_LEN bytes */
+void pdSetTxData(const uint8_t* pData, uint8_t len);
+
+/* Latest data received from node, false if none was received yet */
+bool pdGetRxData(uint8_t node, uint8_t pData[PD_DATA_LEN], uint32_t* pCycle);
+
+/* Sends the due frame and checks the past cycles, to be called from the main loop */
+void pdService(void);
+
+/* A frame with PD_ETH_TYPE was received, rxNs is its RX timestamp (0 if there is none) */
+void pdHandleFrame(const uint8_t* pFrame, uint16_t len, uint64_t rxNs);
+
+bool pdGetNodeStats(uint8_t node, pdNodeStats_t* stats);
+
+void pdPrintStatus(void);
+
+/* Cycle time versus node count on a simulated PLCA bus */
+void pdBenchmark(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PD_EXCHANGE_H */
@@ -0,0 +1,402 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  PPS phase self-measurement
+
+  File Name:
+    pps_phase.c
+
+  Summary:
+    Measures the phase of the MAC-PHY 1PPS output against the Sync stream
+
+  Description:
+    Local timer model, with t a TC4 tick:
+      gm(t) = gm0 + nsPerTick * (t - tick0)
+    A Sync is placed at
+      t = irq - PPS_PHASE_IRQ_LATENCY_NS
+    with irq the captured IRQ_N edge that announced it. The node clock
+    (PTP_GetTimeNow()) only selects that edge among the captured ones, the
+    PPS edges are not involved. The phase at a PPS edge e is
+    -(gm(e) mod 1 s), wrapped to +-0.5 s, i.e. node minus GM like the offset
+    of the servo.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "definitions.h"
+#include "pps_phase.h"
+#include "ptp_task.h"
+#include "ptp_clock.h"
+
+#define PTP_LOG printf
+
+#define PPS_PHASE_NS_PER_TICK   (1e9 / (double)PPS_PHASE_TICK_HZ)
+#define PPS_PHASE_PERIOD_TOL    ((PPS_PHASE_TICK_HZ / 1000000u) * PPS_PHASE_PERIOD_TOL_PPM)
+#define PPS_PHASE_NS_TO_TICKS(ns) ((uint32_t)(((uint64_t)(ns) * PPS_PHASE_TICK_HZ) / SEC_IN_NS))
+#define PPS_PHASE_IRQ_RING      8u
+
+/* Written by the TC4 capture interrupt */
+static volatile uint32_t edgeLast = 0;
+static volatile uint32_t edgePrev = 0;
+static volatile uint32_t edgeCount = 0;
+static volatile uint32_t captureErrors = 0;
+static volatile uint32_t irqEdge[PPS_PHASE_IRQ_RING];
+static volatile uint32_t irqCount = 0;
+
+static uint32_t edgeSeen = 0;
+static uint32_t edgeBase = 0;
+static uint32_t nowMs = 0;
+
+/* Local timer disciplined by the Sync stream */
+static bool modelValid = false;
+static uint32_t modelMs = 0;
+static uint32_t tick0 = 0;
+static int64_t gm0 = 0;
+static double nsPerTick = PPS_PHASE_NS_PER_TICK;
+static bool rateValid = false;
+static int64_t lastResidualNs = 0;
+static uint32_t reseeds = 0;
+static uint32_t outlierRun = 0;
+static uint32_t outliers = 0;
+
+/* Phase estimate */
+static bool phaseValid = false;
+static uint32_t phaseMs = 0;
+static double phaseRaw = 0.0;
+static double phaseFlt = 0.0;
+static double phaseMin = 0.0;
+static double phaseMax = 0.0;
+static uint32_t phaseSamples = 0;
+
+/* Cross-check against the software offset */
+static bool disagree = false;
+static uint32_t mismatchRun = 0;
+static uint32_t disagreements = 0;
+static double diffLast = 0.0;
+static double diffSum = 0.0;
+static double diffMaxAbs = 0.0;
+static uint32_t diffCount = 0;
+
+static uint32_t missedEdges = 0;
+static uint32_t badPeriods = 0;
+static uint32_t unmappedSyncs = 0;
+static uint32_t ambiguousSyncs = 0;
+static uint32_t hwSteps = 0;
+
+static void onCapture(TC_CAPTURE_STATUS status, uintptr_t context)
+{
+  if(((uint32_t)status & (uint32_t)TC_CAPTURE_STATUS_CAPTURE0_READY) != 0u)
+  {
+    edgePrev = edgeLast;
+    edgeLast = TC4_Capture32bitChannel0Get();
+    edgeCount++;
+  }
+  if(((uint32_t)status & (uint32_t)TC_CAPTURE_STATUS_CAPTURE1_READY) != 0u)
+  {
+    irqEdge[irqCount % PPS_PHASE_IRQ_RING] = TC4_REGS->COUNT32.TC_CC[1];
+    irqCount++;
+  }
+  if(((uint32_t)status & (uint32_t)TC_CAPTURE_STATUS_ERROR) != 0u)
+  {
+    captureErrors++;
+  }
+}
+
+/* Consistent copy of the last two edges, returns the edge count */
+static uint32_t edgeSnapshot(uint32_t* last, uint32_t* prev)
+{
+  uint32_t count;
+  do
+  {
+    count = edgeCount;
+    *last = edgeLast;
+    *prev = edgePrev;
+  } while(count != edgeCount);
+  return count;
+}
+
+/* Both edges are after the last step and one nominal second apart */
+static bool edgePairValid(uint32_t count, uint32_t last, uint32_t prev, uint32_t* period)
+{
+  if((count - edgeBase) < 2u)
+  {
+    return false;
+  }
+  *period = last - prev;
+  return (labs((long)*period - (long)PPS_PHASE_TICK_HZ) <= (long)PPS_PHASE_PERIOD_TOL);
+}
+
+static int64_t modelAt(uint32_t tick)
+{
+  return gm0 + llround(nsPerTick * (double)(int32_t)(tick - tick0));
+}
+
+/* Capture edge for a Sync that arrived at node time receiptNs: the only IRQ_N
+ * edge inside the window around the expected one. False if none or several. */
+static bool irqEdgeFind(uint64_t receiptNs, uint32_t* edge)
+{
+  uint32_t count, now, expected, n;
+  uint64_t nodeNow;
+  bool found = false;
+
+  do
+  {
+    count = irqCount;
+    now = TC4_Capture32bitCounterGet();
+    nodeNow = PTP_GetTimeNow();
+  } while(count != irqCount);
+  if((nodeNow == 0u) || (nodeNow < receiptNs) || ((nodeNow - receiptNs) > ((uint64_t)PPS_PHASE_MAX_AGE_MS * 1000000u)))
+  {
+    return false;
+  }
+  expected = now - PPS_PHASE_NS_TO_TICKS(nodeNow - receiptNs) + PPS_PHASE_NS_TO_TICKS(PPS_PHASE_IRQ_LATENCY_NS);
+  n = (count < PPS_PHASE_IRQ_RING) ? count : PPS_PHASE_IRQ_RING;
+  for(uint32_t i = 1u; i <= n; i++)
+  {
+    uint32_t e = irqEdge[(count - i) % PPS_PHASE_IRQ_RING];
+    if(labs((long)(int32_t)(e - expected)) <= (long)PPS_PHASE_NS_TO_TICKS(PPS_PHASE_IRQ_WINDOW_NS))
+    {
+      if(found)
+      {
+        ambiguousSyncs++;
+        return false;
+      }
+      *edge = e;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void ppsPhaseInit(void)
+{
+  TC4_CaptureCallbackRegister(onCapture, 0);
+  /* Channel 1 captures the falling edge of IRQ_N on WO[1], set up here on top
+   * of the event capture of channel 0 while the counter is still disabled */
+  PORT_PinPeripheralFunctionConfig(PORT_PIN_PB13, PERIPHERAL_FUNCTION_E);
+  TC4_REGS->COUNT32.TC_CTRLA |= TC_CTRLA_CAPTEN1_Msk | TC_CTRLA_COPEN1_Msk;
+  TC4_REGS->COUNT32.TC_DRVCTRL = (uint8_t)TC_DRVCTRL_INVEN1_Msk;
+  TC4_REGS->COUNT32.TC_INTENSET = (uint8_t)TC_INTENSET_MC1_Msk;
+  TC4_CaptureStart();
+}
+
+void ppsPhaseService(uint32_t now)
+{
+  uint32_t last, prev, period, count;
+  int64_t gm, rem;
+
+  nowMs = now;
+  count = edgeSnapshot(&last, &prev);
+  if(count == edgeSeen)
+  {
+    return;
+  }
+  if((edgeSeen != 0u) && ((count - edgeSeen) > 1u))
+  {
+    missedEdges += count - edgeSeen - 1u;
+  }
+  edgeSeen = count;
+  if(!edgePairValid(count, last, prev, &period))
+  {
+    if((count - edgeBase) >= 2u) badPeriods++;
+    return;
+  }
+  if(!modelValid || !rateValid || ((now - modelMs) > PPS_PHASE_STALE_MS))
+  {
+    return;
+  }
+
+  /* The node clock reads a full second at the edge */
+  gm = modelAt(last);
+  rem = gm % (int64_t)SEC_IN_NS;
+  if(rem < 0) rem += (int64_t)SEC_IN_NS;
+  if(rem >= ((int64_t)SEC_IN_NS / 2)) rem -= (int64_t)SEC_IN_NS;
+  phaseRaw = (double)(-rem);
+
+  if(!phaseValid)
+  {
+    phaseFlt = phaseRaw;
+    phaseMin = phaseRaw;
+    phaseMax = phaseRaw;
+  }
+  else
+  {
+    phaseFlt += PPS_PHASE_FILTER_ALPHA * (phaseRaw - phaseFlt);
+    if(phaseRaw < phaseMin) phaseMin = phaseRaw;
+    if(phaseRaw > phaseMax) phaseMax = phaseRaw;
+  }
+  phaseValid = true;
+  phaseMs = now;
+  phaseSamples++;
+}
+
+void ppsPhaseOnSync(uint64_t receiptNs, uint64_t gmNs)
+{
+  uint32_t edge, tick;
+  int64_t predicted, err;
+  int32_t dt;
+
+  if(!irqEdgeFind(receiptNs, &edge))
+  {
+    unmappedSyncs++;
+    return;
+  }
+  tick = edge - PPS_PHASE_NS_TO_TICKS(PPS_PHASE_IRQ_LATENCY_NS);
+
+  dt = (int32_t)(tick - tick0);
+  if(!modelValid || ((nowMs - modelMs) > PPS_PHASE_STALE_MS) || (dt <= 0))
+  {
+    gm0 = (int64_t)gmNs;
+    tick0 = tick;
+    nsPerTick = PPS_PHASE_NS_PER_TICK;
+    rateValid = false;
+    modelValid = true;
+    modelMs = nowMs;
+    lastResidualNs = 0;
+    outlierRun = 0;
+    reseeds++;
+    return;
+  }
+  if(!rateValid)
+  {
+    /* The second pair gives the MCU crystal against the GM */
+    nsPerTick = (double)((int64_t)gmNs - gm0) / (double)dt;
+    gm0 = (int64_t)gmNs;
+    tick0 = tick;
+    rateValid = true;
+    modelMs = nowMs;
+    return;
+  }
+  predicted = modelAt(tick);
+  err = (int64_t)gmNs - predicted;
+  if(llabs(err) > PPS_PHASE_RESEED_NS)
+  {
+    outliers++;
+    if(++outlierRun >= PPS_PHASE_RESEED_COUNT)
+    {
+      /* Consistently off: the model is wrong, not the edges */
+      modelValid = false;
+    }
+    return;
+  }
+  outlierRun = 0;
+  gm0 = predicted + llround(PPS_PHASE_ALPHA * (double)err);
+  tick0 = tick;
+  nsPerTick += PPS_PHASE_BETA * (double)err / (double)dt;
+  modelMs = nowMs;
+  lastResidualNs = err;
+}
+
+void ppsPhaseOnHwStep(int64_t stepNs)
+{
+  uint32_t last, prev;
+  (void)stepNs;
+  /* The next two edges give the period on the new time line */
+  edgeBase = edgeSnapshot(&last, &prev);
+  phaseValid = false;
+  hwSteps++;
+}
+
+bool ppsPhaseGet(double* phaseNs)
+{
+  if(!phaseValid || ((nowMs - phaseMs) > PPS_PHASE_STALE_MS))
+  {
+    return false;
+  }
+  *phaseNs = phaseFlt;
+  return true;
+}
+
+bool ppsPhaseCrossCheck(double offsetNs)
+{
+  double phase;
+  if(!ppsPhaseGet(&phase))
+  {
+    mismatchRun = 0;
+    disagree = false;
+    return true;
+  }
+  diffLast = offsetNs - phase;
+  diffSum += diffLast;
+  diffCount++;
+  if(fabs(diffLast) > diffMaxAbs) diffMaxAbs = fabs(diffLast);
+
+  if(fabs(diffLast) > PPS_PHASE_CROSSCHECK_NS)
+  {
+    if((++mismatchRun >= PPS_PHASE_CROSSCHECK_COUNT) && !disagree)
+    {
+      disagree = true;
+      disagreements++;
+      PTP_LOG("PPS phase %.0f ns disagrees with offset %.0f ns\r\n", phase, offsetNs);
+    }
+  }
+  else
+  {
+    mismatchRun = 0;
+    if(disagree)
+    {
+      disagree = false;
+      PTP_LOG("PPS phase agrees with offset again\r\n");
+    }
+  }
+  return !disagree;
+}
+
+void ppsPhasePrintStatus(void)
+{
+  double phase;
+  if(edgeCount == 0u)
+  {
+    PTP_LOG("No PPS edges on PB07, DIOA4 has to be wired to it (PPS starts once synced)\r\n");
+    return;
+  }
+  if(irqCount == 0u)
+  {
+    PTP_LOG("No IRQ_N edges on PB13, the MAC-PHY IRQ_N has to be wired to it\r\n");
+  }
+  if(ppsPhaseGet(&phase))
+  {
+    PTP_LOG("PPS phase %.0f ns (last %.0f, min %.0f, max %.0f) over %lu edges\r\n",
+            phase, phaseRaw, phaseMin, phaseMax, phaseSamples);
+  }
+  else
+  {
+    PTP_LOG("PPS phase: no estimate\r\n");
+  }
+  PTP_LOG("  local timer %s, %.6f ns/tick (MCU %+.3f ppm), Sync residual %lld ns, reseeds %lu, outliers %lu\r\n",
+          (modelValid && rateValid) ? "valid" : "invalid", nsPerTick,
+          (PPS_PHASE_NS_PER_TICK / nsPerTick - 1.0) * 1e6, lastResidualNs, reseeds, outliers);
+  if(diffCount > 0u)
+  {
+    PTP_LOG("  offset - PPS phase: last %.0f ns, mean %.0f ns, max %.0f ns, disagreements %lu%s\r\n",
+            diffLast, diffSum / (double)diffCount, diffMaxAbs, disagreements, disagree ? " (now)" : "");
+  }
+  PTP_LOG("  edges %lu, missed %lu, bad period %lu, capture errors %lu, steps %lu\r\n",
+          edgeCount, missedEdges, badPeriods, captureErrors, hwSteps);
+  PTP_LOG("  IRQ_N edges %lu, Syncs without edge %lu, ambiguous %lu\r\n",
+          irqCount, unmappedSyncs, ambiguousSyncs);
+}
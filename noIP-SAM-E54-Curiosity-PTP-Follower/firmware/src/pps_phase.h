@@ -0,0 +1,112 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  PPS phase self-measurement
+
+  File Name:
+    pps_phase.h
+
+  Summary:
+    Measures the phase of the MAC-PHY 1PPS output against the Sync stream
+
+  Description:
+    The MAC-PHY 1PPS output (DIOA4) is wired back to PB07 and captured by TC4
+    through EIC EXTINT7 -> EVSYS channel 0, so the edge is timestamped in
+    hardware with the 60 MHz MCU clock. The MAC-PHY IRQ_N is wired to PB13
+    as well (TC4 WO[1]), channel 1 captures its falling edges on the same
+    counter. The edge that announced a Sync, less the fixed receive latency,
+    is the Sync arrival on the MCU timeline, independent of the PPS. These
+    MCU tick / grandmaster time pairs discipline a local timer (alpha-beta
+    loop on phase and ns per tick) that runs on the MCU crystal only. At
+    every PPS edge the local timer is read: its distance to the full second
+    is the phase of the node clock against the GM. A delay in the PPS path
+    or an error of PPS_PHASE_IRQ_LATENCY_NS shows up as a constant bias.
+*******************************************************************************/
+
+#ifndef PPS_PHASE_H
+#define	PPS_PHASE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Capture counter frequency, TC4 on GCLK1 */
+#define PPS_PHASE_TICK_HZ               60000000u
+/* Accepted deviation of the measured PPS period from the nominal second */
+#define PPS_PHASE_PERIOD_TOL_PPM        500
+/* Sync receipts processed later than this after the receipt are not used */
+#define PPS_PHASE_MAX_AGE_MS            500
+/* IRQ_N asserts once the first 64 byte receive chunk is in, 51.2 us after
+ * the SFD at 10 Mbit/s. Calibrate per installation against a scope. */
+#define PPS_PHASE_IRQ_LATENCY_NS        51200
+/* The IRQ edge is picked within this window around the node clock's idea of
+ * the arrival, a second edge inside it makes the Sync ambiguous */
+#define PPS_PHASE_IRQ_WINDOW_NS         20000
+/* Local timer loop gains, critically damped for ALPHA */
+#define PPS_PHASE_ALPHA                 0.125
+#define PPS_PHASE_BETA                  0.008
+/* A Sync further off the local timer is dropped (e.g. IRQ_N held back by a
+ * running SPI transfer), COUNT of them in a row restart the timer */
+#define PPS_PHASE_RESEED_NS             20000
+#define PPS_PHASE_RESEED_COUNT          3
+/* Without a Sync for this long the local timer is not trusted */
+#define PPS_PHASE_STALE_MS              3000
+/* Weight of a new edge in the phase estimate */
+#define PPS_PHASE_FILTER_ALPHA          0.25
+/* Cross-check: a PPS phase this far off the software offset for COUNT
+ * consecutive Syncs is reported as a disagreement */
+#define PPS_PHASE_CROSSCHECK_NS         500
+#define PPS_PHASE_CROSSCHECK_COUNT      8
+
+/* Registers the TC4 capture callback, enables the IRQ_N capture on PB13
+ * and starts the counter */
+void ppsPhaseInit(void);
+
+/* Evaluates new PPS edges, to be called from the main loop */
+void ppsPhaseService(uint32_t nowMs);
+
+/* Feeds a Sync: receipt time in node time and the GM time at that receipt */
+void ppsPhaseOnSync(uint64_t receiptNs, uint64_t gmNs);
+
+/* The node clock was stepped, PPS edges before the step are discarded */
+void ppsPhaseOnHwStep(int64_t stepNs);
+
+/* Filtered phase of the node clock against the GM in ns, false without estimate */
+bool ppsPhaseGet(double* phaseNs);
+
+/* Compares the PPS phase with the software offset (node minus GM).
+ * Returns false while both disagree persistently. */
+bool ppsPhaseCrossCheck(double offsetNs);
+
+void ppsPhasePrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PPS_PHASE_H */
@@ -0,0 +1,338 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Cross-timestamped local PTP clock
+
+  File Name:
+    ptp_clock.c
+
+  Summary:
+    PTP time from the MCU cycle counter, without an SPI access per read
+
+  Description:
+    Local clock model, with c a cycle counter value:
+      ptp(c) = ptp0 + nsPerCycle * (c - cyc0)
+    A round's best cross-timestamp (mid of its bracket, MAC time) becomes the
+    new (cyc0, ptp0). Its distance to the prediction of the previous anchor,
+    divided by the elapsed cycles, corrects nsPerCycle. PTP_GetTimeNow() uses
+    nsPerCycle in Q4.28 fixed point, which keeps the read to one multiply.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "definitions.h"
+#include "ptp_clock.h"
+#include "ptp_task.h"
+#include "tc6.h"
+#include "tc6-noip.h"
+
+#define PTP_LOG printf
+
+#define PTP_CLOCK_NS_PER_CYCLE      (1e9 / (double)PTP_CLOCK_CYCLE_HZ)
+#define PTP_CLOCK_FRAC_BITS         28u
+#define PTP_CLOCK_STALE_CYCLES      ((PTP_CLOCK_CYCLE_HZ / 1000u) * PTP_CLOCK_STALE_MS)
+#define PTP_CLOCK_MAX_BRACKET       ((uint32_t)(((uint64_t)PTP_CLOCK_CYCLE_HZ * PTP_CLOCK_MAX_BRACKET_NS) / SEC_IN_NS))
+
+/* Anchor used by PTP_GetTimeNow(). The main loop fills the inactive copy and
+ * flips the index, an interrupt always reads a complete one. */
+typedef struct
+{
+  uint64_t ptp0;
+  uint32_t cyc0;
+  uint32_t mult;    /* ns per cycle, Q4.28 */
+} ptpClockAnchor_t;
+
+static ptpClockAnchor_t anchor[2];
+static volatile uint8_t anchorIdx = 0;
+static volatile bool aligned = false;
+
+static double nsPerCycle = PTP_CLOCK_NS_PER_CYCLE;
+static bool rateValid = false;
+static uint32_t roundCyc0 = 0;
+static double rateErr = 0.0;
+static uint32_t halfBracketNs = 0;
+
+/* Cross-timestamp round */
+static bool roundBusy = false;
+static bool roundStepped = false;
+static uint8_t roundSample = 0;
+static uint8_t roundTorn = 0;
+static uint32_t roundMs = 0;
+static uint32_t sampleCyc = 0;
+static uint32_t sampleSec = 0;
+static uint32_t bestBracket = 0;
+static uint32_t bestCyc = 0;
+static uint64_t bestPtp = 0;
+static bool reseedPending = false;
+static uint32_t reseedCyc = 0;
+static uint64_t reseedPtp = 0;
+
+static uint32_t rounds = 0;
+static uint32_t droppedRounds = 0;
+static uint32_t reseeds = 0;
+static uint32_t reseedsHeld = 0;
+static uint32_t tornSamples = 0;
+static uint32_t readErrors = 0;
+static uint32_t hwSteps = 0;
+static uint32_t rateChanges = 0;
+static int64_t lastResidualNs = 0;
+static uint32_t bracketMinNs = UINT32_MAX;
+static uint32_t bracketMaxNs = 0;
+
+static void onSampleRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
+
+static uint32_t cyclesToNs(uint32_t cycles)
+{
+  return (uint32_t)(((uint64_t)cycles * SEC_IN_NS) / PTP_CLOCK_CYCLE_HZ);
+}
+
+static const ptpClockAnchor_t* anchorGet(void)
+{
+  return &anchor[anchorIdx];
+}
+
+static void anchorPublish(uint64_t ptp0, uint32_t cyc0)
+{
+  uint8_t next = anchorIdx ^ 1u;
+  anchor[next].ptp0 = ptp0;
+  anchor[next].cyc0 = cyc0;
+  anchor[next].mult = (uint32_t)llround(nsPerCycle * (double)(1ul << PTP_CLOCK_FRAC_BITS));
+  anchorIdx = next;
+  aligned = true;
+}
+
+/* Model time at cycle counter value cyc, also slightly before the anchor */
+static uint64_t modelAt(uint32_t cyc)
+{
+  const ptpClockAnchor_t* a = anchorGet();
+  return a->ptp0 + (uint64_t)llround(nsPerCycle * (double)(int32_t)(cyc - a->cyc0));
+}
+
+static bool sampleStart(void)
+{
+  sampleCyc = DWT->CYCCNT;
+  return TC6_ReadRegisters(get_macPhy_inst(), MAC_TSL, 2u, true, onSampleRead, NULL);
+}
+
+static void roundApply(void)
+{
+  uint32_t bracketNs = cyclesToNs(bestBracket);
+  int32_t dt;
+  int64_t err;
+  bool stale;
+
+  if(roundStepped || (bestBracket > PTP_CLOCK_MAX_BRACKET))
+  {
+    droppedRounds++;
+    return;
+  }
+  if(bracketNs < bracketMinNs) bracketMinNs = bracketNs;
+  if(bracketNs > bracketMaxNs) bracketMaxNs = bracketNs;
+
+  if(aligned)
+  {
+    /* Rate changes re-anchor in between, the error builds up since the last round */
+    dt = (int32_t)(bestCyc - roundCyc0);
+    err = (int64_t)(bestPtp - modelAt(bestCyc));
+    lastResidualNs = err;
+    stale = (dt <= 0) || (PTP_GetTimeNow() == 0u);
+    if(!stale && rateValid && (llabs(err) > PTP_CLOCK_RESEED_NS))
+    {
+      /* Keep the running anchor until a second round lands on the same new time line */
+      if(!reseedPending ||
+         (llabs((int64_t)(bestPtp - reseedPtp) - llround(nsPerCycle * (double)(uint32_t)(bestCyc - reseedCyc))) > PTP_CLOCK_RESEED_NS))
+      {
+        reseedPending = true;
+        reseedPtp = bestPtp;
+        reseedCyc = bestCyc;
+        reseedsHeld++;
+        return;
+      }
+      reseeds++;
+    }
+    else if(!stale)
+    {
+      /* Unexplained drift per ns of the last interval, before the correction */
+      rateErr = fabs((double)err) / ((double)dt * nsPerCycle);
+      /* The first interval gives the crystal offset, later ones only track it */
+      nsPerCycle += (rateValid ? PTP_CLOCK_RATE_BETA : 1.0) * (double)err / (double)dt;
+      rateValid = true;
+    }
+    else
+    {
+      reseeds++;
+    }
+  }
+  reseedPending = false;
+  halfBracketNs = bracketNs / 2u;
+  roundCyc0 = bestCyc;
+  anchorPublish(bestPtp, bestCyc);
+  rounds++;
+}
+
+static void onSampleRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+  uint32_t cyc = DWT->CYCCNT;
+  uint32_t bracket;
+
+  if(!success)
+  {
+    readErrors++;
+    roundBusy = false;
+    return;
+  }
+  if(addr == MAC_TSL)
+  {
+    sampleSec = value;
+    return;
+  }
+  bracket = cyc - sampleCyc;
+  if((value < PTP_CLOCK_ROLLOVER_GUARD_NS) || (value >= (SEC_IN_NS - PTP_CLOCK_ROLLOVER_GUARD_NS)))
+  {
+    /* Possibly torn across the rollover, read again past it */
+    tornSamples++;
+    if((++roundTorn <= PTP_CLOCK_SAMPLES) && sampleStart())
+    {
+      return;
+    }
+    roundBusy = false;
+    roundApply();
+    return;
+  }
+  if(bracket < bestBracket)
+  {
+    bestBracket = bracket;
+    bestCyc = sampleCyc + (bracket / 2u);
+    bestPtp = ((uint64_t)sampleSec * SEC_IN_NS) + value;
+  }
+  /* One read at a time, a sample never waits behind its predecessor */
+  if(++roundSample < PTP_CLOCK_SAMPLES)
+  {
+    if(sampleStart())
+    {
+      return;
+    }
+    readErrors++;
+  }
+  roundBusy = false;
+  roundApply();
+}
+
+void ptpClockInit(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void ptpClockService(uint32_t nowMs)
+{
+  if(roundBusy)
+  {
+    if((nowMs - roundMs) > PTP_CLOCK_INTERVAL_MS)
+    {
+      /* The last read never came back */
+      readErrors++;
+      roundBusy = false;
+    }
+    return;
+  }
+  if((nowMs - roundMs) < PTP_CLOCK_INTERVAL_MS)
+  {
+    return;
+  }
+  roundMs = nowMs;
+  roundSample = 0;
+  roundTorn = 0;
+  roundStepped = false;
+  bestBracket = UINT32_MAX;
+  roundBusy = sampleStart();
+}
+
+void ptpClockOnHwStep(int64_t stepNs)
+{
+  const ptpClockAnchor_t* a = anchorGet();
+  /* Samples of the running round are on the old time line */
+  roundStepped = roundBusy;
+  reseedPending = false;
+  hwSteps++;
+  if(aligned)
+  {
+    anchorPublish((uint64_t)((int64_t)a->ptp0 + stepNs), a->cyc0);
+  }
+}
+
+void ptpClockOnRateChange(double scale)
+{
+  uint32_t cyc = DWT->CYCCNT;
+  uint64_t now;
+  rateChanges++;
+  if(aligned)
+  {
+    now = modelAt(cyc);
+    nsPerCycle *= scale;
+    anchorPublish(now, cyc);
+  }
+}
+
+uint64_t PTP_GetTimeNow(void)
+{
+  const ptpClockAnchor_t* a = anchorGet();
+  uint32_t d = DWT->CYCCNT - a->cyc0;
+  if(!aligned || (d > PTP_CLOCK_STALE_CYCLES))
+  {
+    return 0u;
+  }
+  return a->ptp0 + (((uint64_t)d * a->mult) >> PTP_CLOCK_FRAC_BITS);
+}
+
+uint32_t ptpClockErrorBoundNs(void)
+{
+  uint32_t d = DWT->CYCCNT - anchorGet()->cyc0;
+  if(!aligned || (d > PTP_CLOCK_STALE_CYCLES))
+  {
+    return UINT32_MAX;
+  }
+  return halfBracketNs + (uint32_t)(rateErr * (double)cyclesToNs(d)) + (uint32_t)ceil(PTP_CLOCK_NS_PER_CYCLE);
+}
+
+void ptpClockPrintStatus(void)
+{
+  uint64_t now = PTP_GetTimeNow();
+  if(now == 0u)
+  {
+    PTP_LOG("Local PTP clock not aligned (rounds %lu, dropped %lu, read errors %lu)\r\n", rounds, droppedRounds, readErrors);
+    return;
+  }
+  PTP_LOG("Local PTP clock %llu.%09llu, bound %lu ns\r\n", now / SEC_IN_NS, now % SEC_IN_NS, ptpClockErrorBoundNs());
+  PTP_LOG("  cycle rate %.6f ns (%+.3f ppm), last residual %lld ns, rate error %.1f ppb\r\n",
+          nsPerCycle, (PTP_CLOCK_NS_PER_CYCLE / nsPerCycle - 1.0) * 1e6, lastResidualNs, rateErr * 1e9);
+  PTP_LOG("  bracket min %lu ns max %lu ns, rounds %lu, dropped %lu, reseeds %lu (held %lu), read errors %lu\r\n",
+          bracketMinNs, bracketMaxNs, rounds, droppedRounds, reseeds, reseedsHeld, readErrors);
+  PTP_LOG("  samples dropped at the seconds rollover %lu\r\n", tornSamples);
+  PTP_LOG("  steps %lu, rate changes %lu\r\n", hwSteps, rateChanges);
+}
@@ -0,0 +1,102 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Cross-timestamped local PTP clock
+
+  File Name:
+    ptp_clock.h
+
+  Summary:
+    PTP time from the MCU cycle counter, without an SPI access per read
+
+  Description:
+    The DWT cycle counter of the Cortex-M4 runs with the CPU clock. Once per
+    PTP_CLOCK_INTERVAL_MS a round of PTP_CLOCK_SAMPLES cross-timestamps is
+    taken: the cycle counter is read right before MAC_TSL/MAC_TN are enqueued
+    and again in the read callback. The sample with the shortest bracket wins,
+    its midpoint anchors the local clock. Rate changes the servo writes to
+    MAC_TI are applied right away, the cross-timestamps remove what is left.
+
+    Error bound, as returned by ptpClockErrorBoundNs():
+      half of the winning bracket (the registers were latched inside it)
+      + the rate error seen in the last round, times the age of the anchor
+      + one cycle of the counter.
+*******************************************************************************/
+
+#ifndef PTP_CLOCK_H
+#define	PTP_CLOCK_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DWT cycle counter frequency, the CPU clock */
+#define PTP_CLOCK_CYCLE_HZ              120000000u
+/* Cross-timestamp rounds and samples per round */
+#define PTP_CLOCK_INTERVAL_MS           1000u
+#define PTP_CLOCK_SAMPLES               8u
+/* A round whose best bracket is longer than this is dropped */
+#define PTP_CLOCK_MAX_BRACKET_NS        200000u
+/* A sample read this close to a seconds rollover may pair MAC_TSL and MAC_TN
+ * of different seconds, it is dropped and read again */
+#define PTP_CLOCK_ROLLOVER_GUARD_NS     PTP_CLOCK_MAX_BRACKET_NS
+/* A round further off the local clock re-anchors it without touching the rate,
+ * once the next round confirms the new time line */
+#define PTP_CLOCK_RESEED_NS             100000
+/* Weight of a round's rate error in the cycle rate */
+#define PTP_CLOCK_RATE_BETA             0.25
+/* Without a valid round for this long the clock is not trusted.
+ * Must stay well below the 35.8 s wrap of the cycle counter. */
+#define PTP_CLOCK_STALE_MS              5000u
+
+/* Starts the cycle counter */
+void ptpClockInit(void);
+
+/* Takes the cross-timestamp rounds, to be called from the main loop */
+void ptpClockService(uint32_t nowMs);
+
+/* The node clock was stepped by stepNs */
+void ptpClockOnHwStep(int64_t stepNs);
+
+/* The node clock increment was scaled by scale (new / old) */
+void ptpClockOnRateChange(double scale);
+
+/* PTP time in ns since the PTP epoch, 0 while the clock is not aligned.
+ * Safe to call from interrupts. */
+uint64_t PTP_GetTimeNow(void);
+
+/* Error bound of PTP_GetTimeNow() at this moment in ns, UINT32_MAX while not aligned */
+uint32_t ptpClockErrorBoundNs(void);
+
+void ptpClockPrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PTP_CLOCK_H */
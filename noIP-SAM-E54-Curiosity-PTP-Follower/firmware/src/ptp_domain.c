@@ -0,0 +1,328 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Additional gPTP domains
+
+  File Name:
+    ptp_domain.c
+
+  Summary:
+    Software time bases for gPTP domains which do not discipline the MAC-PHY
+
+  Description:
+    Each domain keeps an anchor (hardware time, domain time) and a rate ratio.
+    The anchor is moved on every Sync by the measured offset, the rate ratio is
+    measured between consecutive Syncs and FIR filtered like the hardware servo.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ptp_domain.h"
+#include "ptp_task.h"
+#include <filters.h>
+
+#define PTP_LOG printf
+
+typedef struct
+{
+  bool        used;
+  uint8_t     domainNumber;
+  clockIdentity_t clockIdentity;
+  uint32_t    lastSyncMs;
+  uint8_t     syncStatus;
+  int32_t     syncSequenceId;
+  bool        syncReceived;
+  int64_t     syncCorrectionNs;
+  uint64_t    syncRxTime;
+  uint64_t    prevOrigin;
+  uint64_t    prevRxTime;
+  uint64_t    anchorHw;
+  uint64_t    anchorDomain;
+  double      rateRatio;
+  int64_t     offset;
+  uint32_t    runs;
+  double      rateRatioValue[FIR_FILER_SIZE];
+  lpfStateF   rateRatiolpfState;
+} ptpDomain_t;
+
+static ptpDomain_t domains[PTP_MAX_SW_DOMAINS];
+
+static void resetDomain(ptpDomain_t* d, uint8_t domainNumber, const clockIdentity_t clockIdentity)
+{
+  clockIdentity_t id;
+  memcpy(id, clockIdentity, sizeof(clockIdentity_t));
+  memset(d, 0, sizeof(ptpDomain_t));
+  d->used = true;
+  d->domainNumber = domainNumber;
+  memcpy(d->clockIdentity, id, sizeof(clockIdentity_t));
+  d->syncStatus = UNINIT;
+  d->syncSequenceId = -1;
+  d->rateRatio = 1.0;
+  d->rateRatiolpfState.buffer = &d->rateRatioValue[0];
+  d->rateRatiolpfState.filterSize = FIR_FILER_SIZE;
+  for(uint32_t x = 0; x < FIR_FILER_SIZE; x++)
+  {
+    (void) firLowPassFilterF(1.0, &d->rateRatiolpfState);
+  }
+}
+
+/* clockIdentity NULL matches any GM of the domain */
+static ptpDomain_t* getDomain(uint8_t domainNumber, const uint8_t* clockIdentity, bool create)
+{
+  ptpDomain_t* freeSlot = NULL;
+  for(uint32_t i = 0; i < PTP_MAX_SW_DOMAINS; i++)
+  {
+    if(domains[i].used && (domains[i].domainNumber == domainNumber) &&
+       ((NULL == clockIdentity) || (0 == memcmp(domains[i].clockIdentity, clockIdentity, sizeof(clockIdentity_t)))))
+    {
+      return &domains[i];
+    }
+    if(!domains[i].used && (NULL == freeSlot))
+    {
+      freeSlot = &domains[i];
+    }
+  }
+  if(create && (NULL != freeSlot) && (NULL != clockIdentity))
+  {
+    resetDomain(freeSlot, domainNumber, clockIdentity);
+    PTP_LOG("Tracking gPTP domain %u, GM %02X%02X%02X.%02X%02X.%02X%02X%02X in software\r\n", domainNumber,
+            clockIdentity[0], clockIdentity[1], clockIdentity[2], clockIdentity[3],
+            clockIdentity[4], clockIdentity[5], clockIdentity[6], clockIdentity[7]);
+    return freeSlot;
+  }
+  return NULL;
+}
+
+static uint64_t mapToDomain(const ptpDomain_t* d, uint64_t hwTime)
+{
+  int64_t dt = (int64_t)(hwTime - d->anchorHw);
+  return d->anchorDomain + (int64_t)((double)dt * d->rateRatio);
+}
+
+static void updateDomain(ptpDomain_t* d, uint64_t t1, uint64_t t2)
+{
+  if(d->prevRxTime != 0)
+  {
+    double ratio = (double)(int64_t)(t1 - d->prevOrigin) / (double)(int64_t)(t2 - d->prevRxTime);
+    if((ratio > 0.998) && (ratio < 1.002))
+    {
+      d->rateRatio = firLowPassFilterF(ratio, &d->rateRatiolpfState);
+      d->runs++;
+    }
+  }
+  d->prevOrigin = t1;
+  d->prevRxTime = t2;
+  
+  if(d->syncStatus == UNINIT)
+  {
+    d->anchorHw = t2;
+    d->anchorDomain = t1;
+    d->offset = 0;
+    if(d->runs >= FIR_FILER_SIZE)
+    {
+      d->syncStatus = MATCHFREQ;
+    }
+    return;
+  }
+  
+  /* Offset of the mapping against the GM of this domain */
+  uint64_t predicted = mapToDomain(d, t2);
+  d->offset = (int64_t)(predicted - t1);
+  
+  if(llabs(d->offset) > PTP_DOMAIN_STEP_THRESHOLD_NS)
+  {
+    d->anchorDomain = t1;
+    d->syncStatus = HARDSYNC;
+  }
+  else if(llabs(d->offset) > PTP_DOMAIN_FINE_THRESHOLD_NS)
+  {
+    d->anchorDomain = t1;
+    d->syncStatus = COARSE;
+  }
+  else
+  {
+    d->anchorDomain = predicted - (int64_t)((double)d->offset * PTP_DOMAIN_FINE_GAIN);
+    d->syncStatus = FINE;
+  }
+  d->anchorHw = t2;
+}
+
+void ptpDomainHandlePtp(ptpHeader_t* hdr, uint64_t rxTime, uint32_t nowMs)
+{
+  uint8_t messageType = hdr->tsmt & 0xFu;
+  uint16_t seqId = htons(hdr->sequenceID);
+  ptpDomain_t* d;
+  
+  if((messageType != MSG_SYNC) && (messageType != MSG_FOLLOW_UP))
+  {
+    return;
+  }
+  d = getDomain(hdr->domainNumber, hdr->sourcePortIdentity.clockIdentity, (messageType == MSG_SYNC));
+  if(NULL == d)
+  {
+    return;
+  }
+  
+  if(messageType == MSG_SYNC)
+  {
+    syncMsg_t* sync = (syncMsg_t*)hdr;
+    if((d->syncSequenceId >= 0) && (abs((int32_t)seqId - d->syncSequenceId) > 10))
+    {
+      PTP_LOG("Domain %u: large sequence mismatch, resetting\r\n", d->domainNumber);
+      resetDomain(d, d->domainNumber, d->clockIdentity);
+    }
+    d->lastSyncMs = nowMs;
+    d->syncSequenceId = seqId;
+    d->syncReceived = true;
+    d->syncCorrectionNs = getCorrectionField(hdr);
+    d->syncRxTime = rxTime;
+    
+    if(!(hdr->flags[0] & PTP_FLAG_TWO_STEP))
+    {
+      timeStamp_t origin;
+      origin.secondsMsb = htons(sync->originTimestamp.secondsMsb);
+      origin.secondsLsb = htonl(sync->originTimestamp.secondsLsb);
+      origin.nanoseconds = htonl(sync->originTimestamp.nanoseconds);
+      d->syncReceived = false;
+      updateDomain(d, tsToInternal(&origin) + d->syncCorrectionNs + PTP_MEAN_LINK_DELAY_NS, rxTime);
+    }
+  }
+  else
+  {
+    followUpMsg_t* fup = (followUpMsg_t*)hdr;
+    if(!d->syncReceived || (d->syncSequenceId != (int32_t)seqId))
+    {
+      d->syncReceived = false;
+      return;
+    }
+    d->syncReceived = false;
+    
+    timeStamp_t origin;
+    origin.secondsMsb = htons(fup->preciseOriginTimestamp.secondsMsb);
+    origin.secondsLsb = htonl(fup->preciseOriginTimestamp.secondsLsb);
+    origin.nanoseconds = htonl(fup->preciseOriginTimestamp.nanoseconds);
+    updateDomain(d, tsToInternal(&origin) + d->syncCorrectionNs + getCorrectionField(hdr) + PTP_MEAN_LINK_DELAY_NS, d->syncRxTime);
+  }
+}
+
+void ptpDomainOnHwStep(int64_t stepNs)
+{
+  for(uint32_t i = 0; i < PTP_MAX_SW_DOMAINS; i++)
+  {
+    if(domains[i].used)
+    {
+      /* The same instant reads stepNs later on the hardware clock now */
+      domains[i].anchorHw += stepNs;
+      if(domains[i].prevRxTime != 0)
+      {
+        domains[i].prevRxTime += stepNs;
+      }
+      domains[i].syncRxTime += stepNs;
+    }
+  }
+}
+
+void ptpDomainReset(void)
+{
+  memset(domains, 0, sizeof(domains));
+}
+
+bool PTP_DomainToTime(uint8_t domainNumber, uint64_t hwTime, uint64_t* domainTime)
+{
+  ptpDomain_t* d;
+  
+  if(domainNumber == PTP_HW_DOMAIN)
+  {
+    *domainTime = hwTime;
+    return (ptpGetSyncStatus() >= HARDSYNC);
+  }
+  d = getDomain(domainNumber, NULL, false);
+  if((NULL == d) || (d->syncStatus < MATCHFREQ))
+  {
+    return false;
+  }
+  *domainTime = mapToDomain(d, hwTime);
+  return true;
+}
+
+bool ptpDomainGetStandby(uint8_t domainNumber, const clockIdentity_t exclude, uint32_t nowMs, ptpStandby_t* standby)
+{
+  ptpDomain_t* best = NULL;
+  
+  for(uint32_t i = 0; i < PTP_MAX_SW_DOMAINS; i++)
+  {
+    ptpDomain_t* d = &domains[i];
+    if(!d->used || (d->domainNumber != domainNumber) || (0 == memcmp(d->clockIdentity, exclude, sizeof(clockIdentity_t))))
+    {
+      continue;
+    }
+    if((d->syncStatus < COARSE) || ((nowMs - d->lastSyncMs) > PTP_GM_LOSS_TIMEOUT_MS))
+    {
+      continue;
+    }
+    if((NULL == best) || (d->syncStatus > best->syncStatus) ||
+       ((d->syncStatus == best->syncStatus) && (llabs(d->offset) < llabs(best->offset))))
+    {
+      best = d;
+    }
+  }
+  if(NULL == best)
+  {
+    return false;
+  }
+  memcpy(standby->clockIdentity, best->clockIdentity, sizeof(clockIdentity_t));
+  standby->syncStatus = best->syncStatus;
+  standby->offsetNs = (int64_t)(best->anchorDomain - best->anchorHw);
+  standby->rateRatio = best->rateRatio;
+  standby->lastSyncMs = best->lastSyncMs;
+  return true;
+}
+
+void ptpDomainDrop(uint8_t domainNumber, const clockIdentity_t clockIdentity)
+{
+  ptpDomain_t* d = getDomain(domainNumber, clockIdentity, false);
+  if(NULL != d)
+  {
+    d->used = false;
+  }
+}
+
+void ptpDomainPrintStatus(void)
+{
+  PTP_LOG("Domain %u: hardware clock, state %u\r\n", PTP_HW_DOMAIN, ptpGetSyncStatus());
+  for(uint32_t i = 0; i < PTP_MAX_SW_DOMAINS; i++)
+  {
+    if(domains[i].used)
+    {
+      PTP_LOG("Domain %u: GM %02X%02X%02X.%02X%02X.%02X%02X%02X, state %u, offset %ld ns, rateRatio %.9f, to hardware %lld ns\r\n",
+              domains[i].domainNumber,
+              domains[i].clockIdentity[0], domains[i].clockIdentity[1], domains[i].clockIdentity[2], domains[i].clockIdentity[3],
+              domains[i].clockIdentity[4], domains[i].clockIdentity[5], domains[i].clockIdentity[6], domains[i].clockIdentity[7],
+              domains[i].syncStatus, (int32_t)domains[i].offset, domains[i].rateRatio,
+              (int64_t)(domains[i].anchorDomain - domains[i].anchorHw));
+    }
+  }
+}
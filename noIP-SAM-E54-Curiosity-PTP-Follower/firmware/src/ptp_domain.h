@@ -0,0 +1,101 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Additional gPTP domains
+
+  File Name:
+    ptp_domain.h
+
+  Summary:
+    Software time bases for gPTP domains which do not discipline the MAC-PHY
+
+  Description:
+    One domain (PTP_HW_DOMAIN) steers MAC_TI/MAC_TSL of the LAN865x. Every other
+    domain, and every further GM of PTP_HW_DOMAIN (hot standby), is tracked as an
+    offset/rate mapping on top of that hardware clock, with its own Sync/FollowUp
+    matching and servo state.
+*******************************************************************************/
+
+#ifndef PTP_DOMAIN_H
+#define	PTP_DOMAIN_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ptp_task.h"
+
+/* Domain which disciplines the LAN865x hardware clock */
+#define PTP_HW_DOMAIN                   0
+/* Number of additional domains tracked in software */
+#define PTP_MAX_SW_DOMAINS              3
+
+/* Offset above which a software domain is re-anchored instead of steered */
+#define PTP_DOMAIN_STEP_THRESHOLD_NS    HARDSYNC_THRESHOLD
+/* Offset below which a software domain is considered FINE */
+#define PTP_DOMAIN_FINE_THRESHOLD_NS    HARDSYNC_COARSE_THRESHOLD
+/* Share of the measured offset applied per Sync while FINE */
+#define PTP_DOMAIN_FINE_GAIN            0.5
+
+/* Standby GM: no Sync for this long and it is not used for a switchover */
+#define PTP_GM_LOSS_TIMEOUT_MS          1000
+
+typedef struct
+{
+  clockIdentity_t clockIdentity;
+  uint8_t         syncStatus;
+  int64_t         offsetNs;       // standby time minus hardware time
+  double          rateRatio;      // standby time per hardware time
+  uint32_t        lastSyncMs;
+} ptpStandby_t;
+
+/* Tracks a PTP message which does not discipline the hardware clock: another domain,
+ * or a standby GM of PTP_HW_DOMAIN. rxTime is the hardware receive timestamp in ns. */
+void ptpDomainHandlePtp(ptpHeader_t* hdr, uint64_t rxTime, uint32_t nowMs);
+
+/* Has to be called whenever the hardware clock is stepped, stepNs is added to the hardware time */
+void ptpDomainOnHwStep(int64_t stepNs);
+
+/* Drops the state of all software domains */
+void ptpDomainReset(void);
+
+/* Converts a hardware timestamp (ns) into the time of the given domain. Returns false if the domain is not synchronized. */
+bool PTP_DomainToTime(uint8_t domainNumber, uint64_t hwTime, uint64_t* domainTime);
+
+/* Best converged GM of the domain other than exclude, false if there is none */
+bool ptpDomainGetStandby(uint8_t domainNumber, const clockIdentity_t exclude, uint32_t nowMs, ptpStandby_t* standby);
+
+/* Stops tracking a GM in software, e.g. once it disciplines the hardware clock */
+void ptpDomainDrop(uint8_t domainNumber, const clockIdentity_t clockIdentity);
+
+void ptpDomainPrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PTP_DOMAIN_H */
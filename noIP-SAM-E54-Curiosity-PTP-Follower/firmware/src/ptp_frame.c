@@ -0,0 +1,290 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  PTP frame templates
+
+  File Name:
+    ptp_frame.c
+
+  Summary:
+    Prebuilt gPTP frames which are patched in place per transmission
+
+  Description:
+    The templates are laid out byte by byte in network order, so patching a
+    field is a few byte stores at a fixed offset. No structure is copied and
+    nothing is byte swapped on the hot path.
+*******************************************************************************/
+
+#include <string.h>
+#include "ptp_frame.h"
+
+/* Field offsets within the PTP message, behind the Ethernet header */
+#define OFS_TSMT                0
+#define OFS_VERSION             1
+#define OFS_LENGTH              2
+#define OFS_DOMAIN              4
+#define OFS_FLAGS               6
+#define OFS_CORRECTION          8
+#define OFS_CLOCK_IDENTITY      20
+#define OFS_PORT_NUMBER         28
+#define OFS_SEQUENCE_ID         30
+#define OFS_CONTROL             32
+#define OFS_LOG_INTERVAL        33
+#define OFS_TIMESTAMP           34
+#define OFS_REQUESTING_PORT     44
+#define OFS_FUP_TLV             44
+#define OFS_FUP_GM_TIME_BASE    58
+#define OFS_ANNOUNCE_UTC_OFFSET 44
+#define OFS_ANNOUNCE_PRIORITY1  47
+#define OFS_ANNOUNCE_GM_ID      53
+#define OFS_ANNOUNCE_STEPS      61
+#define OFS_ANNOUNCE_TIME_SOURCE 63
+#define OFS_SIGNALING_TARGET    34
+#define OFS_SIGNALING_TLV       44
+#define OFS_SIGNALING_INTERVALS 54
+
+#define FLAG0_TWO_STEP          0x02u
+#define FLAG1_UTC_OFFSET_VALID  0x04u
+#define FLAG1_PTP_TIMESCALE     0x08u
+#define FLAG1_TIME_TRACEABLE    0x10u
+#define FLAG1_FREQ_TRACEABLE    0x20u
+#define MAJOR_SDO_ID_GPTP       0x10u
+#define LOG_INTERVAL_UNUSED     0x7Fu
+
+static const uint8_t ptpMulticastMac[6] = {0x01, 0x80, 0xC2, 0x00, 0x00, 0x0E};
+
+static inline uint8_t* ptpMsg(ptpFrame_t* frame)
+{
+  return &frame->buf[PTP_FRAME_ETH_HEADER_LEN];
+}
+
+static inline void put16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)(v >> 8);
+  p[1] = (uint8_t)v;
+}
+
+static inline void put32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static void putOrgTlv(uint8_t* p, uint16_t length, uint8_t subType)
+{
+  put16(&p[0], 0x0003u);            // ORGANIZATION_EXTENSION
+  put16(&p[2], length);
+  p[4] = 0x00;                      // IEEE 802.1 OUI 00-80-C2
+  p[5] = 0x80;
+  p[6] = 0xC2;
+  p[9] = subType;
+}
+
+bool ptpFrameBuild(ptpFrame_t* frame, ptpFrameType_t type, const ptpFrameConfig_t* cfg)
+{
+  uint8_t* msg = ptpMsg(frame);
+  uint16_t frameLen;
+  uint8_t control = 5;
+  uint8_t logInterval = (uint8_t)cfg->logMessageInterval;
+  bool timescale = false;
+  bool twoStep = false;
+
+  switch(type)
+  {
+    case PTP_FRAME_SYNC:
+      frameLen = PTP_FRAME_SYNC_LEN;
+      control = 0;
+      timescale = true;
+      twoStep = cfg->twoStep;
+      break;
+    case PTP_FRAME_FOLLOW_UP:
+      frameLen = PTP_FRAME_FOLLOW_UP_LEN;
+      control = 2;
+      timescale = true;
+      break;
+    case PTP_FRAME_PDELAY_REQ:
+      frameLen = PTP_FRAME_PDELAY_LEN;
+      break;
+    case PTP_FRAME_PDELAY_RESP:
+      frameLen = PTP_FRAME_PDELAY_LEN;
+      logInterval = LOG_INTERVAL_UNUSED;
+      twoStep = true;
+      break;
+    case PTP_FRAME_PDELAY_RESP_FUP:
+      frameLen = PTP_FRAME_PDELAY_LEN;
+      logInterval = LOG_INTERVAL_UNUSED;
+      break;
+    case PTP_FRAME_ANNOUNCE:
+      frameLen = PTP_FRAME_ANNOUNCE_LEN;
+      timescale = true;
+      break;
+    case PTP_FRAME_SIGNALING:
+      frameLen = PTP_FRAME_SIGNALING_LEN;
+      logInterval = LOG_INTERVAL_UNUSED;
+      break;
+    default:
+      return false;
+  }
+
+  memset(frame->buf, 0, sizeof(frame->buf));
+  frame->len = frameLen;
+  frame->type = type;
+
+  memcpy(&frame->buf[0], ptpMulticastMac, sizeof(ptpMulticastMac));
+  memcpy(&frame->buf[6], cfg->srcMac, 6);
+  frame->buf[12] = 0x88;
+  frame->buf[13] = 0xF7;
+
+  msg[OFS_TSMT] = MAJOR_SDO_ID_GPTP | (uint8_t)type;
+  msg[OFS_VERSION] = 0x02;
+  put16(&msg[OFS_LENGTH], (uint16_t)(frameLen - PTP_FRAME_ETH_HEADER_LEN));
+  msg[OFS_DOMAIN] = cfg->domainNumber;
+  msg[OFS_FLAGS] = twoStep ? FLAG0_TWO_STEP : 0u;
+  msg[OFS_FLAGS + 1] = timescale ? FLAG1_PTP_TIMESCALE : 0u;
+  memcpy(&msg[OFS_CLOCK_IDENTITY], cfg->clockIdentity, 8);
+  put16(&msg[OFS_PORT_NUMBER], cfg->portNumber);
+  msg[OFS_CONTROL] = control;
+  msg[OFS_LOG_INTERVAL] = logInterval;
+
+  switch(type)
+  {
+    case PTP_FRAME_FOLLOW_UP:
+      /* 802.1AS Follow_Up information TLV, rate offset and GM changes all zero */
+      putOrgTlv(&msg[OFS_FUP_TLV], 28, 0x01);
+      break;
+    case PTP_FRAME_ANNOUNCE:
+      memcpy(&msg[OFS_ANNOUNCE_GM_ID], cfg->clockIdentity, 8);
+      put16(&msg[OFS_ANNOUNCE_STEPS], 0);
+      ptpFrameSetAnnounceQuality(frame, PTP_FRAME_DEFAULT_PRIORITY, PTP_FRAME_DEFAULT_CLOCK_CLASS,
+                                 PTP_FRAME_DEFAULT_ACCURACY, PTP_FRAME_DEFAULT_VARIANCE,
+                                 PTP_FRAME_DEFAULT_PRIORITY, PTP_FRAME_DEFAULT_TIME_SOURCE);
+      break;
+    case PTP_FRAME_SIGNALING:
+      memset(&msg[OFS_SIGNALING_TARGET], 0xFF, 10);
+      putOrgTlv(&msg[OFS_SIGNALING_TLV], 12, 0x02);
+      ptpFrameSetIntervalRequest(frame, -128, -128, -128);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+void ptpFrameSetSequenceId(ptpFrame_t* frame, uint16_t sequenceId)
+{
+  put16(&ptpMsg(frame)[OFS_SEQUENCE_ID], sequenceId);
+}
+
+void ptpFrameSetTimestamp(ptpFrame_t* frame, uint64_t seconds, uint32_t nanoseconds)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_TIMESTAMP];
+  put16(&p[0], (uint16_t)(seconds >> 32));
+  put32(&p[2], (uint32_t)seconds);
+  put32(&p[6], nanoseconds);
+}
+
+void ptpFrameSetCorrection(ptpFrame_t* frame, int64_t correctionNs)
+{
+  uint64_t scaled = (uint64_t)(correctionNs * 65536);
+  uint8_t* p = &ptpMsg(frame)[OFS_CORRECTION];
+  put32(&p[0], (uint32_t)(scaled >> 32));
+  put32(&p[4], (uint32_t)scaled);
+}
+
+void ptpFrameSetLogInterval(ptpFrame_t* frame, int8_t logMessageInterval)
+{
+  ptpMsg(frame)[OFS_LOG_INTERVAL] = (uint8_t)logMessageInterval;
+}
+
+void ptpFrameSetTwoStep(ptpFrame_t* frame, bool twoStep)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_FLAGS];
+  *p = twoStep ? (uint8_t)(*p | FLAG0_TWO_STEP) : (uint8_t)(*p & ~FLAG0_TWO_STEP);
+}
+
+void ptpFrameSetRequestingPort(ptpFrame_t* frame, const uint8_t clockIdentity[8], uint16_t portNumber)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_REQUESTING_PORT];
+  memcpy(p, clockIdentity, 8);
+  put16(&p[8], portNumber);
+}
+
+void ptpFrameSetAnnounceQuality(ptpFrame_t* frame, uint8_t priority1, uint8_t clockClass, uint8_t clockAccuracy,
+                                uint16_t offsetScaledLogVariance, uint8_t priority2, uint8_t timeSource)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_ANNOUNCE_PRIORITY1];
+  p[0] = priority1;
+  p[1] = clockClass;
+  p[2] = clockAccuracy;
+  put16(&p[3], offsetScaledLogVariance);
+  p[5] = priority2;
+  ptpMsg(frame)[OFS_ANNOUNCE_TIME_SOURCE] = timeSource;
+}
+
+void ptpFrameSetIntervalRequest(ptpFrame_t* frame, int8_t linkDelayInterval, int8_t timeSyncInterval, int8_t announceInterval)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_SIGNALING_INTERVALS];
+  p[0] = (uint8_t)linkDelayInterval;
+  p[1] = (uint8_t)timeSyncInterval;
+  p[2] = (uint8_t)announceInterval;
+}
+
+void ptpFrameSetTimeProperties(ptpFrame_t* frame, int16_t currentUtcOffset, bool utcOffsetValid,
+                               bool timeTraceable, bool frequencyTraceable)
+{
+  uint8_t* msg = ptpMsg(frame);
+  uint8_t flags = msg[OFS_FLAGS + 1] & (uint8_t)~(FLAG1_UTC_OFFSET_VALID | FLAG1_TIME_TRACEABLE | FLAG1_FREQ_TRACEABLE);
+  if (utcOffsetValid) {
+    flags |= FLAG1_UTC_OFFSET_VALID;
+  }
+  if (timeTraceable) {
+    flags |= FLAG1_TIME_TRACEABLE;
+  }
+  if (frequencyTraceable) {
+    flags |= FLAG1_FREQ_TRACEABLE;
+  }
+  msg[OFS_FLAGS + 1] = flags;
+  if (frame->type == PTP_FRAME_ANNOUNCE) {
+    put16(&msg[OFS_ANNOUNCE_UTC_OFFSET], (uint16_t)currentUtcOffset);
+  }
+}
+
+void ptpFrameSetGmTimeBase(ptpFrame_t* frame, uint16_t gmTimeBaseIndicator, int64_t lastGmPhaseChangeNs,
+                           double lastGmFreqChange)
+{
+  uint8_t* p = &ptpMsg(frame)[OFS_FUP_GM_TIME_BASE];
+  /* lastGmPhaseChange is a 96 bit ScaledNs, the upper 16 bit only carry the sign */
+  int64_t scaled = lastGmPhaseChangeNs * 65536;
+  uint16_t signExt = (scaled < 0) ? 0xFFFFu : 0u;
+  int32_t freq = (int32_t)(lastGmFreqChange * 2199023255552.0);   /* 2^41 */
+
+  put16(&p[0], gmTimeBaseIndicator);
+  put16(&p[2], signExt);
+  put32(&p[4], (uint32_t)((uint64_t)scaled >> 32));
+  put32(&p[8], (uint32_t)scaled);
+  put32(&p[14], (uint32_t)freq);
+}
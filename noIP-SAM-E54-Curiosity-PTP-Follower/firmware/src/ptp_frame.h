@@ -0,0 +1,138 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  PTP frame templates
+
+  File Name:
+    ptp_frame.h
+
+  Summary:
+    Prebuilt gPTP frames which are patched in place per transmission
+
+  Description:
+    A template holds the complete Ethernet frame of one PTP message type. It is
+    built once with the port configuration, afterwards only the fields which
+    change per message (sequenceId, timestamp, correctionField, ...) are written
+    straight into the TX-ready buffer. All fields are stored in network order.
+*******************************************************************************/
+
+#ifndef PTP_FRAME_H
+#define	PTP_FRAME_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PTP_FRAME_ETH_HEADER_LEN        14
+#define PTP_FRAME_HEADER_LEN            34
+
+/* Frame lengths including the Ethernet header */
+#define PTP_FRAME_SYNC_LEN              (PTP_FRAME_ETH_HEADER_LEN + 44)
+#define PTP_FRAME_FOLLOW_UP_LEN         (PTP_FRAME_ETH_HEADER_LEN + 76)
+#define PTP_FRAME_PDELAY_LEN            (PTP_FRAME_ETH_HEADER_LEN + 54)
+#define PTP_FRAME_ANNOUNCE_LEN          (PTP_FRAME_ETH_HEADER_LEN + 64)
+#define PTP_FRAME_SIGNALING_LEN         (PTP_FRAME_ETH_HEADER_LEN + 60)
+#define PTP_FRAME_MAX_LEN               PTP_FRAME_FOLLOW_UP_LEN
+
+/* Announce defaults until the clock quality is set by the application */
+#define PTP_FRAME_DEFAULT_PRIORITY      248
+#define PTP_FRAME_DEFAULT_CLOCK_CLASS   248
+#define PTP_FRAME_DEFAULT_ACCURACY      0xFE
+#define PTP_FRAME_DEFAULT_VARIANCE      0x436A
+#define PTP_FRAME_DEFAULT_TIME_SOURCE   0xA0    /* internal oscillator */
+
+typedef enum
+{
+  PTP_FRAME_SYNC              = 0x00,
+  PTP_FRAME_PDELAY_REQ        = 0x02,
+  PTP_FRAME_PDELAY_RESP       = 0x03,
+  PTP_FRAME_FOLLOW_UP         = 0x08,
+  PTP_FRAME_PDELAY_RESP_FUP   = 0x0A,
+  PTP_FRAME_ANNOUNCE          = 0x0B,
+  PTP_FRAME_SIGNALING         = 0x0C
+} ptpFrameType_t;
+
+/* Port configuration which goes into every template */
+typedef struct
+{
+  uint8_t   srcMac[6];
+  uint8_t   clockIdentity[8];
+  uint16_t  portNumber;
+  uint8_t   domainNumber;
+  int8_t    logMessageInterval;
+  bool      twoStep;
+} ptpFrameConfig_t;
+
+typedef struct
+{
+  uint8_t   buf[PTP_FRAME_MAX_LEN];   // handed to the MAC-PHY as is
+  uint16_t  len;
+  ptpFrameType_t type;
+} ptpFrame_t;
+
+/* Builds the complete frame once, all timestamps and the correctionField are zero */
+bool ptpFrameBuild(ptpFrame_t* frame, ptpFrameType_t type, const ptpFrameConfig_t* cfg);
+
+void ptpFrameSetSequenceId(ptpFrame_t* frame, uint16_t sequenceId);
+
+/* originTimestamp, preciseOriginTimestamp, requestReceiptTimestamp or
+ * responseOriginTimestamp, depending on the message type */
+void ptpFrameSetTimestamp(ptpFrame_t* frame, uint64_t seconds, uint32_t nanoseconds);
+
+/* correctionField in ns, stored as scaled ns (2^-16) */
+void ptpFrameSetCorrection(ptpFrame_t* frame, int64_t correctionNs);
+
+void ptpFrameSetLogInterval(ptpFrame_t* frame, int8_t logMessageInterval);
+
+/* Sets or clears the twoStepFlag */
+void ptpFrameSetTwoStep(ptpFrame_t* frame, bool twoStep);
+
+/* Pdelay_Resp / Pdelay_Resp_Follow_Up: port of the Pdelay_Req initiator */
+void ptpFrameSetRequestingPort(ptpFrame_t* frame, const uint8_t clockIdentity[8], uint16_t portNumber);
+
+/* Announce: grandmaster quality as compared by the BMCA */
+void ptpFrameSetAnnounceQuality(ptpFrame_t* frame, uint8_t priority1, uint8_t clockClass, uint8_t clockAccuracy,
+                                uint16_t offsetScaledLogVariance, uint8_t priority2, uint8_t timeSource);
+
+/* Signaling: message interval request TLV, -128 leaves an interval unchanged */
+void ptpFrameSetIntervalRequest(ptpFrame_t* frame, int8_t linkDelayInterval, int8_t timeSyncInterval, int8_t announceInterval);
+
+/* Traceability flags of any message, Announce additionally gets currentUtcOffset */
+void ptpFrameSetTimeProperties(ptpFrame_t* frame, int16_t currentUtcOffset, bool utcOffsetValid,
+                               bool timeTraceable, bool frequencyTraceable);
+
+/* Follow_Up information TLV: time base indicator, last phase change in ns and
+ * last fractional frequency change, updated whenever the GM time base jumps */
+void ptpFrameSetGmTimeBase(ptpFrame_t* frame, uint16_t gmTimeBaseIndicator, int64_t lastGmPhaseChangeNs,
+                           double lastGmFreqChange);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PTP_FRAME_H */
@@ -0,0 +1,301 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Time-aware callback scheduler
+
+  File Name:
+    ptp_sched.c
+
+  Summary:
+    Runs application callbacks at absolute PTP times
+
+  Description:
+    The slots are shared between the main loop and the TC0 interrupt. The main
+    loop masks TC0_IRQn while it changes them, the interrupt owns them
+    otherwise. Periodic slots keep their grid: when the target lies more than
+    a period back (late interrupt, forward step) the missed periods are
+    skipped and counted, never called in a burst.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "definitions.h"
+#include "ptp_sched.h"
+#include "ptp_clock.h"
+#include "ptp_task.h"
+
+#define PTP_LOG printf
+
+#define PTP_SCHED_TICK_HZ       60000000u
+#define PTP_SCHED_MAX_ARM_NS    ((uint64_t)PTP_SCHED_MAX_ARM_MS * 1000000u)
+#define PTP_SCHED_RETRY_NS      ((uint64_t)PTP_SCHED_RETRY_MS * 1000000u)
+
+typedef struct
+{
+  ptpSchedCallback_t cb;
+  void* pTag;
+  uint64_t targetNs;
+  uint32_t periodNs;
+  bool used;
+  ptpSchedStats_t stats;
+} ptpSchedSlot_t;
+
+static ptpSchedSlot_t slots[PTP_SCHED_SLOTS];
+
+static volatile uint32_t wakeups = 0;
+static volatile uint32_t earlyWakeups = 0;
+static volatile uint32_t unalignedWakeups = 0;
+
+/* Earliest used slot, -1 if there is none */
+static int8_t nextSlot(void)
+{
+  int8_t best = -1;
+  uint8_t i;
+  for(i = 0; i < PTP_SCHED_SLOTS; i++)
+  {
+    if(slots[i].used && ((best < 0) || (slots[i].targetNs < slots[best].targetNs)))
+    {
+      best = (int8_t)i;
+    }
+  }
+  return best;
+}
+
+/* Moves a periodic target behind now, the skipped periods are missed */
+static void skipMissed(ptpSchedSlot_t* p, uint64_t now)
+{
+  uint64_t skip;
+  if((p->periodNs != 0u) && (p->targetNs <= now))
+  {
+    skip = ((now - p->targetNs) / p->periodNs) + 1u;
+    p->targetNs += skip * p->periodNs;
+    p->stats.missed += (uint32_t)skip;
+  }
+}
+
+/* Stop and retrigger of the one-shot TC0 go through CTRLB, the TC plib has no call for it */
+static void tcCommand(uint8_t cmd)
+{
+  TC0_REGS->COUNT32.TC_CTRLBSET = cmd;
+  while((TC0_REGS->COUNT32.TC_SYNCBUSY & TC_SYNCBUSY_CTRLB_Msk) == TC_SYNCBUSY_CTRLB_Msk)
+  {
+  }
+}
+
+/* Programs TC0 for the earliest slot, TC0_IRQn must not be active in between */
+static void arm(void)
+{
+  int8_t s = nextSlot();
+  uint64_t now = PTP_GetTimeNow();
+  uint64_t waitNs;
+  uint32_t ticks;
+
+  if(s < 0)
+  {
+    tcCommand(TC_CTRLBSET_CMD_STOP);
+    return;
+  }
+  if(now == 0u)
+  {
+    waitNs = PTP_SCHED_RETRY_NS;
+  }
+  else if((slots[s].targetNs - PTP_SCHED_LEAD_NS) <= now)
+  {
+    waitNs = 0u;
+  }
+  else
+  {
+    waitNs = slots[s].targetNs - PTP_SCHED_LEAD_NS - now;
+    if(waitNs > PTP_SCHED_MAX_ARM_NS) waitNs = PTP_SCHED_MAX_ARM_NS;
+  }
+  ticks = (uint32_t)((waitNs * (PTP_SCHED_TICK_HZ / 1000000u)) / 1000u);
+  if(ticks == 0u) ticks = 1u;
+  TC0_Timer32bitPeriodSet(ticks);
+  tcCommand(TC_CTRLBSET_CMD_RETRIGGER);
+}
+
+static void onTimer(TC_TIMER_STATUS status, uintptr_t context)
+{
+  bool first = true;
+  int8_t s;
+  uint64_t now, target;
+  int64_t jitter;
+  ptpSchedSlot_t* p;
+
+  wakeups++;
+  /* Several slots may be due at once */
+  while((s = nextSlot()) >= 0)
+  {
+    p = &slots[s];
+    now = PTP_GetTimeNow();
+    if(now == 0u)
+    {
+      unalignedWakeups++;
+      break;
+    }
+    if((now + PTP_SCHED_LEAD_NS) < p->targetNs)
+    {
+      /* Split arming or the local clock moved since */
+      if(first) earlyWakeups++;
+      break;
+    }
+    first = false;
+    if(now > p->targetNs)
+    {
+      p->stats.late++;
+    }
+    else
+    {
+      while((now = PTP_GetTimeNow()) < p->targetNs)
+      {
+        if(now == 0u) break;
+      }
+    }
+    target = p->targetNs;
+    jitter = (int64_t)(now - target);
+    if((p->stats.calls == 0u) || (jitter < p->stats.jitterMinNs)) p->stats.jitterMinNs = (int32_t)jitter;
+    if((p->stats.calls == 0u) || (jitter > p->stats.jitterMaxNs)) p->stats.jitterMaxNs = (int32_t)jitter;
+    p->stats.jitterSumNs += jitter;
+    p->stats.calls++;
+
+    if(p->periodNs != 0u)
+    {
+      p->targetNs += p->periodNs;
+      skipMissed(p, now);
+    }
+    else
+    {
+      p->used = false;
+    }
+    p->cb(target, now, p->pTag);
+  }
+  arm();
+}
+
+void ptpSchedInit(void)
+{
+  memset(slots, 0, sizeof(slots));
+  TC0_TimerCallbackRegister(onTimer, 0);
+  TC0_TimerStop();
+  TC0_TimerStart();
+  tcCommand(TC_CTRLBSET_CMD_STOP);
+}
+
+int8_t ptpSchedAdd(uint64_t startNs, uint32_t periodNs, ptpSchedCallback_t cb, void* pTag)
+{
+  int8_t slot = -1;
+  uint8_t i;
+  if(cb == NULL)
+  {
+    return -1;
+  }
+  NVIC_DisableIRQ(TC0_IRQn);
+  for(i = 0; (slot < 0) && (i < PTP_SCHED_SLOTS); i++)
+  {
+    if(!slots[i].used)
+    {
+      memset(&slots[i], 0, sizeof(slots[i]));
+      slots[i].cb = cb;
+      slots[i].pTag = pTag;
+      slots[i].targetNs = startNs;
+      slots[i].periodNs = periodNs;
+      slots[i].used = true;
+      slot = (int8_t)i;
+    }
+  }
+  if(slot >= 0)
+  {
+    arm();
+  }
+  NVIC_EnableIRQ(TC0_IRQn);
+  return slot;
+}
+
+bool ptpSchedRemove(int8_t slot)
+{
+  bool wasUsed;
+  if((slot < 0) || (slot >= (int8_t)PTP_SCHED_SLOTS))
+  {
+    return false;
+  }
+  NVIC_DisableIRQ(TC0_IRQn);
+  wasUsed = slots[slot].used;
+  slots[slot].used = false;
+  arm();
+  NVIC_EnableIRQ(TC0_IRQn);
+  return wasUsed;
+}
+
+bool ptpSchedGetStats(int8_t slot, ptpSchedStats_t* stats)
+{
+  bool used;
+  if((slot < 0) || (slot >= (int8_t)PTP_SCHED_SLOTS))
+  {
+    return false;
+  }
+  NVIC_DisableIRQ(TC0_IRQn);
+  used = slots[slot].used;
+  *stats = slots[slot].stats;
+  NVIC_EnableIRQ(TC0_IRQn);
+  return used;
+}
+
+void ptpSchedOnHwStep(void)
+{
+  uint64_t now = PTP_GetTimeNow();
+  uint8_t i;
+  NVIC_DisableIRQ(TC0_IRQn);
+  if(now != 0u)
+  {
+    /* A forward step must not call the periods it jumped over */
+    for(i = 0; i < PTP_SCHED_SLOTS; i++)
+    {
+      if(slots[i].used)
+      {
+        skipMissed(&slots[i], now);
+      }
+    }
+  }
+  arm();
+  NVIC_EnableIRQ(TC0_IRQn);
+}
+
+void ptpSchedPrintStatus(void)
+{
+  ptpSchedStats_t st;
+  int8_t i;
+  PTP_LOG("Scheduler: wakeups %lu, early %lu, clock not aligned %lu, lead %u ns\r\n",
+          wakeups, earlyWakeups, unalignedWakeups, PTP_SCHED_LEAD_NS);
+  for(i = 0; i < (int8_t)PTP_SCHED_SLOTS; i++)
+  {
+    if(ptpSchedGetStats(i, &st))
+    {
+      PTP_LOG("  slot %d: period %lu ns, calls %lu, late %lu, missed %lu, jitter min %ld max %ld mean %ld ns\r\n",
+              i, slots[i].periodNs, st.calls, st.late, st.missed, st.jitterMinNs, st.jitterMaxNs,
+              (st.calls != 0u) ? (int32_t)(st.jitterSumNs / (int64_t)st.calls) : 0);
+    }
+  }
+}
@@ -0,0 +1,99 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Time-aware callback scheduler
+
+  File Name:
+    ptp_sched.h
+
+  Summary:
+    Runs application callbacks at absolute PTP times
+
+  Description:
+    TC0 (one-shot, 60 MHz) wakes the scheduler PTP_SCHED_LEAD_NS before the
+    earliest due callback. The interrupt then spins on PTP_GetTimeNow() of the
+    cross-timestamped local clock until the PTP time is reached, so the MCU
+    crystal only has to be right over one arming. Armings are limited to
+    PTP_SCHED_MAX_ARM_MS, longer waits are split and re-evaluated, which also
+    picks up servo rate changes. Steps of the node clock re-arm right away.
+
+    Callbacks run in the TC0 interrupt and must be short.
+*******************************************************************************/
+
+#ifndef PTP_SCHED_H
+#define	PTP_SCHED_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of callbacks which can be scheduled at the same time */
+#define PTP_SCHED_SLOTS                 8u
+/* TC0 wakes up this early, covers crystal error and interrupt latency */
+#define PTP_SCHED_LEAD_NS               10000u
+/* Longest single arming, at 200 ppm this drifts 4 us, well inside the lead */
+#define PTP_SCHED_MAX_ARM_MS            20u
+/* Retry period while the local clock is not aligned */
+#define PTP_SCHED_RETRY_MS              10u
+
+/* targetNs is the scheduled PTP time, nowNs the PTP time at the call */
+typedef void (*ptpSchedCallback_t)(uint64_t targetNs, uint64_t nowNs, void* pTag);
+
+typedef struct
+{
+  uint32_t calls;
+  uint32_t late;          /* interrupt came after the target time */
+  uint32_t missed;        /* periods skipped, the target was more than one period ago */
+  int32_t jitterMinNs;    /* call minus target */
+  int32_t jitterMaxNs;
+  int64_t jitterSumNs;
+} ptpSchedStats_t;
+
+/* Starts TC0 */
+void ptpSchedInit(void);
+
+/* Schedules cb at startNs and then every periodNs (0 for a single call).
+ * Returns the slot, -1 if all slots are in use. */
+int8_t ptpSchedAdd(uint64_t startNs, uint32_t periodNs, ptpSchedCallback_t cb, void* pTag);
+
+/* Removes a scheduled callback */
+bool ptpSchedRemove(int8_t slot);
+
+/* Copy of the statistics of a slot, false for an unused slot */
+bool ptpSchedGetStats(int8_t slot, ptpSchedStats_t* stats);
+
+/* The node clock was stepped, the wake-up is recalculated */
+void ptpSchedOnHwStep(void);
+
+void ptpSchedPrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PTP_SCHED_H */
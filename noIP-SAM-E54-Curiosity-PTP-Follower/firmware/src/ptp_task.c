@@ -28,12 +28,20 @@ Microchip or any third party.
 #include <time.h>
 #include <tc6.h>
 #include <tc6-regs.h>
+#include <tc6-events.h>
 #include <math.h>
 #include <stdlib.h>
 #include "ptp_task.h"
 #include "tc6.h"
 #include "tc6-noip.h"
 #include "cmsis_gcc.h"
+#include "ptp_domain.h"
+#include "servo_tune.h"
+#include "temp_comp.h"
+#include "ptp_frame.h"
+#include "pps_phase.h"
+#include "ptp_clock.h"
+#include "ptp_sched.h"
 #define PTP_LOG printf
 #include <filters.h>
 
@@ -51,6 +59,7 @@ volatile uint8_t sendPtpFollowUpFlag = 0u;
 volatile double rateRatio = 1.0;
 volatile double rateRatioIIR = 1.0;
 volatile double rateRatioFIR = 1.0;
+static double clockRatio = 1.0;
 
 volatile double offsetIIR = 0;
 volatile double offsetFIR = 0;
@@ -69,23 +78,98 @@ volatile int64_t offset = 0;
 volatile uint64_t offset_abs = 0;
 volatile uint8_t sendPdelayRespFup = 0;
 
-static double rateRatioValue[FIR_FILER_SIZE] = {0};
+static double rateRatioValue[FIR_FILER_SIZE_MAX] = {0};
 static lpfStateF rateRatiolpfState;
 
-static int32_t offsetValue[FIR_FILER_SIZE_FINE] = {0};
+static int32_t offsetValue[FIR_FILER_SIZE_FINE_MAX] = {0};
 static lpfState offsetState;
 
-static int32_t offsetCoarseValue[FIR_FILER_SIZE_FINE] = {0};
+static int32_t offsetCoarseValue[FIR_FILER_SIZE_FINE_MAX] = {0};
 static lpfState offsetCoarseState;
 long double continiousratio = 1.0;
 
+/* Servo parameters, adapted by servo_tune at run time */
+static uint32_t fineThresholdNs = HARDSYNC_FINE_THRESHOLD;
+static uint32_t coarseThresholdNs = HARDSYNC_COARSE_THRESHOLD;
+static double rateOutlier = PTP_TUNE_OUTLIER_MAX;
+static bool clockStepped = false;
+
 static int32_t diff = 0;
 static int32_t filteredDiff = 0;
 long double corrNs = 0.0;
 long double corrNsFlt = 0.0;
 
+static int64_t syncCorrectionNs = 0;
+static int64_t meanLinkDelay = PTP_MEAN_LINK_DELAY_NS;
+static uint16_t gmTimeBaseIndicator = 0;
+static bool gmTimeBaseValid = false;
+/* Upstream node's rate ratio to the GM (cumulativeScaledRateOffset). This node has
+ * no neighbor rate ratio measurement to put it on top of, so it is reported only */
+static double upstreamRateRatio = 1.0;
+
+static int8_t requestedSyncLogInterval = PTP_LOG_INTERVAL_NO_CHANGE;
+static int8_t gmSyncLogInterval = 0;
+static bool syncIntervalSlow = false;
+static uint32_t fineSyncs = 0;
+static uint32_t syncsSinceRequest = 0;
+static uint16_t signalingSequenceId = 0;
+static volatile bool signalingTxBusy = false;
+static ptpFrame_t signalingFrame;
+static bool signalingFrameValid = false;
+
+static volatile uint32_t ptpNowMs = 0;
+static bool slewActive = false;
+static double slewBias = 0.0;
+static uint32_t slewStartMs = 0;
+static uint32_t slewDurationMs = 0;
+
+static uint32_t lastSyncMs = 0;
+static bool holdover = false;
+static double holdoverScale = 1.0;
+static double lastTempC = 0.0;
+static bool lastTempValid = false;
+/* PPS self-measurement agrees with the Sync offset */
+static bool ppsAgree = true;
+
+static clockIdentity_t gmIdentity;
+static bool gmIdentityValid = false;
+static uint32_t gmSwitchCount = 0;
+static bool gmSwitchPending = false;
+static uint32_t gmSwitchFromMs = 0;
+static uint32_t gmSwitchDetectMs = 0;
+static uint32_t gmSwitchTimeMs = 0;
+static uint32_t gmSwitchSyncs = 0;
+static int64_t gmSwitchInitialNs = 0;
+static int64_t gmSwitchMaxNs = 0;
+
+typedef enum
+{
+  HARDSET_IDLE,
+  HARDSET_READ,
+  HARDSET_WRITE,
+  HARDSET_VERIFY
+} hardSetState_t;
+
+static volatile hardSetState_t hardSetState = HARDSET_IDLE;
+static uint64_t hardSetOrigin = 0;
+static uint64_t hardSetReceipt = 0;
+static uint64_t hardSetTarget = 0;
+static uint32_t hardSetFirstNs = 0;
+static int64_t hardSetLatencyNs = PTP_HARD_SET_LATENCY_NS;
+static int64_t hardSetResidualNs = 0;
+static bool hardSetCheck = false;
+
 void processSync(syncMsg_t* ptpPkt);
 void processFollowUp(followUpMsg_t* ptpPkt);
+static bool processFollowUpTlv(followUpMsg_t* ptpPkt);
+static void processOneStepSync(syncMsg_t* ptpPkt);
+static void processSyncPair(void);
+static void slewStart(double offsetNs, double maxPpm);
+static void updateSyncInterval(void);
+static void setClockIncrement(double ratio, double bias);
+static void feedForwardRate(double change);
+static bool hardSetStart(uint64_t t1, uint64_t t2);
+static bool switchToStandby(const char* reason);
 void regCallBack(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
 
 void resetSlaveNode() {
@@ -97,16 +181,20 @@ void resetSlaveNode() {
     ptpSynced = 0;
     syncStatus = UNINIT;
     runs = 0;
+    gmTimeBaseValid = false;
+    gmIdentityValid = false;
+    holdover = false;
     
     memset(&TS_SYNC, 0, sizeof(ptpSync_ct));
     
-    for(uint32_t x = 0; x < FIR_FILER_SIZE_FINE; x++) {
+    for(uint32_t x = 0; x < offsetState.filterSize; x++) {
         firLowPassFilter(0, &offsetCoarseState);
         firLowPassFilter(0, &offsetState);
     }
-    for(uint32_t x = 0; x < FIR_FILER_SIZE; x++) {
+    for(uint32_t x = 0; x < rateRatiolpfState.filterSize; x++) {
         firLowPassFilterF(1.0, &rateRatiolpfState);
     }
+    servoTuneReset();
     
     ptpTask();
     
@@ -120,9 +208,10 @@ static uint64_t BSWAP64(uint64_t rawValue)
   return ( ((uint64_t)__REV(low)) << 32u ) | ( (uint64_t)__REV(high) );
 }
 
-static int64_t getCorrectionField(ptpHeader_t* hdr)
+int64_t getCorrectionField(ptpHeader_t* hdr)
 {
-  return BSWAP64(hdr->correctionField) >> 16;
+  /* correctionField is in ns scaled by 2^16, keep the sign */
+  return ((int64_t)BSWAP64((uint64_t)hdr->correctionField)) >> 16;
 }
 
 uint64_t tsToInternal(const timeStamp_t* ts)
@@ -131,21 +220,489 @@ uint64_t tsToInternal(const timeStamp_t* ts)
   return (seconds * SEC_IN_NS) + ts->nanoseconds;
 }
 
+/* Origin time as seen at our ingress: t1 + correction (Sync + FollowUp) + link delay */
+static uint64_t originToInternal(const timeStamp_t* ts)
+{
+  return tsToInternal(ts) + (int64_t)ts->correctionField + meanLinkDelay;
+}
+
+uint8_t ptpGetSyncStatus(void)
+{
+  return syncStatus;
+}
+
+/* Steps the hardware clock by MAC_TA, subtract is the MAC_TA sign bit */
+static void adjustClock(uint8_t subtract, uint32_t ns)
+{
+  TC6_WriteRegister(macPhy, MAC_TA, ((uint32_t)(subtract & 1u) << 31) | ns, true, 0, 0);
+  TC6_Service(macPhy, true);
+  ptpDomainOnHwStep(subtract ? -(int64_t)ns : (int64_t)ns);
+  ppsPhaseOnHwStep(subtract ? -(int64_t)ns : (int64_t)ns);
+  ptpClockOnHwStep(subtract ? -(int64_t)ns : (int64_t)ns);
+  ptpSchedOnHwStep();
+  TC6Events_OnClockStep(macPhy);
+  clockStepped = true;
+}
+
+/* Applies a parameter set chosen by servo_tune */
+static void applyServoParams(const servoParams_t* p)
+{
+  if(p->rateFilterSize != rateRatiolpfState.filterSize)
+  {
+    lpfResizeF(&rateRatiolpfState, p->rateFilterSize, rateRatioFIR);
+  }
+  if(p->offsetFilterSize != offsetState.filterSize)
+  {
+    lpfResize(&offsetState, p->offsetFilterSize);
+    lpfResize(&offsetCoarseState, p->offsetFilterSize);
+  }
+  fineThresholdNs = p->fineThresholdNs;
+  coarseThresholdNs = p->coarseThresholdNs;
+  rateOutlier = p->rateOutlier;
+  PTP_LOG("Servo tuned: rate filter %lu, offset filter %lu, fine %lu ns, coarse %lu ns, outlier %.1f ppm\r\n",
+          p->rateFilterSize, p->offsetFilterSize, p->fineThresholdNs, p->coarseThresholdNs, p->rateOutlier * 1e6);
+}
+
+/* Full time for a MAC_TN value, the seconds are taken from the nearest match to ref */
+static uint64_t hardSetResolve(uint64_t ref, uint32_t ns)
+{
+  uint64_t t = (ref - (ref % SEC_IN_NS)) + ns;
+  
+  if(t > (ref + (SEC_IN_NS / 2u)))
+  {
+    t -= SEC_IN_NS;
+  }
+  else if((t + (SEC_IN_NS / 2u)) < ref)
+  {
+    t += SEC_IN_NS;
+  }
+  return t;
+}
+
+static void hardSetFailed(void)
+{
+  hardSetState = HARDSET_IDLE;
+  hardResync = 1;
+}
+
+static void onHardSetVerify(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+  if(!success)
+  {
+    PTP_LOG("Hard set read back failed\r\n");
+    hardSetFailed();
+    return;
+  }
+  /* The read back samples one control transaction after the write landed */
+  uint64_t expected = hardSetTarget + (uint64_t)hardSetLatencyNs;
+  hardSetResidualNs = (int64_t)(hardSetResolve(expected, value) - expected);
+  if(llabs(hardSetResidualNs) > PTP_HARD_SET_VERIFY_LIMIT_NS)
+  {
+    PTP_LOG("Hard set missed by %lld ns, repeating\r\n", hardSetResidualNs);
+    hardSetFailed();
+    return;
+  }
+  hardSetCheck = true;
+  hardSetState = HARDSET_IDLE;
+}
+
+static void onHardSetWritten(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+  if(!success || !TC6_ReadRegister(pInst, MAC_TN, true, onHardSetVerify, NULL))
+  {
+    PTP_LOG("Hard set write failed\r\n");
+    hardSetFailed();
+    return;
+  }
+  hardSetState = HARDSET_VERIFY;
+}
+
+static void onHardSetRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+  uint32_t vals[2];
+  
+  if(!success)
+  {
+    hardSetFailed();
+    return;
+  }
+  if(pTag == NULL)
+  {
+    /* First sample, the second read follows right behind to measure the latency */
+    hardSetFirstNs = value;
+    if(!TC6_ReadRegister(pInst, MAC_TN, true, onHardSetRead, &hardSetFirstNs))
+    {
+      hardSetFailed();
+    }
+    return;
+  }
+  
+  int64_t latency = (int64_t)value - (int64_t)hardSetFirstNs;
+  if(latency < 0) latency += SEC_IN_NS;
+  if(latency < PTP_HARD_SET_VERIFY_LIMIT_NS)
+  {
+    hardSetLatencyNs = (hardSetLatencyNs + latency) / 2;
+  }
+  
+  /* The clock ran less than a second since the Sync receipt, so t2 gives the seconds */
+  uint64_t local = hardSetResolve(hardSetReceipt, value);
+  hardSetTarget = hardSetOrigin + (local - hardSetReceipt) + (uint64_t)hardSetLatencyNs;
+  vals[0] = (uint32_t)(hardSetTarget / SEC_IN_NS);
+  vals[1] = (uint32_t)(hardSetTarget % SEC_IN_NS);
+  
+  if(!TC6_WriteRegisters(pInst, MAC_TSL, vals, 2u, true, onHardSetWritten, NULL))
+  {
+    hardSetFailed();
+    return;
+  }
+  ptpDomainOnHwStep((int64_t)(hardSetTarget - (local + (uint64_t)hardSetLatencyNs)));
+  ppsPhaseOnHwStep((int64_t)(hardSetTarget - (local + (uint64_t)hardSetLatencyNs)));
+  ptpClockOnHwStep((int64_t)(hardSetTarget - (local + (uint64_t)hardSetLatencyNs)));
+  ptpSchedOnHwStep();
+  /* Enqueued behind the burst write, so the event generators see the new time */
+  TC6Events_OnClockStep(pInst);
+  hardSetState = HARDSET_WRITE;
+}
+
+/* Sets the hardware clock to the origin time of the Sync received at local time t2.
+ * Read MAC_TN -> burst write MAC_TSL/MAC_TN -> read back MAC_TN, all chained from the callbacks. */
+static bool hardSetStart(uint64_t t1, uint64_t t2)
+{
+  if(hardSetState != HARDSET_IDLE)
+  {
+    return false;
+  }
+  hardSetOrigin = t1;
+  hardSetReceipt = t2;
+  hardSetState = HARDSET_READ;
+  if(!TC6_ReadRegister(macPhy, MAC_TN, true, onHardSetRead, NULL))
+  {
+    hardSetState = HARDSET_IDLE;
+    return false;
+  }
+  return true;
+}
+
+/* ratio is the GM/oscillator rate ratio, bias a temporary slew on top of it */
+static void setClockIncrement(double ratio, double bias)
+{
+  static double appliedInc = CLOCK_CYCLE_NS;
+  double applied;
+  double calcInc = CLOCK_CYCLE_NS * ratio * (1.0 + bias);
+  
+  clockRatio = ratio;
+  
+  uint8_t mac_ti = (uint8_t)calcInc; 
+  double calcSubInc = calcInc - (double)mac_ti;
+  calcSubInc *= 16777216.0;
+  uint32_t calcSubInc_uint = (uint32_t)calcSubInc;
+  calcSubInc_uint = ((calcSubInc_uint >> 8) & 0xFFFF) | ((calcSubInc_uint & 0xFF) << 24);
+  
+  TC6_WriteRegister(macPhy, MAC_TISUBN, calcSubInc_uint, true, 0, 0);
+  TC6_Service(macPhy, true);
+  TC6_WriteRegister(macPhy, MAC_TI, (uint32_t)mac_ti, true, 0, 0);
+  TC6_Service(macPhy, true);
+  
+  /* The local clock follows the increment actually written, including the truncation */
+  applied = (double)mac_ti + (double)(uint32_t)calcSubInc / 16777216.0;
+  ptpClockOnRateChange(applied / appliedInc);
+  appliedInc = applied;
+  if(prr) PTP_LOG("MAC_TI %li\r\n",(uint32_t)mac_ti );
+  if(prr) PTP_LOG("MAC_TISUBN %li\r\n",(uint32_t)calcSubInc_uint );
+}
+
+/* Applies a known rate change right away, the FIR history is moved along with it */
+static void feedForwardRate(double change)
+{
+  for(uint32_t x = 0; x < rateRatiolpfState.filterSize; x++)
+  {
+    rateRatioValue[x] *= (1.0 + change);
+  }
+  rateRatioFIR *= (1.0 + change);
+  setClockIncrement(rateRatioFIR, slewActive ? slewBias : 0.0);
+}
+
+/* Removes a phase offset by running the clock slightly fast or slow, the time
+ * stays monotonic. ptpService() restores the nominal increment once the slew time is over. */
+static void slewStart(double offsetNs, double maxPpm)
+{
+  uint32_t intervalMs = (gmSyncLogInterval < 0) ? (SEC_IN_MS >> -gmSyncLogInterval) : (SEC_IN_MS << gmSyncLogInterval);
+  uint32_t durationMs = intervalMs / 2u;
+  double maxBias = maxPpm * 1e-6;
+  double neededMs = fabs(offsetNs) / (maxBias * 1e6);
+  
+  if(durationMs < PTP_FINE_PHASE_SLEW_MIN_MS) durationMs = PTP_FINE_PHASE_SLEW_MIN_MS;
+  if(durationMs > PTP_FINE_PHASE_SLEW_MAX_MS) durationMs = PTP_FINE_PHASE_SLEW_MAX_MS;
+  /* Large offsets need longer than the Sync interval at the maximum rate */
+  if(neededMs > (double)durationMs) durationMs = (uint32_t)ceil(neededMs);
+  
+  /* Positive offset: local clock is ahead, run slower */
+  slewBias = -offsetNs / ((double)durationMs * 1e6);
+  if(slewBias > maxBias) slewBias = maxBias;
+  if(slewBias < -maxBias) slewBias = -maxBias;
+  
+  setClockIncrement(rateRatioFIR, slewBias);
+  slewStartMs = ptpNowMs;
+  slewDurationMs = durationMs;
+  slewActive = true;
+}
+
+/* Hands the hardware clock over to the best converged standby GM. The rate
+ * continues at the standby's rate, its phase difference is slewed out. */
+static bool switchToStandby(const char* reason)
+{
+  ptpStandby_t sb;
+  
+  if(!gmIdentityValid || (syncStatus < HARDSYNC) || !ptpDomainGetStandby(PTP_HW_DOMAIN, gmIdentity, ptpNowMs, &sb))
+  {
+    return false;
+  }
+  PTP_LOG("GM switchover (%s) to %02X%02X%02X.%02X%02X.%02X%02X%02X, phase %lld ns\r\n", reason,
+          sb.clockIdentity[0], sb.clockIdentity[1], sb.clockIdentity[2], sb.clockIdentity[3],
+          sb.clockIdentity[4], sb.clockIdentity[5], sb.clockIdentity[6], sb.clockIdentity[7], -sb.offsetNs);
+  memcpy(gmIdentity, sb.clockIdentity, sizeof(clockIdentity_t));
+  ptpDomainDrop(PTP_HW_DOMAIN, sb.clockIdentity);
+  
+  /* Sequence matching and rate history belong to the old GM */
+  ptp_sync_sequenceId = -1;
+  syncReceived = 0;
+  memset(&TS_SYNC, 0, sizeof(ptpSync_ct));
+  diffLocal = 0;
+  diffRemote = 0;
+  gmTimeBaseValid = false;
+  servoTuneReset();
+  for(uint32_t x = 0; x < offsetState.filterSize; x++)
+  {
+    (void) firLowPassFilter(0, &offsetCoarseState);
+    (void) firLowPassFilter(0, &offsetState);
+    offsetCoarseState.filled = 0;
+    offsetState.filled = 0;
+  }
+  
+  /* Standby rate is relative to the hardware clock, the servo works on the oscillator */
+  rateRatioFIR = sb.rateRatio * clockRatio;
+  lpfResizeF(&rateRatiolpfState, rateRatiolpfState.filterSize, rateRatioFIR);
+  gmSwitchInitialNs = -sb.offsetNs;
+  if(llabs(gmSwitchInitialNs) <= PTP_STEP_LIMIT_NS)
+  {
+    slewStart((double)gmSwitchInitialNs, PTP_SLEW_MAX_PPM);
+  }
+  else
+  {
+    slewActive = false;
+    setClockIncrement(rateRatioFIR, 0.0);
+  }
+  if(syncStatus > HARDSYNC) syncStatus = HARDSYNC;
+  holdover = false;
+  
+  gmSwitchCount++;
+  gmSwitchPending = true;
+  gmSwitchFromMs = lastSyncMs;
+  gmSwitchDetectMs = ptpNowMs - lastSyncMs;
+  gmSwitchSyncs = 0;
+  gmSwitchMaxNs = 0;
+  lastSyncMs = ptpNowMs;
+  return true;
+}
+
+static void tempCompensate(void)
+{
+  double degC, now, last;
+  
+  if(!tempCompGetReading(&degC))
+  {
+    return;
+  }
+  /* Learn only while the PPS phase does not contradict the offset */
+  if((syncStatus == FINE) && !holdover && ppsAgree)
+  {
+    tempCompLearn(degC, rateRatioFIR);
+  }
+  if(holdover)
+  {
+    /* Free running: the model alone steers the increment */
+    if(tempCompPredict(degC, &now))
+    {
+      setClockIncrement(now * holdoverScale, 0.0);
+    }
+  }
+  else if((syncStatus >= COARSE) && lastTempValid && tempCompPredict(degC, &now) && tempCompPredict(lastTempC, &last))
+  {
+    double change = (now / last) - 1.0;
+    if(fabs(change) > PTP_TEMPCOMP_MIN_CHANGE)
+    {
+      feedForwardRate(change);
+    }
+  }
+  lastTempC = degC;
+  lastTempValid = true;
+}
+
+void ptpService(uint32_t nowMs)
+{
+  ptpNowMs = nowMs;
+  if(!holdover && (syncStatus >= HARDSYNC) && ((nowMs - lastSyncMs) > PTP_GM_LOSS_TIMEOUT_MS))
+  {
+    (void) switchToStandby("primary lost");
+  }
+  if(!holdover && (syncStatus >= HARDSYNC) && ((nowMs - lastSyncMs) > PTP_HOLDOVER_TIMEOUT_MS))
+  {
+    double model;
+    /* Anchor the model to the last locked rate */
+    holdoverScale = (lastTempValid && tempCompPredict(lastTempC, &model)) ? (rateRatioFIR / model) : 1.0;
+    holdover = true;
+    slewActive = false;
+    setClockIncrement(rateRatioFIR, 0.0);
+    PTP_LOG("No Sync for %lu ms, holdover\r\n", (nowMs - lastSyncMs));
+  }
+  tempCompensate();
+  if(slewActive && ((nowMs - slewStartMs) >= slewDurationMs))
+  {
+    slewActive = false;
+    setClockIncrement(rateRatioFIR, 0.0);
+    if(prr) PTP_LOG("Slewed %.1f ns in %lu ms\r\n", slewBias * (double)(nowMs - slewStartMs) * 1e6, (nowMs - slewStartMs));
+  }
+}
+
+/* Evaluates the 802.1AS FollowUp information TLV. Returns true if the GM time base changed. */
+static bool processFollowUpTlv(followUpMsg_t* ptpPkt)
+{
+  bool timeBaseChanged = false;
+  
+  if((htons(ptpPkt->header.messageLength) < sizeof(followUpMsg_t)) || (htons(ptpPkt->tlv.tlvType) != 0x0003u))
+  {
+    return false;
+  }
+  
+  upstreamRateRatio = 1.0 + ((double)(int32_t)htonl((uint32_t)ptpPkt->tlv.cumulativescaledRateOffset) / PTP_RATE_OFFSET_SCALE);
+  
+  uint16_t timeBase = htons(ptpPkt->tlv.gmTimeBaseIndicator);
+  if(gmTimeBaseValid && (timeBase != gmTimeBaseIndicator))
+  {
+    double freqChange = (double)(int32_t)htonl((uint32_t)ptpPkt->tlv.scaledLastGmFreqChange) / PTP_RATE_OFFSET_SCALE;
+    PTP_LOG("GM time base changed: %hu -> %hu\r\n", gmTimeBaseIndicator, timeBase);
+    
+    /* Feed forward the announced GM frequency change instead of waiting for the FIR */
+    if((freqChange != 0.0) && (syncStatus > UNINIT))
+    {
+      feedForwardRate(freqChange);
+    }
+    timeBaseChanged = true;
+  }
+  gmTimeBaseIndicator = timeBase;
+  gmTimeBaseValid = true;
+  
+  return timeBaseChanged;
+}
+
+static void onSignalingSent(void *pDummy, const uint8_t *pTx, uint16_t len, uint32_t idx, void *pDummy2)
+{
+  signalingTxBusy = false;
+}
+
+static bool sendSyncIntervalRequest(int8_t logInterval)
+{
+  if(signalingTxBusy)
+  {
+    return false;
+  }
+  /* Built on first use, the MAC address is not known before */
+  if(!signalingFrameValid)
+  {
+    ptpFrameConfig_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    (void)TC6NoIP_GetMacAddress(0, cfg.srcMac);
+    /* EUI-64 clock identity out of the MAC address */
+    memcpy(&cfg.clockIdentity[0], &cfg.srcMac[0], 3);
+    cfg.clockIdentity[3] = 0xFF;
+    cfg.clockIdentity[4] = 0xFE;
+    memcpy(&cfg.clockIdentity[5], &cfg.srcMac[3], 3);
+    cfg.portNumber = 1;
+    signalingFrameValid = ptpFrameBuild(&signalingFrame, PTP_FRAME_SIGNALING, &cfg);
+  }
+  ptpFrameSetSequenceId(&signalingFrame, signalingSequenceId);
+  ptpFrameSetIntervalRequest(&signalingFrame, PTP_LOG_INTERVAL_NO_CHANGE, logInterval, PTP_LOG_INTERVAL_NO_CHANGE);
+  
+  signalingTxBusy = true;
+  if(!TC6NoIP_SendEthernetPacket(0, signalingFrame.buf, signalingFrame.len, onSignalingSent))
+  {
+    signalingTxBusy = false;
+    return false;
+  }
+  signalingSequenceId++;
+  return true;
+}
+
+/* Fast Sync rate until the servo is stable in FINE, back off afterwards */
+static void updateSyncInterval(void)
+{
+  int8_t desired;
+  uint32_t refresh;
+  
+  if(syncStatus == FINE)
+  {
+    if(fineSyncs < PTP_FINE_STABLE_SYNCS) fineSyncs++;
+  }
+  else
+  {
+    fineSyncs = 0;
+  }
+  if(fineSyncs >= PTP_FINE_STABLE_SYNCS)
+  {
+    syncIntervalSlow = true;
+  }
+  else if(syncStatus < COARSE)
+  {
+    syncIntervalSlow = false;
+  }
+  desired = syncIntervalSlow ? PTP_SYNC_LOG_INTERVAL_SLOW : PTP_SYNC_LOG_INTERVAL_FAST;
+  
+  /* Repeat the request, the GM forgets requests which are not refreshed */
+  refresh = (gmSyncLogInterval < 0) ? (PTP_SIGNALING_REFRESH_S << -gmSyncLogInterval) : PTP_SIGNALING_REFRESH_S;
+  if(gmSyncLogInterval > requestedSyncLogInterval)
+  {
+    /* Request got lost, the GM may run faster for other followers though */
+    refresh = 8;
+  }
+  syncsSinceRequest++;
+  
+  if((desired != requestedSyncLogInterval) || (syncsSinceRequest >= refresh))
+  {
+    if(sendSyncIntervalRequest(desired))
+    {
+      if(desired != requestedSyncLogInterval)
+      {
+        PTP_LOG("Requesting Sync interval 2^%d s\r\n", desired);
+      }
+      requestedSyncLogInterval = desired;
+      syncsSinceRequest = 0;
+    }
+  }
+}
+
 void processSync(syncMsg_t* ptpPkt)
 {
   uint16_t seqId = htons(ptpPkt->header.sequenceID);
   
+  bool oneStep = !(ptpPkt->header.flags[0] & PTP_FLAG_TWO_STEP);
+  
+  syncCorrectionNs = getCorrectionField( &ptpPkt->header );
+  
   if(ptp_sync_sequenceId < 0)
   {
     ptp_sync_sequenceId = seqId;
-    syncReceived = 0;
+    /* No FollowUp follows a one-step Sync, it completes the pair by itself */
+    syncReceived = oneStep ? 1 : 0;
   }
   else
   {
         int sequenceDifference = abs(seqId - ptp_sync_sequenceId);
         if (sequenceDifference > 10) {  // Adjust threshold based on acceptable range
             PTP_LOG("Large sequence mismatch detected: %hu - %ld. Resetting sync...\r\n", seqId, ptp_sync_sequenceId);
-            resetSlaveNode();
+            if(!switchToStandby("sequence reset"))
+            {
+                resetSlaveNode();
+            }
         } else if (ptp_sync_sequenceId == seqId) {
             syncReceived = 1;
         } else {
@@ -187,14 +744,93 @@ void processFollowUp(followUpMsg_t* ptpPkt)
   TS_SYNC.origin.secondsMsb  = htons( ptpPkt->preciseOriginTimestamp.secondsMsb  );
   TS_SYNC.origin.secondsLsb  = htonl( ptpPkt->preciseOriginTimestamp.secondsLsb  );
   TS_SYNC.origin.nanoseconds = htonl( ptpPkt->preciseOriginTimestamp.nanoseconds );
-  TS_SYNC.origin.correctionField = getCorrectionField( &ptpPkt->header ) >> 16;
+  TS_SYNC.origin.correctionField = (uint64_t)(getCorrectionField( &ptpPkt->header ) + syncCorrectionNs);
+  corrNs = (long double)(int64_t)TS_SYNC.origin.correctionField;
+  
+  if(processFollowUpTlv(ptpPkt))
+  {
+    if(switchToStandby("time base change"))
+    {
+      return;
+    }
+    /* Do not mix samples of the old and the new time base: restart the
+     * rate measurement and the offset filters, next offset is applied directly */
+    memset(&TS_SYNC.origin_prev, 0, sizeof(timeStamp_t));
+    memset(&TS_SYNC.receipt_prev, 0, sizeof(timeStamp_t));
+    diffLocal = 0;
+    diffRemote = 0;
+    for(uint32_t x=0; x<offsetState.filterSize ; x++)
+    {
+        (void) firLowPassFilter(0, &offsetCoarseState);
+        (void) firLowPassFilter(0, &offsetState);
+        offsetCoarseState.filled = 0;
+        offsetState.filled = 0;
+    }
+    servoTuneReset();
+    if(syncStatus > HARDSYNC) syncStatus = HARDSYNC;
+  }
+  
+  processSyncPair();
+}
+
+/* One-step Sync: the originTimestamp is already the departure time, no FollowUp follows */
+static void processOneStepSync(syncMsg_t* ptpPkt)
+{
+  macPhy = get_macPhy_inst();
+  if(!syncReceived)
+  {
+    return;
+  }
+  ptp_sync_sequenceId = (ptp_sync_sequenceId + 1u) % UINT16_MAX;
+  syncReceived = 0;
+  
+  TS_SYNC.origin.secondsMsb  = htons( ptpPkt->originTimestamp.secondsMsb  );
+  TS_SYNC.origin.secondsLsb  = htonl( ptpPkt->originTimestamp.secondsLsb  );
+  TS_SYNC.origin.nanoseconds = htonl( ptpPkt->originTimestamp.nanoseconds );
+  TS_SYNC.origin.correctionField = (uint64_t)syncCorrectionNs;
+  corrNs = (long double)syncCorrectionNs;
+  
+  processSyncPair();
+}
+
+static void processSyncPair(void)
+{
+  /* Convert to internal time format */
+  uint64_t t1 = originToInternal(&TS_SYNC.origin);
+  uint64_t t2 = tsToInternal(&TS_SYNC.receipt);
+  
+#if PTP_CAPTURE_EMULATION
+  TC6Events_CaptureInject(macPhy, PTP_EVENT_CAPTURE_INPUT, t2);
+#endif
+  lastSyncMs = ptpNowMs;
+  if(holdover)
+  {
+    holdover = false;
+    setClockIncrement(rateRatioFIR, 0.0);
+    PTP_LOG("Sync is back, holdover ended\r\n");
+  }
     
+  if(hardSetState != HARDSET_IDLE)
+  {
+    /* Receipt time was taken before the clock got stepped */
+    printf("!");
+    return;
+  }
+  
   if(hardResync)
   {
-    TC6_WriteRegister(macPhy, MAC_TSL, TS_SYNC.origin.secondsLsb, true, 0, 0);
-    TC6_WriteRegister(macPhy, MAC_TN, TS_SYNC.origin.nanoseconds, true, 0, 0);
     PTP_LOG("Large offset, doing hard sync\r\n");
-    hardResync = 0;
+    if(hardSetStart(t1, t2))
+    {
+      hardResync = 0;
+      /* Neither this Sync nor the previous one can be used for the rate across the step */
+      memset(&TS_SYNC.receipt, 0, sizeof(timeStamp_t));
+      memset(&TS_SYNC.receipt_prev, 0, sizeof(timeStamp_t));
+      memset(&TS_SYNC.origin_prev, 0, sizeof(timeStamp_t));
+      diffLocal = 0;
+      diffRemote = 0;
+      return;
+    }
   }
   
   if(ptpSynced && !wallClockSet )
@@ -208,10 +844,6 @@ void processFollowUp(followUpMsg_t* ptpPkt)
       wallClockSet = true;
   }
   
-  /* Convert to internal time format */
-  uint64_t t1 = tsToInternal(&TS_SYNC.origin);
-  uint64_t t2 = tsToInternal(&TS_SYNC.receipt);
-  
   if(TS_SYNC.receipt_prev.secondsLsb != 0)
   {
     uint64_t curr = t2;
@@ -222,7 +854,7 @@ void processFollowUp(followUpMsg_t* ptpPkt)
   if(TS_SYNC.origin_prev.secondsLsb != 0)
   {
     uint64_t curr = t1;
-    uint64_t prev = tsToInternal(&TS_SYNC.origin_prev);
+    uint64_t prev = originToInternal(&TS_SYNC.origin_prev);
     diffRemote = curr - prev;
   }
 
@@ -234,11 +866,24 @@ void processFollowUp(followUpMsg_t* ptpPkt)
   {
     if(syncStatus == UNINIT || syncStatus > HARDSYNC) 
     {
-    rateRatio = (double)diffRemote / (double)diffLocal; //lowPassExponential( (double)diffRemote / (double)diffLocal, rateRatio, 0.8f);
-      if((rateRatio > 0.998 && rateRatio < 1.002)) 
+    /* diffLocal is counted with the corrected increment, scale back to the oscillator */
+    rateRatio = clockRatio * (double)diffRemote / (double)diffLocal; //lowPassExponential( (double)diffRemote / (double)diffLocal, rateRatio, 0.8f);
+      /* Until the rate is measured the window is the widest one around the nominal rate */
+      double center = (syncStatus == UNINIT) ? 1.0 : rateRatioFIR;
+      double window = (syncStatus == UNINIT) ? PTP_TUNE_OUTLIER_MAX : rateOutlier;
+      if((rateRatio > (center - window)) && (rateRatio < (center + window))) 
       {
-        rateRatioIIR = lowPassExponential( (double)diffRemote / (double)diffLocal, rateRatio, 0.5f);
-        rateRatioFIR = firLowPassFilterF( (double)diffRemote / (double)diffLocal, &rateRatiolpfState );
+        rateRatioIIR = lowPassExponential( rateRatio, rateRatioIIR, 0.5f);
+        rateRatioFIR = firLowPassFilterF( rateRatio, &rateRatiolpfState );
+        if((syncStatus > HARDSYNC) && !clockStepped)
+        {
+          servoParams_t params;
+          servoTuneAddSample(rateRatio, diffRemote);
+          if(servoTuneUpdate(&params))
+          {
+            applyServoParams(&params);
+          }
+        }
       }
       else {
         PTP_LOG("Filtered rateRatio outlier\r\n");
@@ -248,33 +893,43 @@ void processFollowUp(followUpMsg_t* ptpPkt)
   }
   else
   {
+    clockStepped = false;
     printf("!");
     return;
   }
   
+  clockStepped = false;
   offset = t2 - t1;
+  ppsPhaseOnSync(t2, t1);
   uint8_t neg = 1;
   if(offset < 0) neg = 0;
   offset_abs = llabs(offset);
   
+  if(gmSwitchPending)
+  {
+    if(gmSwitchSyncs == 0)
+    {
+      gmSwitchTimeMs = ptpNowMs - gmSwitchFromMs;
+    }
+    if(llabs(offset) > llabs(gmSwitchMaxNs)) gmSwitchMaxNs = offset;
+    if(++gmSwitchSyncs >= PTP_GM_SWITCH_REPORT_SYNCS)
+    {
+      gmSwitchPending = false;
+      ptpPrintGmStatus();
+    }
+  }
+  
+  if(hardSetCheck)
+  {
+    PTP_LOG("Offset after hard set: %lld ns (read back %lld ns, latency %lld ns)\r\n", offset, hardSetResidualNs, hardSetLatencyNs);
+    hardSetCheck = false;
+  }
+  
   if(syncStatus == UNINIT)
   {
-    if(runs >= (FIR_FILER_SIZE*1))
+    if(runs >= rateRatiolpfState.filterSize)
     {
-      double calcInc = CLOCK_CYCLE_NS * rateRatioFIR;
-      
-      uint8_t mac_ti = (uint8_t)calcInc; 
-      double calcSubInc = calcInc - (double)mac_ti;
-      calcSubInc *= 16777216.0;
-      uint32_t calcSubInc_uint = (uint32_t)calcSubInc;
-      calcSubInc_uint = ((calcSubInc_uint >> 8) & 0xFFFF) | ((calcSubInc_uint & 0xFF) << 24);
-      
-      TC6_WriteRegister(macPhy, MAC_TISUBN, calcSubInc_uint, true, 0, 0);
-      TC6_Service(macPhy, true);
-      TC6_WriteRegister(macPhy, MAC_TI, (uint32_t)mac_ti, true, 0, 0);
-      TC6_Service(macPhy, true);
-      if(prr) PTP_LOG("MAC_TI %li\r\n",(uint32_t)mac_ti );
-      if(prr) PTP_LOG("MAC_TISUBN %li\r\n",(uint32_t)calcSubInc_uint );
+      setClockIncrement(rateRatioFIR, 0.0);
       
       if(syncStatus == UNINIT) syncStatus = MATCHFREQ;
       ptpSynced = 1;
@@ -294,41 +949,48 @@ void processFollowUp(followUpMsg_t* ptpPkt)
   {
     if(offset_abs > HARDSYNC_RESET_THRESHOLD)
     {
-        syncStatus == UNINIT;
-        for(uint32_t x=0; x<FIR_FILER_SIZE_FINE ; x++)
+        if(switchToStandby("offset out of range"))
+        {
+          return;
+        }
+        syncStatus = UNINIT;
+        for(uint32_t x=0; x<offsetState.filterSize ; x++)
         {
             (void) firLowPassFilter(0, &offsetCoarseState);
             (void) firLowPassFilter(0, &offsetState);
         }
-        for(uint32_t x=0; x<FIR_FILER_SIZE ; x++)
+        for(uint32_t x=0; x<rateRatiolpfState.filterSize ; x++)
         {
             (void) firLowPassFilterF( 1.0 , &rateRatiolpfState );
         }
         runs=0;
     }
-    else if(offset_abs > HARDSYNC_THRESHOLD) 
+    else if(offset_abs > PTP_STEP_LIMIT_NS) 
     {
-      offset_abs = HARDSYNC_THRESHOLD;
-      TC6_WriteRegister(macPhy, MAC_TA, ((neg & 1) << 31) | offset_abs, true, 0, 0);
-      TC6_Service(macPhy, true);
+      if(offset_abs > HARDSYNC_THRESHOLD) offset_abs = HARDSYNC_THRESHOLD;
+      adjustClock(neg, offset_abs);
       syncStatus = HARDSYNC;
     }
-    else if(offset_abs > HARDSYNC_COARSE_THRESHOLD)
+    else if(offset_abs > coarseThresholdNs)
     {
-      for(uint32_t x=0; x<FIR_FILER_SIZE_FINE ; x++)
+      for(uint32_t x=0; x<offsetState.filterSize ; x++)
       {
             (void) firLowPassFilter(0, &offsetCoarseState);
             (void) firLowPassFilter(0, &offsetState);
             offsetCoarseState.filled = 0;
             offsetState.filled = 0;
       }
-      TC6_WriteRegister(macPhy, MAC_TA, ((neg & 1) << 31) | offset_abs, true, 0, 0);
-      TC6_Service(macPhy, true);
+#if PTP_SLEW_MODE
+      slewStart((double)offset, PTP_SLEW_MAX_PPM);
+      if(prr) PTP_LOG("Offset:%lld, slewing at %.1f ppm for %lu ms\r\n", offset, slewBias * 1e6, slewDurationMs);
+#else
+      adjustClock(neg, offset_abs);
+#endif
       syncStatus = HARDSYNC;
     }
-    else if(offset_abs > HARDSYNC_FINE_THRESHOLD)
+    else if(offset_abs > fineThresholdNs)
     {
-      for(uint32_t x=0; x<FIR_FILER_SIZE_FINE ; x++)
+      for(uint32_t x=0; x<offsetState.filterSize ; x++)
       {
             (void) firLowPassFilter(0, &offsetState);
             offsetState.filled = 0;
@@ -339,24 +1001,33 @@ void processFollowUp(followUpMsg_t* ptpPkt)
       write_val = (int32_t) offsetFIR;
       if(!neg) write_val = write_val*(-1);
 
-      TC6_WriteRegister(macPhy, MAC_TA, (((neg & 1) << 31) | ((uint32_t)write_val)), true, 0, 0);
-      TC6_Service(macPhy, true);
+#if PTP_SLEW_MODE
+      slewStart(offsetFIR, PTP_SLEW_MAX_PPM);
+#else
+      adjustClock(neg, (uint32_t)write_val);
+#endif
       syncStatus = COARSE;
       if(prr) PTP_LOG("Offset:%lld,  Pos: %i, Offset Coarse: %li\r\n", offset, neg, ((uint32_t)write_val));
     }
     else
     {
       offsetFIR = firLowPassFilter(offset, &offsetState);
-      neg = (offsetFIR < 0) ? 0 : 1;
-      int32_t write_val = 0;
-      write_val = (int32_t) offsetFIR;
-      if(!neg) write_val = write_val*(-1);
-
-      TC6_WriteRegister(macPhy, MAC_TA, (((neg & 1) << 31) | ((uint32_t)write_val)), true, 0, 0);
-      TC6_Service(macPhy, true);
+      slewStart(offsetFIR, PTP_FINE_PHASE_MAX_PPM);
       
       syncStatus = FINE;
-      if(prr) PTP_LOG("Offset:%lld,  Pos: %i, Offset Fine: %li\r\n", offset, neg, ((uint32_t)write_val));
+      ppsAgree = ppsPhaseCrossCheck(offsetFIR);
+      if(prr)
+      {
+        double ppsNs;
+        if(ppsPhaseGet(&ppsNs))
+        {
+          PTP_LOG("Offset:%lld, Offset Fine: %.1f, bias %.3f ppm, PPS phase: %.0f\r\n", offset, offsetFIR, slewBias * 1e6, ppsNs);
+        }
+        else
+        {
+          PTP_LOG("Offset:%lld, Offset Fine: %.1f, bias %.3f ppm\r\n", offset, offsetFIR, slewBias * 1e6);
+        }
+      }
     }
   }
 }
@@ -370,8 +1041,31 @@ void handlePtp(uint8_t* pData, uint32_t size, uint32_t sec, uint32_t nsec)
   
   uint8_t messageType = ptpPkt->tsmt & 0xFu;
   
+  if(!gmIdentityValid && (ptpPkt->domainNumber == PTP_HW_DOMAIN) && (messageType == MSG_SYNC))
+  {
+    memcpy(gmIdentity, ptpPkt->sourcePortIdentity.clockIdentity, sizeof(clockIdentity_t));
+    gmIdentityValid = true;
+  }
+  /* Other domains and standby GMs are tracked in software */
+  if((ptpPkt->domainNumber != PTP_HW_DOMAIN) || !gmIdentityValid ||
+     (0 != memcmp(gmIdentity, ptpPkt->sourcePortIdentity.clockIdentity, sizeof(clockIdentity_t))))
+  {
+    ptpDomainHandlePtp(ptpPkt, ((uint64_t)sec * SEC_IN_NS) + nsec, ptpNowMs);
+    return;
+  }
+  
   if(messageType == MSG_FOLLOW_UP)
   {
+    if(syncReceived)
+    {
+      /* FollowUp after Sync, the PTP frame latency reported with the TX gate statistics */
+      uint64_t t2 = tsToInternal(&TS_SYNC.receipt);
+      uint64_t now = PTP_GetTimeNow();
+      if((now > t2) && ((now - t2) < SEC_IN_NS))
+      {
+        TC6NoIP_TxGateAddPtpLatency(0, (uint32_t)(now - t2));
+      }
+    }
     processFollowUp((followUpMsg_t*)ptpPkt);
   }    
   else if(messageType == MSG_SYNC)
@@ -382,13 +1076,95 @@ void handlePtp(uint8_t* pData, uint32_t size, uint32_t sec, uint32_t nsec)
           TS_SYNC.receipt_prev = TS_SYNC.receipt;
           TS_SYNC.receipt.secondsLsb = sec;
           TS_SYNC.receipt.nanoseconds = nsec;
+          if(!(ptpPkt->flags[0] & PTP_FLAG_TWO_STEP))
+          {
+              processOneStepSync((syncMsg_t*)ptpPkt);
+          }
+      }
+      gmSyncLogInterval = (int8_t)ptpPkt->logMessageInterval;
+      updateSyncInterval();
+      if((gmSyncLogInterval >= -9) && (gmSyncLogInterval <= 2))
+      {
+        uint32_t periodNs = (uint32_t)((gmSyncLogInterval < 0) ? (SEC_IN_NS >> -gmSyncLogInterval) : (SEC_IN_NS << gmSyncLogInterval));
+        TC6NoIP_TxGateSetWindow(0, PTP_TX_GATE_WINDOW_SYNC, ((uint64_t)sec * SEC_IN_NS) + nsec, periodNs);
       }
   }
 }
 
 
+void ptpPrintGmStatus(void)
+{
+  if(gmIdentityValid)
+  {
+    PTP_LOG("Primary GM %02X%02X%02X.%02X%02X.%02X%02X%02X, state %u\r\n",
+            gmIdentity[0], gmIdentity[1], gmIdentity[2], gmIdentity[3],
+            gmIdentity[4], gmIdentity[5], gmIdentity[6], gmIdentity[7], syncStatus);
+    PTP_LOG("  rate ratio %.9f measured, upstream %.9f, link delay %lld ns (configured)\r\n",
+            rateRatioFIR, upstreamRateRatio, meanLinkDelay);
+  }
+  if(gmSwitchCount > 0)
+  {
+    PTP_LOG("GM switchovers: %lu, last: detected after %lu ms, first Sync after %lu ms\r\n",
+            gmSwitchCount, gmSwitchDetectMs, gmSwitchTimeMs);
+    PTP_LOG("  phase transient: %lld ns at switchover, max %lld ns over %lu Syncs\r\n",
+            gmSwitchInitialNs, gmSwitchMaxNs, gmSwitchSyncs);
+  }
+}
+
+static void onEventOutputPulse(TC6_t *pInst, uint8_t eg, bool success, void *pTag)
+{
+  if(!success)
+  {
+    PTP_LOG("EG%u pulse train lost, restart with 'e'\r\n", eg);
+  }
+}
+
+/* Starts or stops a 1 Hz pulse train on EG0 (DIOA0), rising edge on the full PTP second */
+void ptpEventOutputToggle(void)
+{
+  uint64_t now = tsToInternal(&TS_SYNC.receipt);
+  TC6Events_EgState_t state = TC6Events_GetEgState(macPhy, PTP_EVENT_OUTPUT_EG, NULL);
+  
+  if((state == TC6Events_EgState_Running) || (state == TC6Events_EgState_Pending))
+  {
+    if(TC6Events_EgStop(macPhy, PTP_EVENT_OUTPUT_EG))
+    {
+      PTP_LOG("EG%u pulse train stopped\r\n", PTP_EVENT_OUTPUT_EG);
+    }
+    return;
+  }
+  if(now == 0u)
+  {
+    PTP_LOG("No Sync received yet, EG%u not started\r\n", PTP_EVENT_OUTPUT_EG);
+    return;
+  }
+  /* Two seconds ahead leaves plenty of time for the register writes */
+  if(TC6Events_EgPeriodic(macPhy, PTP_EVENT_OUTPUT_EG, (now / SEC_IN_NS) + 2u, 0u, PTP_EVENT_OUTPUT_WIDTH_NS,
+                          (uint32_t)SEC_IN_NS, true, onEventOutputPulse, NULL))
+  {
+    PTP_LOG("EG%u pulse train starts at %llu s\r\n", PTP_EVENT_OUTPUT_EG, (now / SEC_IN_NS) + 2u);
+  }
+}
+
+/* Prints the buffered edges of the capture input and the capture counters */
+void ptpEventCapturePrint(void)
+{
+  TC6Events_Capture_t cap;
+  TC6Events_CaptureStats_t stats;
+  
+  while(TC6Events_CaptureGet(macPhy, &cap))
+  {
+    PTP_LOG("Capture DIOA%u: %llu.%09llu\r\n", cap.input + 1u, cap.timestampNs / SEC_IN_NS, cap.timestampNs % SEC_IN_NS);
+  }
+  if(TC6Events_GetCaptureStats(macPhy, &stats))
+  {
+    PTP_LOG("Captures: %lu, lost in MAC-PHY: %lu, ring overruns: %lu\r\n", stats.captures, stats.hwOverruns, stats.ringOverruns);
+  }
+}
+
 void ptpTask(void)
 {
+    servoParams_t params;
     macPhy = get_macPhy_inst();
     
     while (!TC6_WriteRegister(macPhy, PPSCTL, 0x00000002u, true, 0, 0)) {
@@ -399,14 +1175,26 @@ void ptpTask(void)
       TC6_Service(macPhy, true);
     }    
     
+    while (!TC6Events_Init(macPhy)) {
+      TC6_Service(macPhy, true);
+    }
+    
+    while (!TC6Events_CaptureEnable(macPhy, PTP_EVENT_CAPTURE_INPUT, TC6Events_Edge_Rising, NULL, NULL)) {
+      TC6_Service(macPhy, true);
+    }
+    
     memset(&TS_SYNC, 0, sizeof(TS_SYNC)); 
     ptpMode = PTP_SLAVE;
     
+    servoTuneGetParams(&params);
     rateRatiolpfState.buffer = &rateRatioValue[0];
-    rateRatiolpfState.filterSize = sizeof(rateRatioValue) / sizeof(rateRatioValue[0]);
+    rateRatiolpfState.filterSize = params.rateFilterSize;
     
     offsetState.buffer = &offsetValue[0];
-    offsetState.filterSize = sizeof(offsetValue) / sizeof(offsetValue[0]);
+    offsetState.filterSize = params.offsetFilterSize;
     offsetCoarseState.buffer = &offsetCoarseValue[0];
-    offsetCoarseState.filterSize = sizeof(offsetCoarseValue) / sizeof(offsetCoarseValue[0]);
+    offsetCoarseState.filterSize = params.offsetFilterSize;
+    fineThresholdNs = params.fineThresholdNs;
+    coarseThresholdNs = params.coarseThresholdNs;
+    rateOutlier = params.rateOutlier;
 }
\ No newline at end of file
@@ -130,6 +130,14 @@ Microchip or any third party.
 #define COARSE 3
 #define FINE 4
 
+#define PTP_EVENT_OUTPUT_EG 0u               // EG0 is routed to DIOA0 by PADCTRL
+#define PTP_EVENT_OUTPUT_WIDTH_NS 100000000u // 100 ms pulse on the full second
+#define PTP_EVENT_CAPTURE_INPUT 0u           // Capture input 0 is DIOA1
+/* Capture emulation: every Sync receipt is injected as an edge on the capture
+ * input, so the capture path can be checked against the 'p' output without a
+ * signal source. */
+#define PTP_CAPTURE_EMULATION 0
+
 /// Minimum 8ms, Maximum 16000ms
 #define PTP_SYNC_INTERVAL 500u
 #define PTP_SYNC_INTERVAL_LOG ((uint8_t)(-1))	// 2^-1 = 0.5sec
@@ -182,6 +190,63 @@ Microchip or any third party.
 #define HARDSYNC_COARSE_THRESHOLD       90
 #define HARDSYNC_FINE_THRESHOLD         50
 
+/* 802.1AS message interval request, intervals are log2 of the interval in seconds */
+#define PTP_LOG_INTERVAL_NO_CHANGE      (-128)
+#define PTP_LOG_INTERVAL_INITIAL        (126)
+#define PTP_LOG_INTERVAL_STOP           (127)
+#define PTP_SYNC_LOG_INTERVAL_FAST      (-4)    // 16/s while locking
+#define PTP_SYNC_LOG_INTERVAL_SLOW      (-1)    // 2/s once FINE is stable
+#define PTP_FINE_STABLE_SYNCS           32
+#define PTP_SIGNALING_REFRESH_S         10
+
+/* TX gate: bulk data is held off PRE ahead of and POST after the expected
+ * Sync arrival, so it does not delay the Sync and FollowUp of the GM on the
+ * shared medium. The grid is taken from the Sync receipt timestamps. */
+#define PTP_TX_GATE_WINDOW_SYNC         0u
+#define PTP_TX_GATE_PRE_NS              1500000u
+#define PTP_TX_GATE_POST_NS             1000000u
+
+/* Fine phase engine: offsets below HARDSYNC_FINE_THRESHOLD are slewed out by
+ * biasing MAC_TI/MAC_TISUBN for half a Sync interval instead of using MAC_TA */
+#define PTP_FINE_PHASE_SLEW_MIN_MS      10
+#define PTP_FINE_PHASE_SLEW_MAX_MS      250
+#define PTP_FINE_PHASE_MAX_PPM          10.0
+
+/* Slew mode: offsets up to PTP_STEP_LIMIT_NS are removed by the same frequency
+ * bias at up to PTP_SLEW_MAX_PPM, so PPS and event generators never jump.
+ * Larger offsets and the initial lock (MATCHFREQ) still step the clock. */
+#define PTP_SLEW_MODE                   1
+#define PTP_SLEW_MAX_PPM                200.0
+#if PTP_SLEW_MODE
+#define PTP_STEP_LIMIT_NS               1000000
+#else
+#define PTP_STEP_LIMIT_NS               HARDSYNC_THRESHOLD
+#endif
+
+/* No Sync for this long while locked: holdover on the temperature model */
+#define PTP_HOLDOVER_TIMEOUT_MS         3000
+/* Smallest predicted rate change applied as temperature feed-forward */
+#define PTP_TEMPCOMP_MIN_CHANGE         1e-9
+
+/* Syncs after a GM switchover over which the phase transient is reported */
+#define PTP_GM_SWITCH_REPORT_SYNCS      16
+
+/* Hard set: MAC_TSL/MAC_TN are written in one SPI burst. The latency between
+ * two back-to-back control transactions is measured and added to the target,
+ * a read back beyond the verify limit (e.g. a missed second) repeats the set */
+#define PTP_HARD_SET_LATENCY_NS         50000   // start value until measured
+#define PTP_HARD_SET_VERIFY_LIMIT_NS    1000000
+
+/* Mean link delay between GM and this node, subtracted from every offset.
+ * It is not measured (no Pdelay on this node): set it per installation from
+ * the segment length and the PHY latencies, e.g. -DPTP_MEAN_LINK_DELAY_NS=250 */
+#ifndef PTP_MEAN_LINK_DELAY_NS
+#define PTP_MEAN_LINK_DELAY_NS          0
+#endif
+
+/* cumulativeScaledRateOffset and scaledLastGmFreqChange are scaled by 2^41 */
+#define PTP_RATE_OFFSET_SCALE           2199023255552.0
+
 typedef enum
 {
 	PTP_DISABLED,
@@ -198,9 +263,13 @@ typedef enum
   MSG_FOLLOW_UP         = 0x08,
   MSG_DELAY_RESP        = 0x09,
   MSG_PDELAY_RESP_FUP   = 0x0A,
-  MSG_ANNOUNCE          = 0x0B
+  MSG_ANNOUNCE          = 0x0B,
+  MSG_SIGNALING         = 0x0C
 } ptpMsgType_t;
 
+/* flags[0] of the PTP header */
+#define PTP_FLAG_TWO_STEP               0x02u
+
 typedef struct
 {
   uint16_t              secondsMsb;		// Some embedded HW implementations only
@@ -252,10 +321,10 @@ typedef struct
   uint16_t              lengthField;
   uint8_t               organizationId[3];
   uint8_t               organizationSubType[3];
-  uint32_t              cumulativescaledRateOffset;
+  int32_t               cumulativescaledRateOffset;
   uint16_t              gmTimeBaseIndicator;
   uint8_t               lastGmPhaseChange[12];
-  uint32_t              scaledLastGmFreqChange;
+  int32_t               scaledLastGmFreqChange;
 } tlv_followUp_t;
 
 typedef struct
@@ -322,6 +391,26 @@ typedef struct
   ptpTimeStamp_t        responseOriginTimestamp;
   portIdentity_t        requestingPortIdentity;
 } pdelayRespFollowUpMsg_t;
+
+typedef struct
+{
+  uint16_t              tlvType;
+  uint16_t              lengthField;
+  uint8_t               organizationId[3];
+  uint8_t               organizationSubType[3];
+  int8_t                linkDelayInterval;
+  int8_t                timeSyncInterval;
+  int8_t                announceInterval;
+  uint8_t               flags;
+  uint8_t               reserved[2];
+} tlv_msgIntervalReq_t;
+
+typedef struct
+{
+  ptpHeader_t           header;
+  portIdentity_t        targetPortIdentity;
+  tlv_msgIntervalReq_t  tlv;
+} signalingMsg_t;
 #pragma pack()
 
 typedef struct
@@ -350,8 +439,14 @@ pdelayRespMsg_t* preparePtpPathDelayResponse(uint8_t* msgBuffer);
 pdelayRespFollowUpMsg_t* preparePtpPathDelayResponseFollowUp(uint8_t* msgBuffer);
 
 void ptpTask(void);
+void ptpService(uint32_t nowMs);
 void resetSync();
 uint64_t tsToInternal(const timeStamp_t* ts);
+int64_t getCorrectionField(ptpHeader_t* hdr);
+uint8_t ptpGetSyncStatus(void);
+void ptpPrintGmStatus(void);
+void ptpEventOutputToggle(void);
+void ptpEventCapturePrint(void);
 
 void handlePtp(uint8_t* pData, uint32_t size, uint32_t sec, uint32_t nsec);
 
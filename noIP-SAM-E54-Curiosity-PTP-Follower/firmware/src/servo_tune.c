@@ -0,0 +1,257 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Servo self-tuning
+
+  File Name:
+    servo_tune.c
+
+  Summary:
+    Online Allan / time deviation estimator choosing the servo filter parameters
+
+  Description:
+    The phase record is kept as a ring of cumulative phase sums S(n), so both
+    the phase x(n) = S(n) - S(n-1) and the mean phase over m samples
+    (S(n) - S(n-m)) / m are available for every octave without extra buffers.
+      ADEV^2(m tau0) = < (x(n) - 2x(n-m) + x(n-2m))^2 > / (2 (m tau0)^2)
+      TDEV^2(m tau0) = < (A(n) - 2A(n-m) + A(n-2m))^2 > / 6
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "servo_tune.h"
+#include "ptp_task.h"
+#include <filters.h>
+
+#define PTP_LOG printf
+
+#define TUNE_MAX_M      (1u << (PTP_TUNE_OCTAVES - 1u))
+#define TUNE_HISTORY    ((3u * TUNE_MAX_M) + 2u)
+
+static double cumPhase[TUNE_HISTORY];
+static uint32_t head = 0;
+static uint32_t count = 0;
+static double phase = 0.0;
+static double yRef = 0.0;
+static double tau0Ns = 0.0;
+
+static double adevSum[PTP_TUNE_OCTAVES];
+static double tdevSum[PTP_TUNE_OCTAVES];
+static uint32_t adevCnt[PTP_TUNE_OCTAVES];
+static uint32_t tdevCnt[PTP_TUNE_OCTAVES];
+static uint32_t windowSamples = 0;
+
+/* Result of the last evaluation */
+static double adev[PTP_TUNE_OCTAVES];
+static double tdev[PTP_TUNE_OCTAVES];
+static double evalTau0Ns = 0.0;
+static uint32_t evaluations = 0;
+static uint32_t rateOctave = 0;
+static uint32_t offsetOctave = 0;
+static servoParams_t params = {FIR_FILER_SIZE, FIR_FILER_SIZE_FINE, HARDSYNC_FINE_THRESHOLD, HARDSYNC_COARSE_THRESHOLD, PTP_TUNE_OUTLIER_MAX};
+static bool paramsChanged = false;
+
+static double sumAt(uint32_t lag)
+{
+  return cumPhase[(head + TUNE_HISTORY - lag) % TUNE_HISTORY];
+}
+
+static void clearAccumulators(void)
+{
+  memset(adevSum, 0, sizeof(adevSum));
+  memset(tdevSum, 0, sizeof(tdevSum));
+  memset(adevCnt, 0, sizeof(adevCnt));
+  memset(tdevCnt, 0, sizeof(tdevCnt));
+  windowSamples = 0;
+}
+
+void servoTuneReset(void)
+{
+  memset(cumPhase, 0, sizeof(cumPhase));
+  head = 0;
+  count = 0;
+  phase = 0.0;
+  tau0Ns = 0.0;
+  clearAccumulators();
+}
+
+static void evaluate(void)
+{
+  servoParams_t p = params;
+  bool rateFound = false;
+  bool offsetFound = false;
+  
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    double tau = (double)(1u << o) * tau0Ns;
+    adev[o] = (adevCnt[o] >= PTP_TUNE_MIN_COUNT) ? (sqrt(adevSum[o] / (2.0 * adevCnt[o])) / tau) : 0.0;
+    tdev[o] = (tdevCnt[o] >= PTP_TUNE_MIN_COUNT) ? sqrt(tdevSum[o] / (6.0 * tdevCnt[o])) : 0.0;
+  }
+  evalTau0Ns = tau0Ns;
+  evaluations++;
+  
+  /* Rate is averaged over the filter length, the best length sits at the ADEV minimum */
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    uint32_t m = 1u << o;
+    if((m < PTP_TUNE_MIN_RATE_FILTER) || (m > FIR_FILER_SIZE_MAX) || (adev[o] == 0.0)) continue;
+    if(!rateFound || (adev[o] < adev[rateOctave]))
+    {
+      rateOctave = o;
+      rateFound = true;
+    }
+  }
+  /* Offset averaging helps as long as the time deviation still drops */
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    if(((1u << o) > FIR_FILER_SIZE_FINE_MAX) || (tdev[o] == 0.0)) continue;
+    if(!offsetFound || (tdev[o] < tdev[offsetOctave]))
+    {
+      offsetOctave = o;
+      offsetFound = true;
+    }
+  }
+  if(!rateFound || !offsetFound || (adev[0] == 0.0))
+  {
+    return;
+  }
+  
+  /* Only move to another length if it is clearly better, the estimates are noisy */
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    if(((1u << o) == params.rateFilterSize) && (adev[o] != 0.0) && (adev[rateOctave] > (PTP_TUNE_HYSTERESIS * adev[o])))
+    {
+      rateOctave = o;
+    }
+    if(((1u << o) == params.offsetFilterSize) && (tdev[o] != 0.0) && (tdev[offsetOctave] > (PTP_TUNE_HYSTERESIS * tdev[o])))
+    {
+      offsetOctave = o;
+    }
+  }
+  p.rateFilterSize = 1u << rateOctave;
+  p.offsetFilterSize = 1u << offsetOctave;
+  
+  double fine = PTP_TUNE_FINE_NOISE_FACTOR * tdev[0];
+  if(fine < HARDSYNC_FINE_THRESHOLD) fine = HARDSYNC_FINE_THRESHOLD;
+  if(fine > PTP_TUNE_FINE_MAX_NS) fine = PTP_TUNE_FINE_MAX_NS;
+  p.fineThresholdNs = (uint32_t)fine;
+  p.coarseThresholdNs = (p.fineThresholdNs * HARDSYNC_COARSE_THRESHOLD) / HARDSYNC_FINE_THRESHOLD;
+  
+  p.rateOutlier = PTP_TUNE_OUTLIER_FACTOR * adev[0];
+  if(p.rateOutlier < PTP_TUNE_OUTLIER_MIN) p.rateOutlier = PTP_TUNE_OUTLIER_MIN;
+  if(p.rateOutlier > PTP_TUNE_OUTLIER_MAX) p.rateOutlier = PTP_TUNE_OUTLIER_MAX;
+  
+  if((p.rateFilterSize != params.rateFilterSize) || (p.offsetFilterSize != params.offsetFilterSize) ||
+     (fabs((double)p.fineThresholdNs - (double)params.fineThresholdNs) > ((1.0 - PTP_TUNE_HYSTERESIS) * params.fineThresholdNs)) ||
+     (fabs(p.rateOutlier - params.rateOutlier) > ((1.0 - PTP_TUNE_HYSTERESIS) * params.rateOutlier)))
+  {
+    params = p;
+    paramsChanged = true;
+  }
+}
+
+void servoTuneAddSample(double rateRatio, uint64_t intervalNs)
+{
+  double y;
+  
+  /* The octaves are multiples of the Sync interval, a new interval starts a new record */
+  if((count == 0) || (fabs((double)intervalNs - tau0Ns) > (0.1 * tau0Ns)))
+  {
+    servoTuneReset();
+    tau0Ns = (double)intervalNs;
+    yRef = rateRatio - 1.0;
+  }
+  
+  /* Removing a constant frequency keeps the phase small, second differences do not see it */
+  y = (rateRatio - 1.0) - yRef;
+  phase += y * (double)intervalNs;
+  head = (head + 1u) % TUNE_HISTORY;
+  cumPhase[head] = sumAt(1) + phase;
+  count++;
+  
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    uint32_t m = 1u << o;
+    if(count > ((2u * m) + 1u))
+    {
+      double x0 = sumAt(0) - sumAt(1);
+      double x1 = sumAt(m) - sumAt(m + 1u);
+      double x2 = sumAt(2u * m) - sumAt((2u * m) + 1u);
+      double d = x0 - (2.0 * x1) + x2;
+      adevSum[o] += d * d;
+      adevCnt[o]++;
+    }
+    if(count > (3u * m))
+    {
+      double a0 = (sumAt(0) - sumAt(m)) / m;
+      double a1 = (sumAt(m) - sumAt(2u * m)) / m;
+      double a2 = (sumAt(2u * m) - sumAt(3u * m)) / m;
+      double d = a0 - (2.0 * a1) + a2;
+      tdevSum[o] += d * d;
+      tdevCnt[o]++;
+    }
+  }
+  
+  if(++windowSamples >= PTP_TUNE_WINDOW)
+  {
+    evaluate();
+    clearAccumulators();
+  }
+}
+
+bool servoTuneUpdate(servoParams_t* p)
+{
+  if(!paramsChanged)
+  {
+    return false;
+  }
+  *p = params;
+  paramsChanged = false;
+  return true;
+}
+
+void servoTuneGetParams(servoParams_t* p)
+{
+  *p = params;
+}
+
+void servoTunePrintStatus(void)
+{
+  PTP_LOG("Servo tuning: %lu evaluations, tau0 %.1f ms, %lu samples pending\r\n", evaluations, evalTau0Ns / 1e6, windowSamples);
+  if(evaluations == 0)
+  {
+    return;
+  }
+  PTP_LOG("  tau[ms]    ADEV[ppb]   TDEV[ns]\r\n");
+  for(uint32_t o = 0; o < PTP_TUNE_OCTAVES; o++)
+  {
+    PTP_LOG("  %8.1f  %10.3f  %9.2f\r\n", (double)(1u << o) * evalTau0Ns / 1e6, adev[o] * 1e9, tdev[o]);
+  }
+  PTP_LOG("  rate filter %lu: ADEV minimum %.3f ppb at %.1f ms\r\n", params.rateFilterSize, adev[rateOctave] * 1e9, (double)(1u << rateOctave) * evalTau0Ns / 1e6);
+  PTP_LOG("  offset filter %lu: TDEV minimum %.2f ns at %.1f ms\r\n", params.offsetFilterSize, tdev[offsetOctave], (double)(1u << offsetOctave) * evalTau0Ns / 1e6);
+  PTP_LOG("  fine/coarse threshold %lu/%lu ns: %.1f x measurement noise %.2f ns\r\n", params.fineThresholdNs, params.coarseThresholdNs, PTP_TUNE_FINE_NOISE_FACTOR, tdev[0]);
+  PTP_LOG("  rate outlier +-%.1f ppm: %.1f x ADEV(tau0)\r\n", params.rateOutlier * 1e6, PTP_TUNE_OUTLIER_FACTOR);
+}
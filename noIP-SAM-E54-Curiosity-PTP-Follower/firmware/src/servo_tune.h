@@ -0,0 +1,98 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Servo self-tuning
+
+  File Name:
+    servo_tune.h
+
+  Summary:
+    Online Allan / time deviation estimator choosing the servo filter parameters
+
+  Description:
+    The oscillator/GM rate ratio of every Sync interval is integrated to a phase
+    record. Overlapping Allan deviation (oscillator stability) and time deviation
+    (measurement noise) are accumulated for octaves of the Sync interval and
+    evaluated every PTP_TUNE_WINDOW samples. The rate filter length is placed on
+    the Allan deviation minimum, the offset filter length on the time deviation
+    minimum and the FINE/COARSE thresholds and rate outlier window follow the noise.
+*******************************************************************************/
+
+#ifndef SERVO_TUNE_H
+#define	SERVO_TUNE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Averaging times tau0, 2 tau0 ... 64 tau0 */
+#define PTP_TUNE_OCTAVES                7
+/* Rate samples per evaluation */
+#define PTP_TUNE_WINDOW                 256
+/* Estimates based on fewer samples are not used */
+#define PTP_TUNE_MIN_COUNT              16
+#define PTP_TUNE_MIN_RATE_FILTER        4
+/* A new choice has to beat the current one by this factor */
+#define PTP_TUNE_HYSTERESIS             0.8
+/* FINE threshold in multiples of the measurement noise */
+#define PTP_TUNE_FINE_NOISE_FACTOR      4.0
+#define PTP_TUNE_FINE_MAX_NS            400
+/* Rate outlier window in multiples of ADEV(tau0) */
+#define PTP_TUNE_OUTLIER_FACTOR         10.0
+#define PTP_TUNE_OUTLIER_MIN            20e-6
+#define PTP_TUNE_OUTLIER_MAX            0.002
+
+typedef struct
+{
+  uint32_t rateFilterSize;
+  uint32_t offsetFilterSize;
+  uint32_t fineThresholdNs;
+  uint32_t coarseThresholdNs;
+  double   rateOutlier;
+} servoParams_t;
+
+/* Drops the phase record, e.g. after the Sync interval or the GM changed */
+void servoTuneReset(void);
+
+/* Adds the oscillator/GM rate ratio measured over intervalNs. Only samples
+ * without a clock step inside the interval may be passed. */
+void servoTuneAddSample(double rateRatio, uint64_t intervalNs);
+
+/* Returns true and fills params once an evaluation chose a different parameter set */
+bool servoTuneUpdate(servoParams_t* params);
+
+/* Current parameter set, the defaults until the first evaluation */
+void servoTuneGetParams(servoParams_t* params);
+
+void servoTunePrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SERVO_TUNE_H */
@@ -48,6 +48,8 @@ Microchip or any third party.
 #include "tc6-stub.h"
 #include "tc6-noip.h"
 #include "ptp_task.h"
+#include "pd_exchange.h"
+#include "media_clock.h"
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                          USER ADJUSTABLE                             */
@@ -70,6 +72,23 @@ Microchip or any third party.
 #define ESC_YELLOW                  "\033[1;33m"
 #define ESC_BLUE                    "\033[0;36m"
 
+typedef struct
+{
+    uint64_t anchorNs;
+    uint32_t periodNs;
+} TxGateWindow_t;
+
+typedef struct
+{
+    TC6NoIP_GetTimeNs_t getTime;
+    TxGateWindow_t windows[TC6NOIP_TX_GATE_WINDOWS];
+    TC6NoIP_TxGateStats_t stats[2];     /* [0] gate open, [1] gate active */
+    uint32_t sinceMs;
+    uint32_t preNs;
+    uint32_t postNs;
+    bool enabled;
+} TxGate_t;
+
 typedef struct
 {
     uint8_t ethRxBuf[1516];
@@ -77,6 +96,7 @@ typedef struct
     TC6_t *tc6;
     struct pbuf *pbuf;
     TC6NoIP_On_PlcaStatus pStatusCallback;
+    TxGate_t gate;
     uint16_t rxLen;
     bool rxInvalid;
 } TC6Lib_t;
@@ -100,6 +120,7 @@ static uint8_t ethRxBuf[1024];
 
 static void PrintRateLimited(const char *statement, ...);
 static void OnPlcaStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
+static bool TxGateClosed(TxGate_t *pg, bool *pNoTime);
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                         PUBLIC FUNCTIONS                             */
@@ -211,6 +232,106 @@ bool TC6NoIP_GetMacAddress(int8_t idx, uint8_t mac[6])
     return success;
 }
 
+bool TC6NoIP_TxGateSetup(int8_t idx, TC6NoIP_GetTimeNs_t getTime, uint32_t preNs, uint32_t postNs)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        pg->getTime = getTime;
+        pg->preNs = preNs;
+        pg->postNs = postNs;
+        pg->sinceMs = TC6Stub_GetTick();
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateSetWindow(int8_t idx, uint8_t window, uint64_t anchorNs, uint32_t periodNs)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (window < TC6NOIP_TX_GATE_WINDOWS)) {
+        TxGateWindow_t *pw = &mlw[idx].tc.gate.windows[window];
+        pw->anchorNs = anchorNs;
+        pw->periodNs = periodNs;
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateEnable(int8_t idx, bool enable)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        uint32_t now = TC6Stub_GetTick();
+        pg->stats[pg->enabled ? 1 : 0].ms += now - pg->sinceMs;
+        pg->sinceMs = now;
+        pg->enabled = enable;
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateIsEnabled(int8_t idx)
+{
+    bool enabled = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        enabled = mlw[idx].tc.gate.enabled;
+    }
+    return enabled;
+}
+
+bool TC6NoIP_SendBulkEthernetPacket(int8_t idx, const uint8_t *pTx, uint16_t len, TC6NoIP_OnTxCallback_t txCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        TC6NoIP_TxGateStats_t *ps = &pg->stats[pg->enabled ? 1 : 0];
+        bool noTime = false;
+        if (TxGateClosed(pg, &noTime)) {
+            ps->heldOff++;
+        } else {
+            uint32_t idxCpy = idx;
+            success = TC6_SendRawEthernetPacket(mlw[idx].tc.tc6, pTx, len, 0, (TC6_RawTxCallback_t)txCallback, (void *)idxCpy);
+            if (success) {
+                ps->bulkFrames++;
+                ps->bulkBytes += len;
+                if (noTime) {
+                    ps->noTime++;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+void TC6NoIP_TxGateAddPtpLatency(int8_t idx, uint32_t latencyNs)
+{
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        TC6NoIP_TxGateStats_t *ps = &pg->stats[pg->enabled ? 1 : 0];
+        if (latencyNs > ps->ptpLatencyMaxNs) {
+            ps->ptpLatencyMaxNs = latencyNs;
+        }
+        ps->ptpLatencySumNs += latencyNs;
+        ps->ptpFrames++;
+    }
+}
+
+bool TC6NoIP_GetTxGateStats(int8_t idx, bool enabled, TC6NoIP_TxGateStats_t *pStats)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != pStats)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        *pStats = pg->stats[enabled ? 1 : 0];
+        if (enabled == pg->enabled) {
+            pStats->ms += TC6Stub_GetTick() - pg->sinceMs;
+        }
+        success = true;
+    }
+    return success;
+}
+
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*             CALLBACK FUNCTION FROM TC6 Protocol Driver               */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
@@ -240,7 +361,20 @@ void TC6_CB_OnRxEthernetPacket(TC6_t *pInst, bool success, uint16_t len, uint64_
     {
       handlePtp(ethRxBuf, len, 0, 0);
     }
-  }  
+  }
+  else if(hdr->ethType[0] == (uint8_t)(PD_ETH_TYPE >> 8) && hdr->ethType[1] == (uint8_t)PD_ETH_TYPE)
+  {
+    uint64_t rxNs = 0;
+    if(rxTimestamp)
+    {
+      rxNs = ((*rxTimestamp >> 32) * SEC_IN_NS) + (*rxTimestamp & 0x3FFFFFFFu);
+    }
+    pdHandleFrame(ethRxBuf, len, rxNs);
+  }
+  else if(hdr->ethType[0] == (uint8_t)(MC_ETH_TYPE >> 8) && hdr->ethType[1] == (uint8_t)MC_ETH_TYPE)
+  {
+    mcHandleFrame(ethRxBuf, len);
+  }
 }
 
 void TC6_CB_OnNeedService(TC6_t *pInst, void *pGlobalTag)
@@ -392,7 +526,7 @@ void TC6Regs_CB_OnEvent(TC6_t *pInst, TC6Regs_Event_t event, void *pTag)
             PRINT(ESC_CLEAR_LINE ESC_YELLOW "[%d]MCLK_GEN_Status" ESC_RESETCOLOR "\r\n", lw->idx);
             break;
         case TC6Regs_Event_gPTP_PA_TS_EG_Status:
-            PRINT(ESC_CLEAR_LINE ESC_YELLOW "g[%d]PTP_PA_TS_EG_Status" ESC_RESETCOLOR "\r\n", lw->idx);
+            /* Periodic (PPS, event generators), SEVSTS is handled by tc6-events */
             break;
         case TC6Regs_Event_Extended_Block_Status:
             PRINT(ESC_CLEAR_LINE ESC_YELLOW "[%d]Extended_Block_Status" ESC_RESETCOLOR "\r\n", lw->idx);
@@ -424,6 +558,37 @@ void TC6Regs_CB_OnEvent(TC6_t *pInst, TC6Regs_Event_t event, void *pTag)
     }
 }
 
+/* true, while now lies within preNs ahead or postNs after one of the protected transmissions */
+static bool TxGateClosed(TxGate_t *pg, bool *pNoTime)
+{
+    uint64_t now;
+    uint8_t i;
+    if (!pg->enabled || (NULL == pg->getTime)) {
+        return false;
+    }
+    now = pg->getTime();
+    if (0u == now) {
+        *pNoTime = true;
+        return false;
+    }
+    for (i = 0; i < TC6NOIP_TX_GATE_WINDOWS; i++) {
+        const TxGateWindow_t *pw = &pg->windows[i];
+        uint64_t phase;
+        if (0u == pw->periodNs) {
+            continue;
+        }
+        if (now >= pw->anchorNs) {
+            phase = (now - pw->anchorNs) % pw->periodNs;
+        } else {
+            phase = (pw->periodNs - ((pw->anchorNs - now) % pw->periodNs)) % pw->periodNs;
+        }
+        if ((phase < pg->postNs) || ((pw->periodNs - phase) <= pg->preNs)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void PrintRateLimited(const char *statement, ...)
 {
     static uint32_t cnt_ = 0;
@@ -114,6 +114,84 @@ bool TC6NoIP_SendEthernetPacket(int8_t idx, const uint8_t *pTx, uint16_t len, TC
  */
 bool TC6NoIP_GetMacAddress(int8_t idx, uint8_t mac[6]);
 
+/** \brief Number of protected windows of the TX gate per instance. */
+#define TC6NOIP_TX_GATE_WINDOWS     (4u)
+
+/**
+ * \brief Clock of the TX gate, the synchronized time in nanoseconds.
+ * \return The current time, 0 while it is not available. Bulk traffic then passes the gate.
+ */
+typedef uint64_t (*TC6NoIP_GetTimeNs_t)(void);
+
+/**
+ * \brief TX gate statistics, kept separately for the open (off) and the active (on) gate.
+ */
+typedef struct
+{
+    uint32_t ms;                /* Time spent in this gate state */
+    uint32_t bulkFrames;        /* Frames sent with TC6NoIP_SendBulkEthernetPacket() */
+    uint32_t bulkBytes;
+    uint32_t heldOff;           /* Bulk sends refused inside a protected window */
+    uint32_t noTime;            /* Bulk frames passed because the clock was not available */
+    uint32_t ptpFrames;         /* Latencies reported with TC6NoIP_TxGateAddPtpLatency() */
+    uint32_t ptpLatencyMaxNs;
+    uint64_t ptpLatencySumNs;
+} TC6NoIP_TxGateStats_t;
+
+/** \brief Sets up the time-aware TX gate, it holds bulk traffic off around the protected transmissions.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param getTime - The synchronized clock the windows are given in. NULL turns the gate off.
+ *  \param preNs - Guard time ahead of each protected transmission.
+ *  \param postNs - Guard time after each protected transmission, covers e.g. the FollowUp of a Sync.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateSetup(int8_t idx, TC6NoIP_GetTimeNs_t getTime, uint32_t preNs, uint32_t postNs);
+
+/** \brief Sets a recurring protected transmission, at anchorNs + k * periodNs.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param window - Window number, 0 up to TC6NOIP_TX_GATE_WINDOWS - 1.
+ *  \param anchorNs - Any one time of the transmission, in the clock given to TC6NoIP_TxGateSetup().
+ *  \param periodNs - Period of the transmission, 0 removes the window.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateSetWindow(int8_t idx, uint8_t window, uint64_t anchorNs, uint32_t periodNs);
+
+/** \brief Activates or opens the gate without losing its setup, the statistics switch along.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param enable - true, bulk traffic is held off inside the windows. false, it always passes.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateEnable(int8_t idx, bool enable);
+
+/** \brief Tells whether the gate is active.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \return true, if bulk traffic is held off inside the windows. false, otherwise.
+ */
+bool TC6NoIP_TxGateIsEnabled(int8_t idx);
+
+/** \brief Sends a raw Ethernet packet of bulk traffic through the TX gate.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param pTx - Filled byte array holding an entire Ethernet packet. Warning, the buffer must stay valid until the txCallback with this pointer as parameter was called.
+ *  \param len - Length of the byte array.
+ *  \param txCallback - Callback function if desired, NULL otherwise.
+ *  \return true, on success. false, the gate is closed or the queue is full, try again later.
+ */
+bool TC6NoIP_SendBulkEthernetPacket(int8_t idx, const uint8_t *pTx, uint16_t len, TC6NoIP_OnTxCallback_t txCallback);
+
+/** \brief Adds a PTP frame latency sample to the statistics of the current gate state.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param latencyNs - The latency as measured by the application, e.g. FollowUp after Sync.
+ */
+void TC6NoIP_TxGateAddPtpLatency(int8_t idx, uint32_t latencyNs);
+
+/** \brief Reads the TX gate statistics of one gate state.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param enabled - true, for the statistics while the gate was active. false, while it was open.
+ *  \param pStats - Filled with the statistics.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_GetTxGateStats(int8_t idx, bool enabled, TC6NoIP_TxGateStats_t *pStats);
+
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                 Callback to be implemented in higher layers          */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
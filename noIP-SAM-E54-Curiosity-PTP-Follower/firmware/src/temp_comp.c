@@ -0,0 +1,247 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Temperature compensation
+
+  File Name:
+    temp_comp.c
+
+  Summary:
+    Frequency-vs-temperature model of the node oscillator
+
+  Description:
+    Temperature is calculated from the PTAT and CTAT conversions with the
+    factory calibration in the TEMP_LOG fuses. The model is
+      ppm(T) = a0 + a1 x + a2 x^2,  x = (T - PTP_TEMPCOMP_T0_C) / PTP_TEMPCOMP_SCALE_C
+    and is updated by a recursive least squares estimator.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "definitions.h"
+#include "temp_comp.h"
+
+#define PTP_LOG printf
+
+typedef enum
+{
+  TEMP_IDLE,
+  TEMP_WAIT_PTAT,
+  TEMP_WAIT_CTAT
+} tempState_t;
+
+static tempState_t state = TEMP_IDLE;
+static uint32_t nextMs = 0;
+static uint16_t resultPtat = 0;
+
+/* Factory calibration */
+static double tl, th, vpl, vph, vcl, vch;
+
+static double temperature = 0.0;
+static bool temperatureValid = false;
+static bool newReading = false;
+
+/* Model */
+static double theta[3];
+static double P[3][3];
+static uint32_t samples = 0;
+static double minC = 0.0;
+static double maxC = 0.0;
+
+static void readCalibration(void)
+{
+  uint32_t w0 = TEMP_LOG_FUSES_REGS->FUSES_TEMP_LOG_WORD_0;
+  uint32_t w1 = TEMP_LOG_FUSES_REGS->FUSES_TEMP_LOG_WORD_1;
+  uint32_t w2 = TEMP_LOG_FUSES_REGS->FUSES_TEMP_LOG_WORD_2;
+  
+  tl = (double)((w0 & FUSES_TEMP_LOG_WORD_0_ROOM_TEMP_VAL_INT_Msk) >> FUSES_TEMP_LOG_WORD_0_ROOM_TEMP_VAL_INT_Pos) +
+       (double)((w0 & FUSES_TEMP_LOG_WORD_0_ROOM_TEMP_VAL_DEC_Msk) >> FUSES_TEMP_LOG_WORD_0_ROOM_TEMP_VAL_DEC_Pos) / 10.0;
+  th = (double)((w0 & FUSES_TEMP_LOG_WORD_0_HOT_TEMP_VAL_INT_Msk) >> FUSES_TEMP_LOG_WORD_0_HOT_TEMP_VAL_INT_Pos) +
+       (double)((w0 & FUSES_TEMP_LOG_WORD_0_HOT_TEMP_VAL_DEC_Msk) >> FUSES_TEMP_LOG_WORD_0_HOT_TEMP_VAL_DEC_Pos) / 10.0;
+  vpl = (double)((w1 & FUSES_TEMP_LOG_WORD_1_ROOM_ADC_VAL_PTAT_Msk) >> FUSES_TEMP_LOG_WORD_1_ROOM_ADC_VAL_PTAT_Pos);
+  vph = (double)((w1 & FUSES_TEMP_LOG_WORD_1_HOT_ADC_VAL_PTAT_Msk) >> FUSES_TEMP_LOG_WORD_1_HOT_ADC_VAL_PTAT_Pos);
+  vcl = (double)((w2 & FUSES_TEMP_LOG_WORD_2_ROOM_ADC_VAL_CTAT_Msk) >> FUSES_TEMP_LOG_WORD_2_ROOM_ADC_VAL_CTAT_Pos);
+  vch = (double)((w2 & FUSES_TEMP_LOG_WORD_2_HOT_ADC_VAL_CTAT_Msk) >> FUSES_TEMP_LOG_WORD_2_HOT_ADC_VAL_CTAT_Pos);
+}
+
+/* Temperature in degree C out of the PTAT (tp) and CTAT (tc) conversions */
+static double calcTemperature(double tp, double tc)
+{
+  double num = (tl * vph * tc) - (vpl * th * tc) - (tl * vch * tp) + (th * vcl * tp);
+  double den = (vcl * tp) - (vch * tp) - (vpl * tc) + (vph * tc);
+  return (den != 0.0) ? (num / den) : 0.0;
+}
+
+static void resetModel(void)
+{
+  memset(theta, 0, sizeof(theta));
+  memset(P, 0, sizeof(P));
+  for(uint32_t i = 0; i < 3u; i++)
+  {
+    P[i][i] = PTP_TEMPCOMP_P_MAX;
+  }
+  samples = 0;
+}
+
+void tempCompInit(void)
+{
+  readCalibration();
+  resetModel();
+  SUPC_REGS->SUPC_VREF |= SUPC_VREF_TSEN_Msk | SUPC_VREF_ONDEMAND_Msk;
+  ADC0_Enable();
+  state = TEMP_IDLE;
+}
+
+void tempCompService(uint32_t nowMs)
+{
+  switch(state)
+  {
+    case TEMP_IDLE:
+      if((int32_t)(nowMs - nextMs) >= 0)
+      {
+        nextMs = nowMs + PTP_TEMPCOMP_PERIOD_MS;
+        ADC0_ChannelSelect(ADC_POSINPUT_PTAT, ADC_NEGINPUT_GND);
+        ADC0_ConversionStart();
+        state = TEMP_WAIT_PTAT;
+      }
+      break;
+    case TEMP_WAIT_PTAT:
+      if(ADC0_ConversionStatusGet())
+      {
+        resultPtat = ADC0_ConversionResultGet();
+        ADC0_ChannelSelect(ADC_POSINPUT_CTAT, ADC_NEGINPUT_GND);
+        ADC0_ConversionStart();
+        state = TEMP_WAIT_CTAT;
+      }
+      break;
+    case TEMP_WAIT_CTAT:
+      if(ADC0_ConversionStatusGet())
+      {
+        double t = calcTemperature((double)resultPtat, (double)ADC0_ConversionResultGet());
+        temperature = temperatureValid ? ((PTP_TEMPCOMP_TEMP_ALPHA * t) + ((1.0 - PTP_TEMPCOMP_TEMP_ALPHA) * temperature)) : t;
+        temperatureValid = true;
+        newReading = true;
+        state = TEMP_IDLE;
+      }
+      break;
+  }
+}
+
+bool tempCompGetReading(double* degC)
+{
+  if(!newReading)
+  {
+    return false;
+  }
+  newReading = false;
+  *degC = temperature;
+  return true;
+}
+
+void tempCompLearn(double degC, double rateRatio)
+{
+  double s = (degC - PTP_TEMPCOMP_T0_C) / PTP_TEMPCOMP_SCALE_C;
+  double x[3] = {1.0, s, s * s};
+  double y = (rateRatio - 1.0) * 1e6;
+  double px[3];
+  double den = PTP_TEMPCOMP_FORGETTING;
+  double err = y;
+  
+  for(uint32_t i = 0; i < 3u; i++)
+  {
+    px[i] = (P[i][0] * x[0]) + (P[i][1] * x[1]) + (P[i][2] * x[2]);
+    den += x[i] * px[i];
+    err -= theta[i] * x[i];
+  }
+  for(uint32_t i = 0; i < 3u; i++)
+  {
+    theta[i] += (px[i] / den) * err;
+  }
+  for(uint32_t i = 0; i < 3u; i++)
+  {
+    for(uint32_t j = 0; j < 3u; j++)
+    {
+      P[i][j] = (P[i][j] - ((px[i] * px[j]) / den)) / PTP_TEMPCOMP_FORGETTING;
+    }
+  }
+  /* Without temperature change the forgetting would let P grow without bound */
+  for(uint32_t i = 0; i < 3u; i++)
+  {
+    if(P[i][i] > PTP_TEMPCOMP_P_MAX)
+    {
+      double scale = sqrt(PTP_TEMPCOMP_P_MAX / P[i][i]);
+      for(uint32_t j = 0; j < 3u; j++)
+      {
+        P[i][j] *= scale;
+        P[j][i] *= scale;
+      }
+    }
+  }
+  
+  if(samples == 0)
+  {
+    minC = degC;
+    maxC = degC;
+  }
+  if(degC < minC) minC = degC;
+  if(degC > maxC) maxC = degC;
+  samples++;
+}
+
+bool tempCompPredict(double degC, double* rateRatio)
+{
+  if(samples < PTP_TEMPCOMP_MIN_SAMPLES)
+  {
+    return false;
+  }
+  /* Slope and curvature are only known inside the learned range */
+  if((maxC - minC) < PTP_TEMPCOMP_MIN_SPAN_C)
+  {
+    degC = (minC + maxC) / 2.0;
+  }
+  else if(degC < (minC - PTP_TEMPCOMP_EXTRAPOLATE_C))
+  {
+    degC = minC - PTP_TEMPCOMP_EXTRAPOLATE_C;
+  }
+  else if(degC > (maxC + PTP_TEMPCOMP_EXTRAPOLATE_C))
+  {
+    degC = maxC + PTP_TEMPCOMP_EXTRAPOLATE_C;
+  }
+  double s = (degC - PTP_TEMPCOMP_T0_C) / PTP_TEMPCOMP_SCALE_C;
+  *rateRatio = 1.0 + (theta[0] + (theta[1] * s) + (theta[2] * s * s)) * 1e-6;
+  return true;
+}
+
+void tempCompPrintStatus(void)
+{
+  double ratio;
+  PTP_LOG("Temperature %.2f C, model: %lu samples, range %.1f..%.1f C\r\n", temperature, samples, minC, maxC);
+  PTP_LOG("  ppm = %.4f %+.4f x %+.4f x^2, x = (T - %.1f) / %.1f\r\n", theta[0], theta[1], theta[2], PTP_TEMPCOMP_T0_C, PTP_TEMPCOMP_SCALE_C);
+  if(tempCompPredict(temperature, &ratio))
+  {
+    PTP_LOG("  predicted rate ratio %.9f\r\n", ratio);
+  }
+}
@@ -0,0 +1,88 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Temperature compensation
+
+  File Name:
+    temp_comp.h
+
+  Summary:
+    Frequency-vs-temperature model of the node oscillator
+
+  Description:
+    The SAM E54 temperature sensor (PTAT/CTAT through ADC0) is sampled
+    periodically. While the servo is locked, the oscillator/GM rate ratio is
+    learned against temperature as a quadratic polynomial (recursive least
+    squares with forgetting). The model is used as feed-forward on MAC_TISUBN
+    while locked and to steer the clock alone during holdover.
+*******************************************************************************/
+
+#ifndef TEMP_COMP_H
+#define	TEMP_COMP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PTP_TEMPCOMP_PERIOD_MS          1000
+/* Weight of a new reading in the temperature low pass */
+#define PTP_TEMPCOMP_TEMP_ALPHA         0.2
+/* Reference temperature of the polynomial and scaling of its argument */
+#define PTP_TEMPCOMP_T0_C               25.0
+#define PTP_TEMPCOMP_SCALE_C            10.0
+/* RLS forgetting factor per sample, about 3 hours of memory at 1 Hz */
+#define PTP_TEMPCOMP_FORGETTING         0.9999
+#define PTP_TEMPCOMP_P_MAX              1.0e6
+/* Samples and temperature span before the model is trusted */
+#define PTP_TEMPCOMP_MIN_SAMPLES        120
+#define PTP_TEMPCOMP_MIN_SPAN_C         1.0
+/* How far the model may be extrapolated beyond the learned range */
+#define PTP_TEMPCOMP_EXTRAPOLATE_C      5.0
+
+/* Enables the temperature sensor, ADC0 has to be initialized */
+void tempCompInit(void);
+
+/* Runs the ADC conversions, to be called from the main loop */
+void tempCompService(uint32_t nowMs);
+
+/* Returns true once for every new filtered temperature reading */
+bool tempCompGetReading(double* degC);
+
+/* Adds a locked oscillator/GM rate ratio measured at degC */
+void tempCompLearn(double degC, double rateRatio);
+
+/* Model rate ratio at degC, false while the model is not trained */
+bool tempCompPredict(double degC, double* rateRatio);
+
+void tempCompPrintStatus(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TEMP_COMP_H */
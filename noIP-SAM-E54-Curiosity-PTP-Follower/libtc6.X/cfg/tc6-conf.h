@@ -138,11 +138,11 @@ extern "C" {
 #endif
 
 /**
- * \brief Defines the maximum amount of simultaneous control register operations
- * \note Do not modify.
+ * \brief Defines the maximum amount of registers accessed by a single control transaction
+ * \note Limits the count given to TC6_WriteRegisters() and TC6_ReadRegisters(). 6 allows a complete event generator block (EGxSTNS..EGxCTL) to be written at once.
  */
 #ifndef TC6_MAX_CNTRL_VARS
-#define TC6_MAX_CNTRL_VARS  (1u)
+#define TC6_MAX_CNTRL_VARS  (6u)
 #endif
 
 #endif /* TC6_CONFIG_H_ */
@@ -0,0 +1,222 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Event Generator and Event Capture Support for Microchip LAN865x 10BASE-T1S MACPHY
+
+  Company:
+    Microchip Technology Inc.
+    
+  File Name:
+    tc6-events.h
+*******************************************************************************/
+
+#ifndef TC6_EVENTS_H_
+#define TC6_EVENTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tc6.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                            DEFINITIONS                               */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/** \brief Number of event generators (EG0..EG3) of the LAN865x */
+#define TC6EVENTS_EG_COUNT      (4u)
+
+/** \brief Number of event capture inputs, input 0..2 are the pins DIOA1..DIOA3 */
+#define TC6EVENTS_CAP_COUNT     (3u)
+
+/** \brief Number of captures buffered for polling by TC6Events_CaptureGet() */
+#ifndef TC6EVENTS_CAP_RING_SIZE
+#define TC6EVENTS_CAP_RING_SIZE (8u)
+#endif
+
+typedef enum
+{
+    TC6Events_EgState_Idle = 0,     /**< Generator stopped, nothing programmed */
+    TC6Events_EgState_Pending,      /**< Register write enqueued, not yet confirmed by the MAC-PHY */
+    TC6Events_EgState_Armed,        /**< One-shot programmed, waiting for its start time */
+    TC6Events_EgState_Running,      /**< Periodic pulse train programmed */
+    TC6Events_EgState_Done,         /**< One-shot pulse was generated */
+    TC6Events_EgState_Failed        /**< Programming failed or start time was missed */
+} TC6Events_EgState_t;
+
+/** \brief Callback for event generator activity
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param eg - The event generator index (0..TC6EVENTS_EG_COUNT-1).
+ *  \param success - true, a pulse was generated (EGxDONE). false, programming failed or the start time was missed after a clock step.
+ *  \param pTag - The pointer given along with the scheduling function.
+ */
+typedef void (*TC6Events_EgDone_t)(TC6_t *pInst, uint8_t eg, bool success, void *pTag);
+
+typedef enum
+{
+    TC6Events_Edge_Rising = 1,
+    TC6Events_Edge_Falling = 2,
+    TC6Events_Edge_Both = 3
+} TC6Events_Edge_t;
+
+typedef struct
+{
+    uint64_t timestampNs;   /**< PTP time of the edge, in ns since the PTP epoch */
+    uint8_t input;          /**< The capture input (0..TC6EVENTS_CAP_COUNT-1) */
+} TC6Events_Capture_t;
+
+typedef struct
+{
+    uint32_t captures;      /**< Captures delivered, by callback or ring */
+    uint32_t hwOverruns;    /**< Edges lost before read, overwritten in the MAC-PHY or a failed register read */
+    uint32_t ringOverruns;  /**< Captures dropped, because the ring was full */
+} TC6Events_CaptureStats_t;
+
+/** \brief Callback for a captured edge
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param input - The capture input (0..TC6EVENTS_CAP_COUNT-1).
+ *  \param timestampNs - PTP time of the edge, in ns since the PTP epoch.
+ *  \param pTag - The pointer given along with TC6Events_CaptureEnable().
+ */
+typedef void (*TC6Events_OnCapture_t)(TC6_t *pInst, uint8_t input, uint64_t timestampNs, void *pTag);
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                            PUBLIC API                                */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/** \brief Enables the event generator done interrupts (SEVINTEN) and unmasks SEVM in IMASK1.
+ *  \note Call once after TC6Regs_Init(). The EGx outputs must be routed to a DIOAx pin by PADCTRL.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \return true, if the register writes could be enqueued. false, otherwise.
+ */
+bool TC6Events_Init(TC6_t *pInst);
+
+/** \brief Programs a single pulse at an absolute PTP time.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param eg - The event generator index (0..TC6EVENTS_EG_COUNT-1).
+ *  \param startSec - Seconds part of the PTP start time (48 Bit).
+ *  \param startNs - Nanoseconds part of the PTP start time (< 1e9).
+ *  \param widthNs - Pulse width in nanoseconds.
+ *  \param activeHigh - true, the output is driven high during the pulse. false, driven low.
+ *  \param doneCb - Called on completion or failure. May left NULL.
+ *  \param pTag - Any pointer. Will be given back in doneCb. May left NULL.
+ *  \return true, if the request could be enqueued. false, invalid parameter or queue full.
+ */
+bool TC6Events_EgOneShot(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag);
+
+/** \brief Programs a periodic pulse train, the first pulse at an absolute PTP time.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param eg - The event generator index (0..TC6EVENTS_EG_COUNT-1).
+ *  \param startSec - Seconds part of the PTP time of the first pulse (48 Bit).
+ *  \param startNs - Nanoseconds part of the PTP time of the first pulse (< 1e9).
+ *  \param widthNs - Pulse width in nanoseconds, must be smaller than intervalNs.
+ *  \param intervalNs - Distance between two rising edges in nanoseconds.
+ *  \param activeHigh - true, the output is driven high during the pulse. false, driven low.
+ *  \param doneCb - Called for every generated pulse and on failure. May left NULL.
+ *  \param pTag - Any pointer. Will be given back in doneCb. May left NULL.
+ *  \return true, if the request could be enqueued. false, invalid parameter or queue full.
+ */
+bool TC6Events_EgPeriodic(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, uint32_t intervalNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag);
+
+/** \brief Stops an event generator.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param eg - The event generator index (0..TC6EVENTS_EG_COUNT-1).
+ *  \return true, if the request could be enqueued. false, otherwise.
+ */
+bool TC6Events_EgStop(TC6_t *pInst, uint8_t eg);
+
+/** \brief Returns the state of an event generator.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param eg - The event generator index (0..TC6EVENTS_EG_COUNT-1).
+ *  \param pPulses - Receives the number of EGxDONE reported since the last programming. May left NULL.
+ *  \return The current state, TC6Events_EgState_Idle for unknown instances.
+ */
+TC6Events_EgState_t TC6Events_GetEgState(TC6_t *pInst, uint8_t eg, uint32_t *pPulses);
+
+/** \brief Reprograms all active event generators after the PTP clock was stepped.
+ *  \note Call after every write to MAC_TA or MAC_TSL/MAC_TN. Reads the new time and moves each
+ *        periodic train to its next grid point (start + k * interval). Armed one-shots, whose start
+ *        time is now in the past, are reported as failed.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \return true, if the time read could be enqueued or nothing was active. false, otherwise.
+ */
+bool TC6Events_OnClockStep(TC6_t *pInst);
+
+/** \brief Enables timestamping of an external edge on a capture input.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param input - The capture input (0..TC6EVENTS_CAP_COUNT-1).
+ *  \param edge - The edge(s) to be timestamped.
+ *  \param captureCb - Called for every capture. May left NULL, then the captures are put into the ring for TC6Events_CaptureGet().
+ *  \param pTag - Any pointer. Will be given back in captureCb. May left NULL.
+ *  \return true, if the request could be enqueued. false, invalid parameter or queue full.
+ */
+bool TC6Events_CaptureEnable(TC6_t *pInst, uint8_t input, TC6Events_Edge_t edge, TC6Events_OnCapture_t captureCb, void *pTag);
+
+/** \brief Disables a capture input.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param input - The capture input (0..TC6EVENTS_CAP_COUNT-1).
+ *  \return true, if the request could be enqueued. false, otherwise.
+ */
+bool TC6Events_CaptureDisable(TC6_t *pInst, uint8_t input);
+
+/** \brief Takes the oldest capture out of the ring.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param pCapture - Receives the capture.
+ *  \return true, if a capture was returned. false, the ring is empty.
+ */
+bool TC6Events_CaptureGet(TC6_t *pInst, TC6Events_Capture_t *pCapture);
+
+/** \brief Returns the capture counters, they are free running since TC6Events_Init().
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param pStats - Receives the counters.
+ *  \return true, on success. false, unknown instance.
+ */
+bool TC6Events_GetCaptureStats(TC6_t *pInst, TC6Events_CaptureStats_t *pStats);
+
+/** \brief Delivers a capture as if it was read from the MAC-PHY.
+ *  \note Emulation of external edges, to test the consumers of captures without a signal source.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param input - The capture input (0..TC6EVENTS_CAP_COUNT-1), it must be enabled.
+ *  \param timestampNs - PTP time of the emulated edge, in ns since the PTP epoch.
+ *  \return true, if the capture was delivered. false, input not enabled.
+ */
+bool TC6Events_CaptureInject(TC6_t *pInst, uint8_t input, uint64_t timestampNs);
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  Called by the tc6-regs component                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/** \brief Reads and clears SEVSTS, dispatches the EGxDONE flags and fetches the pending captures.
+ *  \note Called by tc6-regs when STATUS1 reports gPTP/PA/TS/EG status. Integrator does not need to call it.
+ *  \param pInst - The pointer returned by TC6_Init.
+ */
+void TC6Events_OnStatus(TC6_t *pInst);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* TC6_EVENTS_H_ */
@@ -38,6 +38,7 @@ Microchip or any third party.
 #include "tc6.h"
 #include "tc6-conf.h"
 #include "tc6-regs.h"
+#include "tc6-events.h"
 
 /* LAN8650 registers */
 #define PADCTRL             (0x000A0088u)
@@ -98,8 +99,8 @@ static void OnInitDone(TC6_t *pInst, bool success, uint32_t addr, uint32_t value
 static void OnExtendedBlock(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
 static void OnClearStatus1(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
 static void OnStatus1(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
-static void OnClearStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
 static void OnStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
+static void OnStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                         PUBLIC FUNCTIONS                             */
@@ -191,7 +192,8 @@ void TC6_CB_OnExtendedStatus(TC6_t *pInst, void *pGlobalTag)
    (void)pGlobalTag;
     TC6Reg_t *pReg = GetContext(pInst);
     pReg->unlockExtTime = TC6Regs_CB_GetTicksMs();
-    while (!TC6_ReadRegister(pInst, 0x00000008, CONTROL_PROTECTION, OnStatus0, NULL)) {
+    /* STATUS0 and STATUS1 are adjacent, fetch both with one control transaction */
+    while (!TC6_ReadRegisters(pInst, 0x00000008, 2u, CONTROL_PROTECTION, OnStatus, NULL)) {
         TC6_Service(pInst, true);
     }
 }
@@ -710,7 +712,7 @@ static void OnStatus1(TC6_t *pInst, bool success, uint32_t addr, uint32_t value,
                     case 25: TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_TX_Timestamp_Capture_Missed_B, pReg->pTag); break;
                     case 26: TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_TX_Timestamp_Capture_Missed_C, pReg->pTag); break;
                     case 27: TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_MCLK_GEN_Status, pReg->pTag); break;
-                    case 28: TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_gPTP_PA_TS_EG_Status, pReg->pTag); break;
+                    case 28: TC6Events_OnStatus(pInst); TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_gPTP_PA_TS_EG_Status, pReg->pTag); break;
                     case 29: TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_Extended_Block_Status, pReg->pTag);
                          pReg->extBlock = true;
                         break;
@@ -729,18 +731,6 @@ static void OnStatus1(TC6_t *pInst, bool success, uint32_t addr, uint32_t value,
     }
 }
 
-static void OnClearStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
-{
-    (void)success;
-    (void)addr;
-    (void)value;
-    (void)tag;
-    (void)pGlobalTag;
-    while (!TC6_ReadRegister(pInst, 0x00000009u, CONTROL_PROTECTION, OnStatus1, NULL)) {
-        TC6_Service(pInst, true);
-    }
-}
-
 static void OnStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
 {
     TC6Reg_t *pReg = GetContext(pInst);
@@ -769,13 +759,9 @@ static void OnStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value,
                 }
             }
         }
-        if (0u == value) {
-            while (!TC6_ReadRegister(pInst, 0x00000009, CONTROL_PROTECTION, OnStatus1, NULL)) {
-                TC6_Service(pInst, true);
-            }
-        } else {
+        if (0u != value) {
             /* Write to clear pending flags */
-            while (!TC6_WriteRegister(pInst, addr, value, CONTROL_PROTECTION, OnClearStatus0, NULL)) {
+            while (!TC6_WriteRegister(pInst, addr, value, CONTROL_PROTECTION, NULL, NULL)) {
                 TC6_Service(pInst, true);
             }
         }
@@ -783,3 +769,12 @@ static void OnStatus0(TC6_t *pInst, bool success, uint32_t addr, uint32_t value,
         TC6Regs_CB_OnEvent(pInst, TC6Regs_Event_UnknownError, pReg->pTag);
     }
 }
+
+static void OnStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
+{
+    if (0x00000008u == addr) {
+        OnStatus0(pInst, success, addr, value, tag, pGlobalTag);
+    } else {
+        OnStatus1(pInst, success, addr, value, tag, pGlobalTag);
+    }
+}
@@ -176,6 +176,8 @@ static bool spiTransaction(TC6_t *g, uint8_t *pTx, uint8_t *pRx, uint16_t len, S
 static bool modify(TC6_t *g, uint32_t value);
 static bool accessRegisters(TC6_t *g, enum register_op_type op, uint32_t addr, uint32_t value,
                             bool secure, uint32_t modifyMask, TC6_RegCallback_t callback, void *tag);
+static bool accessRegistersN(TC6_t *g, enum register_op_type op, uint32_t addr, const uint32_t *pValues, uint8_t num,
+                            bool secure, uint32_t modifyMask, TC6_RegCallback_t callback, void *tag);
 static void processDataRx(TC6_t *g);
 
 /* Protocol Implementation */
@@ -441,6 +443,32 @@ bool TC6_ReadModifyWriteRegister(TC6_t *g, uint32_t addr, uint32_t value, uint32
         , tag);
 }
 
+bool TC6_WriteRegisters(TC6_t *g, uint32_t addr, const uint32_t *pValues, uint8_t count, bool secure, TC6_RegCallback_t txCallback, void *tag)
+{
+    TC6_ASSERT(g && (TC6_MAGIC == g->magic));
+    TC6_ASSERT(pValues);
+    return accessRegistersN(g, REGISTER_OP_WRITE, addr
+        , pValues
+        , count
+        , secure
+        , 0    /* mask */
+        , txCallback
+        , tag);
+}
+
+bool TC6_ReadRegisters(TC6_t *g, uint32_t addr, uint8_t count, bool secure, TC6_RegCallback_t rxCallback, void *tag)
+{
+    uint32_t dummy[TC6_MAX_CNTRL_VARS] = { 0 };
+    TC6_ASSERT(g && (TC6_MAGIC == g->magic));
+    return accessRegistersN(g, REGISTER_OP_READ, addr
+        , dummy
+        , count
+        , secure
+        , 0    /* mask */
+        , rxCallback
+        , tag);
+}
+
 uint16_t TC6_MultipleRegisterAccess(TC6_t *g, const MemoryMap_t *pMap, uint16_t mapLength, TC6_RegCallback_t multipleCallback, void *pTag)
 {
     uint16_t i = 0;
@@ -640,13 +668,13 @@ static bool serviceControl(TC6_t *g)
         /****************************************/
         while(regop_stage4_modify_ready(&g->regop_q)) {
             struct register_operation *reg_op = NULL;
-            uint32_t regVal = 0xFFFFFFFFu;
+            uint32_t regVal[TC6_MAX_CNTRL_VARS] = { 0xFFFFFFFFu };
             uint16_t num;
             reg_op = regop_stage4_modify_ptr(&g->regop_q);
-            num = read_rx_ctrl_buffer(reg_op->rx_buf, reg_op->length, &regVal, sizeof(regVal), reg_op->secure);
+            num = read_rx_ctrl_buffer(reg_op->rx_buf, reg_op->length, regVal, sizeof(regVal), reg_op->secure);
             if ((0u == num)
                 || (REGISTER_OP_READWRITE_STAGE1 != reg_op->op)
-                || !modify(g, regVal))
+                || !modify(g, regVal[0]))
             {
                 /* Not a read modify write command (or it failed), proceed direct to stage 7*/
                 regop_stage4_modify_done(&g->regop_q);
@@ -658,20 +686,29 @@ static bool serviceControl(TC6_t *g)
             struct register_operation *reg_op = NULL;
             TC6_RegCallback_t callback;
             void *tag;
-            uint32_t regVal = 0xFFFFFFFFu;
+            uint32_t regVal[TC6_MAX_CNTRL_VARS] = { 0xFFFFFFFFu };
             uint32_t regAddr;
             uint16_t num;
+            uint16_t i;
             bool success;
+            bool read;
 
             reg_op = regop_stage7_event_ptr(&g->regop_q);
-            num = read_rx_ctrl_buffer(reg_op->rx_buf, reg_op->length, &regVal, sizeof(regVal), reg_op->secure);
+            num = read_rx_ctrl_buffer(reg_op->rx_buf, reg_op->length, regVal, sizeof(regVal), reg_op->secure);
             callback = reg_op->callback;
             regAddr = reg_op->regAddr;
             tag = reg_op->tag;
+            read = (REGISTER_OP_READ == reg_op->op);
             success = (0u != num);
             regop_stage7_event_done(&g->regop_q);
             if (NULL != callback) {
-                reg_op->callback(g, success, regAddr, regVal, tag, g->gTag);
+                if (!success || !read) {
+                    num = 1u;
+                }
+                /* Reads report every register, writes only the first one */
+                for (i = 0u; i < num; i++) {
+                    callback(g, success, (regAddr + i), regVal[i], tag, g->gTag);
+                }
             } else if (!success) {
                 TC6_CB_OnError(g, TC6Error_NoHardware, g->gTag);
             } else {} /* MISRA enforced termination */
@@ -759,6 +796,11 @@ static bool modify(TC6_t *g, uint32_t value)
 }
 
 static bool accessRegisters(TC6_t *g, enum register_op_type op, uint32_t addr, uint32_t value, bool secure, uint32_t modifyMask, TC6_RegCallback_t callback, void *tag)
+{
+    return accessRegistersN(g, op, addr, &value, 1u, secure, modifyMask, callback, tag);
+}
+
+static bool accessRegistersN(TC6_t *g, enum register_op_type op, uint32_t addr, const uint32_t *pValues, uint8_t num, bool secure, uint32_t modifyMask, TC6_RegCallback_t callback, void *tag)
 {
     struct register_operation *reg_op = NULL;
     uint16_t payloadSize = 0;
@@ -766,6 +808,9 @@ static bool accessRegisters(TC6_t *g, enum register_op_type op, uint32_t addr, u
     bool success = false;
     TC6_ASSERT(g && (TC6_MAGIC == g->magic));
     TC6_ASSERT(REGISTER_OP_INVALLID != op);
+    if ((num < 1u) || (num > TC6_MAX_CNTRL_VARS) || ((num > 1u) && (REGISTER_OP_WRITE != op) && (REGISTER_OP_READ != op))) {
+        return false;
+    }
     if (regop_stage1_enqueue_ready(&g->regop_q)) {
         success = true;
         switch(op) {
@@ -795,9 +840,9 @@ static bool accessRegisters(TC6_t *g, enum register_op_type op, uint32_t addr, u
 #endif
         (void)memset(reg_op->tx_buf, 0x00, sizeof(reg_op->tx_buf));
         if (secure) {
-            payloadSize = mk_secure_ctrl_req(write, false /* autoIncrement */, addr, 1 /* Array Len */, &value, reg_op->tx_buf, sizeof(reg_op->tx_buf));
+            payloadSize = mk_secure_ctrl_req(write, false /* autoIncrement */, addr, num /* Array Len */, pValues, reg_op->tx_buf, sizeof(reg_op->tx_buf));
         } else {
-            payloadSize = mk_ctrl_req(write, false /* autoIncrement */, addr, 1 /* Array Len */, &value, reg_op->tx_buf, sizeof(reg_op->tx_buf));
+            payloadSize = mk_ctrl_req(write, false /* autoIncrement */, addr, num /* Array Len */, pValues, reg_op->tx_buf, sizeof(reg_op->tx_buf));
         }
         if (payloadSize == 0u) {
             TC6_CB_OnError(g, TC6Error_ControlTxFail, g->gTag);
@@ -813,7 +858,7 @@ static bool accessRegisters(TC6_t *g, enum register_op_type op, uint32_t addr, u
         reg_op->secure = secure;
         reg_op->callback = callback;
         reg_op->tag = tag;
-        reg_op->modifyValue = value;
+        reg_op->modifyValue = pValues[0];
         reg_op->modifyMask = modifyMask;
 
         regop_stage1_enqueue_done(&g->regop_q);
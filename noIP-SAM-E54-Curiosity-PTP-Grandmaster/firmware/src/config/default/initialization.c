@@ -386,6 +386,10 @@ void SYS_Initialize ( void* data )
 
     EIC_Initialize();
 
+    TC0_TimerInitialize();
+
+    TC4_CaptureInitialize();
+
 
 
     /* MISRAC 2012 deviation block start */
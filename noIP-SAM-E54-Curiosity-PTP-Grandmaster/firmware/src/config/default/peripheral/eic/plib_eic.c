@@ -89,7 +89,8 @@ void EIC_Initialize (void)
                               EIC_CONFIG_SENSE4_NONE  |
                               EIC_CONFIG_SENSE5_NONE  |
                               EIC_CONFIG_SENSE6_NONE  |
-                              EIC_CONFIG_SENSE7_NONE  ;
+                              EIC_CONFIG_SENSE7_RISE  |
+                              EIC_CONFIG_FILTEN7_Msk  ;
 
     /* Interrupt sense type and filter control for EXTINT channels 8 to 15 */
     EIC_REGS->EIC_CONFIG[1] =  EIC_CONFIG_SENSE0_NONE 
@@ -106,6 +107,9 @@ void EIC_Initialize (void)
 
 
 
+    /* Event Control: EXTINT7 (external 1PPS) feeds EVSYS, no interrupt */
+    EIC_REGS->EIC_EVCTRL = 0x80U;
+
     /* External Interrupt enable*/
     EIC_REGS->EIC_INTENSET = 0x4000U;
 
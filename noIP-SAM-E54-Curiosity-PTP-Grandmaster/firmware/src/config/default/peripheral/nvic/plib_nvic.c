@@ -91,6 +91,10 @@ void NVIC_Initialize( void )
     NVIC_EnableIRQ(SERCOM6_2_IRQn);
     NVIC_SetPriority(SERCOM6_OTHER_IRQn, 7);
     NVIC_EnableIRQ(SERCOM6_OTHER_IRQn);
+    NVIC_SetPriority(TC0_IRQn, 7);
+    NVIC_EnableIRQ(TC0_IRQn);
+    NVIC_SetPriority(TC4_IRQn, 7);
+    NVIC_EnableIRQ(TC4_IRQn);
 
     /* Enable Usage fault */
     SCB->SHCSR |= (SCB_SHCSR_USGFAULTENA_Msk);
@@ -78,9 +78,13 @@ void PORT_Initialize(void)
    PORT_REGS->GROUP[0].PORT_PMUX[8] = 0x0U;
 
    /************************** GROUP 1 Initialization *************************/
+   PORT_REGS->GROUP[1].PORT_PINCFG[7] = 0x1U;
+   PORT_REGS->GROUP[1].PORT_PINCFG[9] = 0x1U;
    PORT_REGS->GROUP[1].PORT_PINCFG[24] = 0x41U;
    PORT_REGS->GROUP[1].PORT_PINCFG[25] = 0x41U;
 
+   PORT_REGS->GROUP[1].PORT_PMUX[3] = 0x0U;
+   PORT_REGS->GROUP[1].PORT_PMUX[4] = 0x40U;
    PORT_REGS->GROUP[1].PORT_PMUX[12] = 0x22U;
 
    /************************** GROUP 2 Initialization *************************/
@@ -0,0 +1,999 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Boundary clock backbone port
+
+  File Name:
+    gm_backbone.c
+
+  Summary:
+    GMAC driver for PTP frames, Pdelay initiator and responder, Sync servo
+    on the TSU and the TSU 1PPS
+
+  Description:
+    The GMAC is polled like the MAC-PHY, no interrupt is used. GMAC_ISR is
+    cleared on read, its flags are collected in d.isr until handled. Frames
+    are timestamped by the TSU into the event registers, which are read when
+    the frame is parsed: EFR for Sync, PEFR for the Pdelay messages and PEFT
+    for the own Pdelay_Req and Pdelay_Resp.
+    Only the PTP multicast address passes the hash filter, so the four
+    receive buffers are plenty even on a busy backbone.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "definitions.h"
+#include "gm_backbone.h"
+#include "gm_discipline.h"
+#include "ptp_frame.h"
+
+#define NS_PER_SEC                  (1000000000LL)
+#define NOMINAL_INC_NS              (1e9 / GM_BB_TSU_CLOCK_HZ)
+#define RX_BUFFERS                  (4)
+#define RX_BUFFER_SIZE              (1536)      /* a frame always fits one buffer */
+#define TX_BUFFERS                  (2)
+#define TX_BUFFER_SIZE              (128)
+#define MDIO_TIMEOUT                (10000)
+#define PHY_RESET_TIMEOUT           (1000)
+
+/* DMA descriptors */
+#define RX_W0_OWNED                 (0x00000001u)   /* written by the GMAC, software owns the buffer */
+#define RX_W0_WRAP                  (0x00000002u)
+#define RX_W1_LEN_MSK               (0x00001FFFu)
+#define RX_W1_SOF                   (0x00004000u)
+#define RX_W1_EOF                   (0x00008000u)
+#define TX_W1_LEN_MSK               (0x00003FFFu)
+#define TX_W1_LAST                  (0x00008000u)
+#define TX_W1_WRAP                  (0x40000000u)
+#define TX_W1_USED                  (0x80000000u)   /* sent, software owns the buffer */
+
+/* Clause 22 PHY registers */
+#define PHY_BMCR                    (0)
+#define PHY_BMSR                    (1)
+#define PHY_ANAR                    (4)
+#define PHY_ANLPAR                  (5)
+#define BMCR_RESET                  (0x8000u)
+#define BMCR_AN_ENABLE              (0x1000u)
+#define BMCR_AN_RESTART             (0x0200u)
+#define BMSR_LINK                   (0x0004u)
+#define BMSR_AN_COMPLETE            (0x0020u)
+#define AN_100FD                    (0x0100u)
+#define AN_100HD                    (0x0080u)
+#define AN_10FD                     (0x0040u)
+#define MDIO_OP_WRITE               (1)
+#define MDIO_OP_READ                (2)
+
+/* PTP message fields behind the Ethernet header */
+#define OFS_TSMT                    (0)
+#define OFS_FLAGS                   (6)
+#define OFS_CORRECTION              (8)
+#define OFS_SOURCE_PORT             (20)
+#define OFS_SEQUENCE_ID             (30)
+#define OFS_TIMESTAMP               (34)
+#define OFS_REQUESTING_PORT         (44)
+#define FLAG0_TWO_STEP              (0x02u)
+#define PTP_MIN_LEN                 (PTP_FRAME_ETH_HEADER_LEN + 44)
+
+#define SIM_STEP_MS                 (1)
+#define SIM_TAI_START               (1760000037LL)
+#define SIM_SYNC_INTERVAL_MS        (125)
+#define SIM_PDELAY_PHASE_MS         (500)
+#define SIM_TURNAROUND_NS           (10000)     /* neighbour from Pdelay_Req to Pdelay_Resp */
+#define SIM_TIMESTAMP_NS            (8)         /* timestamp resolution of both ends */
+
+typedef struct
+{
+    volatile uint32_t w0;
+    volatile uint32_t w1;
+} GmBackboneDesc_t;
+
+/* TSU writes, replaced by the simulation */
+typedef struct
+{
+    void (*setIncrement)(uint8_t ns, uint16_t subNs);
+    void (*stepNs)(int64_t ns);
+} GmBackboneTsu_t;
+
+typedef struct
+{
+    const GmBackboneTsu_t *tsu;
+    GmBackboneRelay_t relay;
+    GmBackboneStatus_t st;
+    ptpFrame_t pdelayReq;
+    ptpFrame_t pdelayResp;
+    ptpFrame_t pdelayRespFup;
+    uint32_t isr;
+    uint8_t rxIdx;
+    uint8_t txIdx;
+    bool running;
+    uint32_t nextLinkPollMs;
+    /* Own Pdelay exchange */
+    uint32_t nextPdelayMs;
+    uint16_t pdelaySeq;
+    int64_t pdT1;
+    int64_t pdT2;
+    int64_t pdT4;
+    int64_t pdRespCorrNs;
+    bool pdPending;
+    bool pdT1Valid;
+    bool pdRespValid;
+    double delayAvgNs;
+    /* Answer to the neighbour, the follow up waits for the Pdelay_Resp timestamp */
+    bool respFupWait;
+    bool respFupReady;
+    /* Sync of the backbone master, waiting for its Follow_Up */
+    int64_t syncT2;
+    int64_t syncCorrNs;
+    uint16_t syncSeq;
+    bool syncPending;
+    uint32_t lastSyncMs;
+    /* Servo */
+    int64_t refT1;
+    int64_t refT2;
+    bool refValid;
+    double driftPpb;
+    double fineRatePpb;                 /* below the resolution of the increment */
+    double fineAccNs;
+    uint32_t lastServiceMs;
+    bool serviceValid;
+    uint8_t lockCnt;
+    uint8_t settle;
+    /* TSU pulse, from the first lock on */
+    uint32_t cmpSec;
+    uint32_t ppsSec;
+    bool ppsEnabled;
+    bool cmpArmed;
+    bool ppsNew;
+} GmBackbone_t;
+
+typedef struct
+{
+    double tsuPpm;
+    double incRatio;                    /* programmed increment against nominal */
+    int64_t tsuSec;
+    double tsuNs;
+    int64_t cmpSec;                     /* like the compare register */
+    uint32_t seed;
+} GmBackboneSim_t;
+
+static GmBackbone_t d;
+static GmBackboneSim_t sim;
+static GmBackboneDesc_t rxDesc[RX_BUFFERS] __attribute__((aligned(8)));
+static GmBackboneDesc_t txDesc[TX_BUFFERS] __attribute__((aligned(8)));
+static uint8_t rxBuf[RX_BUFFERS][RX_BUFFER_SIZE] __attribute__((aligned(8)));
+static uint8_t txBuf[TX_BUFFERS][TX_BUFFER_SIZE] __attribute__((aligned(8)));
+
+/* RMII on peripheral function L: GRX1, GRX0, GTXCK, GRXER, GTXEN, GTX0, GTX1, GRXDV, GMDC, GMDIO */
+static const PORT_PIN rmiiPins[] = {
+    PORT_PIN_PA12, PORT_PIN_PA13, PORT_PIN_PA14, PORT_PIN_PA15, PORT_PIN_PA17,
+    PORT_PIN_PA18, PORT_PIN_PA19, PORT_PIN_PC20, PORT_PIN_PC11, PORT_PIN_PC12
+};
+
+static const uint8_t ptpMulticastMac[6] = {0x01, 0x80, 0xC2, 0x00, 0x00, 0x0E};
+
+static void HwInit(const uint8_t mac[6]);
+static void PhyInit(void);
+static void PollLink(void);
+static bool MdioAccess(uint8_t op, uint8_t reg, uint16_t *pData);
+static bool Transmit(const ptpFrame_t *pFrame);
+static void ReceiveFrames(uint32_t nowMs);
+static void HandleFrame(const uint8_t *pRx, uint16_t len, uint32_t nowMs);
+static void AnswerPdelay(const uint8_t *pMsg);
+static bool FromMaster(const uint8_t *pMsg, bool sync);
+static void Relay(const uint8_t *pMsg, uint16_t len, int64_t ingressNs);
+static void SendPdelayReq(uint32_t nowMs);
+static void ArmCompare(void);
+static int64_t ReadTs(const volatile uint32_t *pSec, const volatile uint32_t *pNs);
+static int64_t ReadTime(void);
+static void ProcessSync(int64_t t1, int64_t t2, uint32_t nowMs);
+static void ProcessPdelay(int64_t t1, int64_t t2, int64_t t3, int64_t t4);
+static void ServoService(uint32_t nowMs);
+static void ApplyRate(double ppb);
+static void Step(int64_t ns);
+static uint16_t Get16(const uint8_t *p);
+static int64_t GetTimestamp(const uint8_t *pMsg);
+static int64_t GetCorrection(const uint8_t *pMsg);
+static int32_t Clamp32(int64_t v);
+static void HwSetIncrement(uint8_t ns, uint16_t subNs);
+static void HwStepNs(int64_t ns);
+static void SimSetIncrement(uint8_t ns, uint16_t subNs);
+static void SimStepNs(int64_t ns);
+static int64_t SimTsu(double aheadNs);
+static int64_t SimStamp(int64_t ns);
+static double SimRate(void);
+static void SimPps(double edgeNs, int64_t pulseSec, GmBackboneSimResult_t *pResult, int32_t *pPpsErrorNs, uint32_t durationS);
+
+static const GmBackboneTsu_t hwTsu = {HwSetIncrement, HwStepNs};
+static const GmBackboneTsu_t simTsu = {SimSetIncrement, SimStepNs};
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         PUBLIC FUNCTIONS                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+void GmBackbone_Init(const uint8_t mac[6], const uint8_t clockIdentity[8])
+{
+    ptpFrameConfig_t cfg;
+
+    memset(&d, 0, sizeof(d));
+    d.tsu = &hwTsu;
+    d.st.state = GM_BB_FREERUN;
+
+    memset(&cfg, 0, sizeof(cfg));
+    memcpy(cfg.srcMac, mac, sizeof(cfg.srcMac));
+    memcpy(cfg.clockIdentity, clockIdentity, sizeof(cfg.clockIdentity));
+    cfg.portNumber = GM_BB_PORT_NUMBER;
+    cfg.logMessageInterval = 0;
+    cfg.twoStep = true;
+    (void)ptpFrameBuild(&d.pdelayReq, PTP_FRAME_PDELAY_REQ, &cfg);
+    (void)ptpFrameBuild(&d.pdelayResp, PTP_FRAME_PDELAY_RESP, &cfg);
+    (void)ptpFrameBuild(&d.pdelayRespFup, PTP_FRAME_PDELAY_RESP_FUP, &cfg);
+
+    HwInit(mac);
+    ApplyRate(0.0);
+    d.running = true;
+}
+
+void GmBackbone_Stop(void)
+{
+    d.running = false;
+    GMAC_REGS->GMAC_NCR &= ~(GMAC_NCR_RXEN_Msk | GMAC_NCR_TXEN_Msk);
+    d.st.linkUp = false;
+}
+
+void GmBackbone_Service(uint32_t nowMs)
+{
+    if (!d.running) {
+        return;
+    }
+    if ((int32_t)(nowMs - d.nextLinkPollMs) >= 0) {
+        d.nextLinkPollMs = nowMs + GM_BB_LINK_POLL_MS;
+        PollLink();
+    }
+    d.isr |= GMAC_REGS->GMAC_ISR;
+    if (0u != (d.isr & GMAC_ISR_TSUCMP_Msk)) {
+        d.isr &= ~GMAC_ISR_TSUCMP_Msk;
+        d.ppsSec = d.cmpSec;
+        d.ppsNew = true;
+        d.st.ppsCnt++;
+        d.st.taiSec = d.cmpSec;
+        d.cmpArmed = false;
+    }
+    /* Armed anew after every pulse and after a step across the compare value */
+    if (d.ppsEnabled && (!d.cmpArmed || (GMAC_REGS->GMAC_TSL > d.cmpSec))) {
+        ArmCompare();
+    }
+    if (0u != (d.isr & GMAC_ISR_PDRQFT_Msk)) {
+        d.isr &= ~GMAC_ISR_PDRQFT_Msk;
+        if (d.pdPending) {
+            d.pdT1 = ReadTs(&GMAC_REGS->GMAC_PEFTSL, &GMAC_REGS->GMAC_PEFTN);
+            d.pdT1Valid = true;
+        }
+    }
+    if (d.respFupWait && (0u != (d.isr & GMAC_ISR_PDRSFT_Msk))) {
+        int64_t t3 = ReadTs(&GMAC_REGS->GMAC_PEFTSL, &GMAC_REGS->GMAC_PEFTN);
+        d.isr &= ~GMAC_ISR_PDRSFT_Msk;
+        ptpFrameSetTimestamp(&d.pdelayRespFup, (uint64_t)(t3 / NS_PER_SEC), (uint32_t)(t3 % NS_PER_SEC));
+        d.respFupWait = false;
+        d.respFupReady = true;
+    }
+    if (d.respFupReady && Transmit(&d.pdelayRespFup)) {
+        d.respFupReady = false;
+        d.st.pdelayAnsweredCnt++;
+    }
+    ReceiveFrames(nowMs);
+    if (d.st.linkUp && ((int32_t)(nowMs - d.nextPdelayMs) >= 0)) {
+        SendPdelayReq(nowMs);
+    }
+    ServoService(nowMs);
+}
+
+bool GmBackbone_GetPps(uint32_t *pTaiSec)
+{
+    bool synced = (GM_BB_TRACK == d.st.state) || (GM_BB_LOCKED == d.st.state) || (GM_BB_HOLDOVER == d.st.state);
+    if (!d.ppsNew) {
+        return false;
+    }
+    d.ppsNew = false;
+    *pTaiSec = d.ppsSec;
+    return synced;
+}
+
+void GmBackbone_SetRelay(GmBackboneRelay_t relay)
+{
+    d.relay = relay;
+}
+
+void GmBackbone_GetStatus(GmBackboneStatus_t *pStatus)
+{
+    *pStatus = d.st;
+}
+
+const char *GmBackbone_StateName(GmBackboneState_t state)
+{
+    static const char *names[] = {"freerun", "acquire", "track", "locked", "holdover"};
+    return (state <= GM_BB_HOLDOVER) ? names[state] : "?";
+}
+
+/* Simulated time runs in SIM_STEP_MS steps on TAI, which is the time of the
+ * backbone master. The TSU advances by its crystal error and the programmed
+ * increment, the fine correction steps it like TA does. Sync and Pdelay are
+ * fed as timestamp sets, rounded down to the timestamp resolution. */
+void GmBackbone_SelfTest(const GmBackboneSimCase_t *pCase, GmBackboneSimResult_t *pResult, int32_t *pPpsErrorNs)
+{
+    uint32_t durationS = (pCase->durationS < GM_BB_SIM_MAX_S) ? pCase->durationS : GM_BB_SIM_MAX_S;
+    uint32_t steps = durationS * (1000u / SIM_STEP_MS);
+
+    memset(pResult, 0, sizeof(GmBackboneSimResult_t));
+    memset(&sim, 0, sizeof(sim));
+    memset(&d, 0, sizeof(d));
+    if (NULL != pPpsErrorNs) {
+        for (uint32_t s = 0; s <= durationS; s++) {
+            pPpsErrorNs[s] = GM_DISC_SIM_NO_PULSE;
+        }
+    }
+    sim.tsuPpm = pCase->tsuPpm;
+    sim.incRatio = 1.0;
+    sim.seed = 1;
+    sim.tsuSec = SIM_TAI_START + (pCase->tsuOffsetNs / NS_PER_SEC);
+    sim.tsuNs = (double)(pCase->tsuOffsetNs % NS_PER_SEC);
+    if (sim.tsuNs < 0.0) {
+        sim.tsuNs += (double)NS_PER_SEC;
+        sim.tsuSec--;
+    }
+    sim.cmpSec = sim.tsuSec + 1;
+    d.tsu = &simTsu;
+    d.st.state = GM_BB_FREERUN;
+    ApplyRate(0.0);
+
+    for (uint32_t i = 1; i <= steps; i++) {
+        uint32_t ms = i * SIM_STEP_MS;
+        uint32_t sec = ms / 1000u;
+        double advance = SIM_STEP_MS * 1e6 * SimRate();
+        bool gap = (pCase->syncGapStartS != 0u) && (sec >= pCase->syncGapStartS) &&
+                   (sec < (pCase->syncGapStartS + pCase->syncGapS));
+
+        sim.tsuNs += advance;
+        if (sim.tsuNs >= (double)NS_PER_SEC) {
+            sim.tsuNs -= (double)NS_PER_SEC;
+            sim.tsuSec++;
+        }
+        /* Also fires when a small step carried the TSU across the second */
+        if (sim.tsuSec >= sim.cmpSec) {
+            SimPps(((double)ms * 1e6) - (sim.tsuNs / SimRate()), sim.cmpSec, pResult, pPpsErrorNs, durationS);
+            sim.cmpSec = sim.tsuSec + 1;
+        }
+        if ((0u == (ms % SIM_SYNC_INTERVAL_MS)) && !gap) {
+            int64_t tai = (SIM_TAI_START * NS_PER_SEC) + ((int64_t)ms * 1000000);
+            uint32_t r;
+            sim.seed = (sim.seed * 1103515245u) + 12345u;
+            r = (sim.seed >> 8) & 0xFFFFu;
+            double delay = (double)pCase->pathDelayNs + (((r / 65535.0) - 0.5) * (double)pCase->syncJitterNs);
+            ProcessSync(SimStamp(tai), SimStamp(SimTsu(delay)), ms);
+        }
+        if ((ms % GM_BB_PDELAY_INTERVAL_MS) == SIM_PDELAY_PHASE_MS) {
+            int64_t tai = (SIM_TAI_START * NS_PER_SEC) + ((int64_t)ms * 1000000);
+            d.st.pdelayCnt++;
+            ProcessPdelay(SimStamp(SimTsu(0.0)), SimStamp(tai + pCase->pathDelayNs),
+                          SimStamp(tai + pCase->pathDelayNs + SIM_TURNAROUND_NS),
+                          SimStamp(SimTsu((2.0 * pCase->pathDelayNs) + SIM_TURNAROUND_NS)));
+        }
+        ServoService(ms);
+        if ((0u == pResult->lockS) && (GM_BB_LOCKED == d.st.state)) {
+            pResult->lockS = (sec > 0u) ? sec : 1u;
+        }
+        if (GM_BB_HOLDOVER == d.st.state) {
+            pResult->holdoverSeen = true;
+        }
+    }
+    pResult->stepCnt = d.st.stepCnt;
+    pResult->delayErrorNs = d.st.pathDelayNs - (int32_t)pCase->pathDelayNs;
+    pResult->residualPpb = ((SimRate() * (1.0 + (d.fineRatePpb * 1e-9))) - 1.0) * 1e9;
+    pResult->finalState = d.st.state;
+    d.tsu = NULL;
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static void HwInit(const uint8_t mac[6])
+{
+    uint32_t hash = 0;
+
+    MCLK_REGS->MCLK_AHBMASK |= MCLK_AHBMASK_GMAC_Msk;
+    MCLK_REGS->MCLK_APBCMASK |= MCLK_APBCMASK_GMAC_Msk;
+    for (uint8_t i = 0; i < (sizeof(rmiiPins) / sizeof(rmiiPins[0])); i++) {
+        PORT_PinPeripheralFunctionConfig(rmiiPins[i], PERIPHERAL_FUNCTION_L);
+    }
+
+    GMAC_REGS->GMAC_NCR = 0;
+    GMAC_REGS->GMAC_IDR = GMAC_IDR_Msk;
+    (void)GMAC_REGS->GMAC_ISR;
+    GMAC_REGS->GMAC_RSR = GMAC_RSR_Msk;
+    GMAC_REGS->GMAC_TSR = GMAC_TSR_Msk;
+    GMAC_REGS->GMAC_UR = 0;     /* RMII */
+    /* 100 Mbit/s full duplex until the PHY tells otherwise, MDC = MCK / 64,
+     * no broadcast, multicast through the hash filter, FCS not copied */
+    GMAC_REGS->GMAC_NCFGR = GMAC_NCFGR_SPD_Msk | GMAC_NCFGR_FD_Msk | GMAC_NCFGR_CLK(4) | GMAC_NCFGR_NBC_Msk |
+                            GMAC_NCFGR_MTIHEN_Msk | GMAC_NCFGR_RFCS_Msk;
+    GMAC_REGS->GMAC_DCFGR = GMAC_DCFGR_DRBS(RX_BUFFER_SIZE / 64) | GMAC_DCFGR_FBLDO(4) | GMAC_DCFGR_RXBMS(3) |
+                            GMAC_DCFGR_TXPBMS_Msk;
+
+    GMAC_REGS->SA[0].GMAC_SAB = (uint32_t)mac[0] | ((uint32_t)mac[1] << 8) | ((uint32_t)mac[2] << 16) | ((uint32_t)mac[3] << 24);
+    GMAC_REGS->SA[0].GMAC_SAT = (uint32_t)mac[4] | ((uint32_t)mac[5] << 8);
+    /* Hash index: the destination address folded to 6 bit by XOR, LSB first */
+    for (uint8_t bit = 0; bit < 48u; bit++) {
+        if (0u != (ptpMulticastMac[bit / 8u] & (1u << (bit % 8u)))) {
+            hash ^= 1u << (bit % 6u);
+        }
+    }
+    GMAC_REGS->GMAC_HRB = (hash < 32u) ? (1u << hash) : 0u;
+    GMAC_REGS->GMAC_HRT = (hash < 32u) ? 0u : (1u << (hash - 32u));
+
+    for (uint8_t i = 0; i < RX_BUFFERS; i++) {
+        rxDesc[i].w0 = (uint32_t)(uintptr_t)&rxBuf[i][0] | ((i == (RX_BUFFERS - 1u)) ? RX_W0_WRAP : 0u);
+        rxDesc[i].w1 = 0;
+    }
+    for (uint8_t i = 0; i < TX_BUFFERS; i++) {
+        txDesc[i].w0 = (uint32_t)(uintptr_t)&txBuf[i][0];
+        txDesc[i].w1 = TX_W1_USED | ((i == (TX_BUFFERS - 1u)) ? TX_W1_WRAP : 0u);
+    }
+    GMAC_REGS->GMAC_RBQB = (uint32_t)(uintptr_t)&rxDesc[0];
+    GMAC_REGS->GMAC_TBQB = (uint32_t)(uintptr_t)&txDesc[0];
+
+    /* TSU from 0, backbone time is loaded with the first Sync */
+    GMAC_REGS->GMAC_TSH = 0;
+    GMAC_REGS->GMAC_TSL = 0;
+    GMAC_REGS->GMAC_TN = 0;
+
+    GMAC_REGS->GMAC_NCR = GMAC_NCR_MPE_Msk;
+    PhyInit();
+    GMAC_REGS->GMAC_NCR = GMAC_NCR_MPE_Msk | GMAC_NCR_RXEN_Msk | GMAC_NCR_TXEN_Msk;
+}
+
+static void PhyInit(void)
+{
+    uint16_t v = BMCR_RESET;
+
+    (void)MdioAccess(MDIO_OP_WRITE, PHY_BMCR, &v);
+    for (uint32_t i = 0; i < PHY_RESET_TIMEOUT; i++) {
+        if (MdioAccess(MDIO_OP_READ, PHY_BMCR, &v) && (0u == (v & BMCR_RESET))) {
+            break;
+        }
+    }
+    v = BMCR_AN_ENABLE | BMCR_AN_RESTART;
+    (void)MdioAccess(MDIO_OP_WRITE, PHY_BMCR, &v);
+}
+
+/* The MAC follows the speed and duplex the PHY negotiated */
+static void PollLink(void)
+{
+    uint16_t bmsr = 0;
+    uint16_t anar = 0;
+    uint16_t anlpar = 0;
+    uint32_t ncfgr;
+    bool up;
+
+    /* The link bit latches low, the second read tells the current state */
+    (void)MdioAccess(MDIO_OP_READ, PHY_BMSR, &bmsr);
+    up = MdioAccess(MDIO_OP_READ, PHY_BMSR, &bmsr) && (0u != (bmsr & BMSR_LINK)) && (0u != (bmsr & BMSR_AN_COMPLETE));
+    if (up == d.st.linkUp) {
+        return;
+    }
+    d.st.linkUp = up;
+    if (!up || !MdioAccess(MDIO_OP_READ, PHY_ANAR, &anar) || !MdioAccess(MDIO_OP_READ, PHY_ANLPAR, &anlpar)) {
+        return;
+    }
+    anar &= anlpar;
+    d.st.speed100 = (0u != (anar & (AN_100FD | AN_100HD)));
+    d.st.fullDuplex = (0u != (anar & AN_100FD)) || (!d.st.speed100 && (0u != (anar & AN_10FD)));
+    ncfgr = GMAC_REGS->GMAC_NCFGR & ~(GMAC_NCFGR_SPD_Msk | GMAC_NCFGR_FD_Msk);
+    ncfgr |= (d.st.speed100 ? GMAC_NCFGR_SPD_Msk : 0u) | (d.st.fullDuplex ? GMAC_NCFGR_FD_Msk : 0u);
+    GMAC_REGS->GMAC_NCFGR = ncfgr;
+}
+
+/* Clause 22 frame, about 17 us at MDC = 1.9 MHz */
+static bool MdioAccess(uint8_t op, uint8_t reg, uint16_t *pData)
+{
+    GMAC_REGS->GMAC_MAN = GMAC_MAN_CLTTO_Msk | GMAC_MAN_OP(op) | GMAC_MAN_WTN(2) | GMAC_MAN_PHYA(GM_BB_PHY_ADDRESS) |
+                          GMAC_MAN_REGA(reg) | GMAC_MAN_DATA(*pData);
+    for (uint32_t i = 0; i < MDIO_TIMEOUT; i++) {
+        if (0u != (GMAC_REGS->GMAC_NSR & GMAC_NSR_IDLE_Msk)) {
+            *pData = (uint16_t)(GMAC_REGS->GMAC_MAN & GMAC_MAN_DATA_Msk);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* One frame per descriptor, the GMAC pads and appends the FCS */
+static bool Transmit(const ptpFrame_t *pFrame)
+{
+    GmBackboneDesc_t *desc = &txDesc[d.txIdx];
+
+    if (!d.st.linkUp || (0u == (desc->w1 & TX_W1_USED))) {
+        d.st.txBusyCnt++;
+        return false;
+    }
+    memcpy(txBuf[d.txIdx], pFrame->buf, pFrame->len);
+    desc->w1 = ((uint32_t)pFrame->len & TX_W1_LEN_MSK) | TX_W1_LAST | ((d.txIdx == (TX_BUFFERS - 1u)) ? TX_W1_WRAP : 0u);
+    __DMB();
+    GMAC_REGS->GMAC_NCR |= GMAC_NCR_TSTART_Msk;
+    d.txIdx = (uint8_t)((d.txIdx + 1u) % TX_BUFFERS);
+    return true;
+}
+
+static void ReceiveFrames(uint32_t nowMs)
+{
+    for (uint8_t n = 0; n < RX_BUFFERS; n++) {
+        GmBackboneDesc_t *desc = &rxDesc[d.rxIdx];
+        uint32_t w1;
+        if (0u == (desc->w0 & RX_W0_OWNED)) {
+            break;
+        }
+        w1 = desc->w1;
+        if ((RX_W1_SOF | RX_W1_EOF) == (w1 & (RX_W1_SOF | RX_W1_EOF))) {
+            d.st.rxFrameCnt++;
+            HandleFrame(rxBuf[d.rxIdx], (uint16_t)(w1 & RX_W1_LEN_MSK), nowMs);
+        }
+        desc->w0 &= ~RX_W0_OWNED;
+        d.rxIdx = (uint8_t)((d.rxIdx + 1u) % RX_BUFFERS);
+    }
+}
+
+static void HandleFrame(const uint8_t *pRx, uint16_t len, uint32_t nowMs)
+{
+    const uint8_t *msg = &pRx[PTP_FRAME_ETH_HEADER_LEN];
+    uint16_t seq;
+
+    if ((len < PTP_MIN_LEN) || (0x88 != pRx[12]) || (0xF7 != pRx[13])) {
+        return;
+    }
+    seq = Get16(&msg[OFS_SEQUENCE_ID]);
+    switch (msg[OFS_TSMT] & 0x0Fu) {
+        case PTP_FRAME_SYNC:
+            if (FromMaster(msg, true)) {
+                int64_t t2 = ReadTs(&GMAC_REGS->GMAC_EFRSL, &GMAC_REGS->GMAC_EFRN);
+                d.st.syncCnt++;
+                Relay(msg, len, t2);
+                if (0u != (msg[OFS_FLAGS] & FLAG0_TWO_STEP)) {
+                    d.syncT2 = t2;
+                    d.syncCorrNs = GetCorrection(msg);
+                    d.syncSeq = seq;
+                    d.syncPending = true;
+                } else {
+                    ProcessSync(GetTimestamp(msg) + GetCorrection(msg), t2, nowMs);
+                }
+            }
+            break;
+        case PTP_FRAME_FOLLOW_UP:
+            if (!FromMaster(msg, false)) {
+                break;
+            }
+            Relay(msg, len, 0);
+            if (d.syncPending && (seq == d.syncSeq)) {
+                d.syncPending = false;
+                d.st.followUpCnt++;
+                ProcessSync(GetTimestamp(msg) + d.syncCorrNs + GetCorrection(msg), d.syncT2, nowMs);
+            }
+            break;
+        case PTP_FRAME_ANNOUNCE:
+            if (FromMaster(msg, false)) {
+                Relay(msg, len, 0);
+            }
+            break;
+        case PTP_FRAME_PDELAY_REQ:
+            AnswerPdelay(msg);
+            break;
+        case PTP_FRAME_PDELAY_RESP:
+            if (d.pdPending && (seq == d.pdelaySeq)) {
+                d.pdT4 = ReadTs(&GMAC_REGS->GMAC_PEFRSL, &GMAC_REGS->GMAC_PEFRN);
+                d.pdT2 = GetTimestamp(msg);
+                d.pdRespCorrNs = GetCorrection(msg);
+                d.pdRespValid = true;
+            }
+            break;
+        case PTP_FRAME_PDELAY_RESP_FUP:
+            if (d.pdPending && d.pdRespValid && d.pdT1Valid && (seq == d.pdelaySeq)) {
+                d.pdPending = false;
+                d.st.pdelayCnt++;
+                ProcessPdelay(d.pdT1, d.pdT2, GetTimestamp(msg) + d.pdRespCorrNs + GetCorrection(msg), d.pdT4);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* The neighbour measures its link delay as well, without an answer it would
+ * not take this port as capable */
+static void AnswerPdelay(const uint8_t *pMsg)
+{
+    int64_t t2 = ReadTs(&GMAC_REGS->GMAC_PEFRSL, &GMAC_REGS->GMAC_PEFRN);
+    uint16_t seq = Get16(&pMsg[OFS_SEQUENCE_ID]);
+    uint16_t port = Get16(&pMsg[OFS_SOURCE_PORT + 8]);
+
+    if (d.respFupWait || d.respFupReady) {
+        /* Previous answer not through yet */
+        return;
+    }
+    ptpFrameSetSequenceId(&d.pdelayResp, seq);
+    ptpFrameSetRequestingPort(&d.pdelayResp, &pMsg[OFS_SOURCE_PORT], port);
+    ptpFrameSetTimestamp(&d.pdelayResp, (uint64_t)(t2 / NS_PER_SEC), (uint32_t)(t2 % NS_PER_SEC));
+    ptpFrameSetSequenceId(&d.pdelayRespFup, seq);
+    ptpFrameSetRequestingPort(&d.pdelayRespFup, &pMsg[OFS_SOURCE_PORT], port);
+    d.isr &= ~GMAC_ISR_PDRSFT_Msk;
+    d.respFupWait = Transmit(&d.pdelayResp);
+}
+
+/* Syncs of one master are followed, another one is only taken over once the
+ * current one went silent */
+static bool FromMaster(const uint8_t *pMsg, bool sync)
+{
+    const uint8_t *port = &pMsg[OFS_SOURCE_PORT];
+    uint16_t number = Get16(&port[8]);
+
+    if ((0 == memcmp(port, d.st.masterIdentity, sizeof(d.st.masterIdentity))) && (number == d.st.masterPort)) {
+        return true;
+    }
+    if (!sync || ((GM_BB_FREERUN != d.st.state) && (GM_BB_HOLDOVER != d.st.state))) {
+        return false;
+    }
+    memcpy(d.st.masterIdentity, port, sizeof(d.st.masterIdentity));
+    d.st.masterPort = number;
+    d.syncPending = false;
+    return true;
+}
+
+/* Transparent clock: the messages of the master go on as they came in, from
+ * the first link delay result on */
+static void Relay(const uint8_t *pMsg, uint16_t len, int64_t ingressNs)
+{
+    if ((NULL != d.relay) && d.st.pathDelayValid) {
+        d.relay(pMsg, (uint16_t)(len - PTP_FRAME_ETH_HEADER_LEN), ingressNs, d.st.pathDelayNs);
+    }
+}
+
+static void SendPdelayReq(uint32_t nowMs)
+{
+    if (d.pdPending) {
+        d.st.pdelayLostCnt++;
+    }
+    d.pdelaySeq++;
+    ptpFrameSetSequenceId(&d.pdelayReq, d.pdelaySeq);
+    d.isr &= ~GMAC_ISR_PDRQFT_Msk;
+    d.pdT1Valid = false;
+    d.pdRespValid = false;
+    d.pdPending = Transmit(&d.pdelayReq);
+    if (d.pdPending) {
+        d.nextPdelayMs = nowMs + GM_BB_PDELAY_INTERVAL_MS;
+    }
+}
+
+/* TSU_CMP is raised when the seconds match and TN[29:8] equals NSC, that is
+ * within the first 256 ns of the next second */
+static void ArmCompare(void)
+{
+    d.cmpArmed = true;
+    d.cmpSec = GMAC_REGS->GMAC_TSL + 1u;
+    GMAC_REGS->GMAC_NSC = GMAC_NSC_NANOSEC(0);
+    GMAC_REGS->GMAC_SCH = GMAC_SCH_SEC(0);
+    GMAC_REGS->GMAC_SCL = GMAC_SCL_SEC(d.cmpSec);
+}
+
+static int64_t ReadTs(const volatile uint32_t *pSec, const volatile uint32_t *pNs)
+{
+    return ((int64_t)*pSec * NS_PER_SEC) + (int64_t)(*pNs & 0x3FFFFFFFu);
+}
+
+static int64_t ReadTime(void)
+{
+    uint32_t sec = GMAC_REGS->GMAC_TSL;
+    uint32_t ns = GMAC_REGS->GMAC_TN;
+    if (GMAC_REGS->GMAC_TSL != sec) {
+        sec = GMAC_REGS->GMAC_TSL;
+        ns = GMAC_REGS->GMAC_TN;
+    }
+    return ((int64_t)sec * NS_PER_SEC) + (int64_t)ns;
+}
+
+/* t1: origin at the master with all corrections, t2: TSU at ingress */
+static void ProcessSync(int64_t t1, int64_t t2, uint32_t nowMs)
+{
+    int64_t offset;
+
+    d.lastSyncMs = nowMs;
+    if (!d.st.pathDelayValid) {
+        return;
+    }
+    offset = t2 - t1 - d.st.pathDelayNs;
+    d.st.offsetNs = Clamp32(offset);
+    if (d.settle > 0u) {
+        /* Rate or phase was changed for the Sync in flight */
+        d.settle--;
+        return;
+    }
+
+    switch (d.st.state) {
+        case GM_BB_FREERUN:
+            if ((offset > GM_BB_STEP_THRESHOLD_NS) || (offset < -GM_BB_STEP_THRESHOLD_NS)) {
+                Step(-offset);
+            }
+            d.refValid = false;
+            d.st.state = GM_BB_ACQUIRE;
+            break;
+        case GM_BB_ACQUIRE:
+            if (!d.refValid) {
+                d.refT1 = t1;
+                d.refT2 = t2;
+                d.refValid = true;
+                break;
+            }
+            if ((t1 - d.refT1) < ((int64_t)GM_BB_FREQ_WINDOW_MS * 1000000)) {
+                break;
+            }
+            {
+                double freqErrPpb = ((double)((t2 - d.refT2) - (t1 - d.refT1)) * 1e9) / (double)(t1 - d.refT1);
+                d.driftPpb = d.st.freqPpb - freqErrPpb;
+            }
+            ApplyRate(d.driftPpb);
+            if ((offset > GM_BB_STEP_THRESHOLD_NS) || (offset < -GM_BB_STEP_THRESHOLD_NS)) {
+                Step(-offset);
+            }
+            d.lockCnt = 0;
+            d.settle = 1;
+            d.st.offsetAvgNs = Clamp32((offset < 0) ? -offset : offset);
+            d.st.state = GM_BB_TRACK;
+            break;
+        case GM_BB_HOLDOVER:
+            d.lockCnt = 0;
+            d.st.state = GM_BB_TRACK;
+            /* fall through */
+        case GM_BB_TRACK:
+        case GM_BB_LOCKED:
+            if ((offset > GM_BB_STEP_THRESHOLD_NS) || (offset < -GM_BB_STEP_THRESHOLD_NS)) {
+                Step(-offset);
+                d.lockCnt = 0;
+                d.settle = 1;
+                d.st.state = GM_BB_TRACK;
+                break;
+            }
+            d.driftPpb -= GM_BB_KI * (double)offset;
+            if (d.driftPpb > GM_BB_MAX_PPB) {
+                d.driftPpb = GM_BB_MAX_PPB;
+            } else if (d.driftPpb < -GM_BB_MAX_PPB) {
+                d.driftPpb = -GM_BB_MAX_PPB;
+            }
+            ApplyRate(d.driftPpb - (GM_BB_KP * (double)offset));
+            {
+                int32_t absNs = (d.st.offsetNs < 0) ? -d.st.offsetNs : d.st.offsetNs;
+                d.st.offsetAvgNs += (absNs - d.st.offsetAvgNs) / 8;
+                if (absNs <= GM_BB_LOCK_NS) {
+                    if (d.lockCnt < GM_BB_LOCK_COUNT) {
+                        d.lockCnt++;
+                    }
+                } else {
+                    d.lockCnt = 0;
+                }
+                if ((GM_BB_TRACK == d.st.state) && (d.lockCnt >= GM_BB_LOCK_COUNT)) {
+                    d.st.state = GM_BB_LOCKED;
+                    d.ppsEnabled = true;
+                } else if ((GM_BB_LOCKED == d.st.state) && (absNs > GM_BB_UNLOCK_NS)) {
+                    d.lockCnt = 0;
+                    d.st.state = GM_BB_TRACK;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* Two-step Pdelay, the neighbour rate ratio is taken as 1 */
+static void ProcessPdelay(int64_t t1, int64_t t2, int64_t t3, int64_t t4)
+{
+    int64_t delay = ((t4 - t1) - (t3 - t2)) / 2;
+
+    if ((delay < 0) || (delay > GM_BB_MAX_PATH_DELAY_NS)) {
+        d.st.pdelayRejectCnt++;
+        return;
+    }
+    if (!d.st.pathDelayValid) {
+        d.delayAvgNs = (double)delay;
+        d.st.pathDelayValid = true;
+    } else {
+        d.delayAvgNs += ((double)delay - d.delayAvgNs) / 8.0;
+    }
+    d.st.pathDelayNs = (int32_t)(d.delayAvgNs + 0.5);
+}
+
+static void ServoService(uint32_t nowMs)
+{
+    uint32_t elapsed = d.serviceValid ? (nowMs - d.lastServiceMs) : 0u;
+
+    d.lastServiceMs = nowMs;
+    d.serviceValid = true;
+    /* The part of the rate the increment cannot resolve */
+    d.fineAccNs += d.fineRatePpb * (double)elapsed * 1e-3;
+    if (d.fineAccNs >= (double)GM_BB_DITHER_NS) {
+        int32_t ns = (int32_t)d.fineAccNs;
+        d.tsu->stepNs(ns);
+        d.fineAccNs -= (double)ns;
+    }
+    if ((GM_BB_FREERUN == d.st.state) || (GM_BB_HOLDOVER == d.st.state) ||
+        ((nowMs - d.lastSyncMs) <= GM_BB_SYNC_TIMEOUT_MS)) {
+        return;
+    }
+    d.st.syncTimeoutCnt++;
+    d.refValid = false;
+    d.syncPending = false;
+    if (GM_BB_ACQUIRE == d.st.state) {
+        d.st.state = GM_BB_FREERUN;
+    } else {
+        /* Keep the learned frequency, drop the proportional part */
+        ApplyRate(d.driftPpb);
+        d.st.state = GM_BB_HOLDOVER;
+    }
+}
+
+/* Whole ns in TI, 2^-16 ns in TISUBN, rounded down. The remainder is
+ * applied by ServoService(). */
+static void ApplyRate(double ppb)
+{
+    double inc;
+    uint8_t ns;
+    uint16_t subNs;
+
+    if (ppb > GM_BB_MAX_PPB) {
+        ppb = GM_BB_MAX_PPB;
+    } else if (ppb < -GM_BB_MAX_PPB) {
+        ppb = -GM_BB_MAX_PPB;
+    }
+    inc = NOMINAL_INC_NS * (1.0 + (ppb * 1e-9));
+    ns = (uint8_t)inc;
+    subNs = (uint16_t)((inc - (double)ns) * 65536.0);
+    d.tsu->setIncrement(ns, subNs);
+    d.fineRatePpb = ((inc - ((double)ns + ((double)subNs / 65536.0))) / NOMINAL_INC_NS) * 1e9;
+    d.st.freqPpb = ppb;
+}
+
+static void Step(int64_t ns)
+{
+    d.tsu->stepNs(ns);
+    d.st.stepCnt++;
+    d.refValid = false;
+}
+
+static uint16_t Get16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+/* 48 bit seconds, only the lower 32 bit are of use until 2106 */
+static int64_t GetTimestamp(const uint8_t *pMsg)
+{
+    const uint8_t *p = &pMsg[OFS_TIMESTAMP + 2];
+    uint32_t sec = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    uint32_t ns = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | p[7];
+    return ((int64_t)sec * NS_PER_SEC) + ns;
+}
+
+/* correctionField in ns, the sub-ns part is dropped */
+static int64_t GetCorrection(const uint8_t *pMsg)
+{
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < 8u; i++) {
+        v = (v << 8) | pMsg[OFS_CORRECTION + i];
+    }
+    return (int64_t)v / 65536;
+}
+
+static int32_t Clamp32(int64_t v)
+{
+    return (int32_t)((v > INT32_MAX) ? INT32_MAX : ((v < -INT32_MAX) ? -INT32_MAX : v));
+}
+
+static void HwSetIncrement(uint8_t ns, uint16_t subNs)
+{
+    GMAC_REGS->GMAC_TISUBN = GMAC_TISUBN_LSBTIR(subNs);
+    GMAC_REGS->GMAC_TI = GMAC_TI_CNS(ns);
+}
+
+/* TA takes less than a second, larger steps load the timer */
+static void HwStepNs(int64_t ns)
+{
+    int64_t t;
+
+    if ((ns > -NS_PER_SEC) && (ns < NS_PER_SEC)) {
+        GMAC_REGS->GMAC_TA = (ns < 0) ? (GMAC_TA_ADJ_Msk | GMAC_TA_ITDT((uint32_t)-ns)) : GMAC_TA_ITDT((uint32_t)ns);
+        return;
+    }
+    t = ReadTime() + ns;
+    GMAC_REGS->GMAC_TSL = (uint32_t)(t / NS_PER_SEC);
+    GMAC_REGS->GMAC_TN = (uint32_t)(t % NS_PER_SEC);
+    d.cmpArmed = false;
+}
+
+static void SimSetIncrement(uint8_t ns, uint16_t subNs)
+{
+    sim.incRatio = ((double)ns + ((double)subNs / 65536.0)) / NOMINAL_INC_NS;
+}
+
+static void SimStepNs(int64_t ns)
+{
+    bool load = (ns <= -NS_PER_SEC) || (ns >= NS_PER_SEC);
+
+    sim.tsuSec += ns / NS_PER_SEC;
+    sim.tsuNs += (double)(ns % NS_PER_SEC);
+    while (sim.tsuNs >= (double)NS_PER_SEC) {
+        sim.tsuNs -= (double)NS_PER_SEC;
+        sim.tsuSec++;
+    }
+    while (sim.tsuNs < 0.0) {
+        sim.tsuNs += (double)NS_PER_SEC;
+        sim.tsuSec--;
+    }
+    if (load) {
+        sim.cmpSec = sim.tsuSec + 1;
+    }
+}
+
+/* TSU aheadNs of TAI from now */
+static int64_t SimTsu(double aheadNs)
+{
+    return (sim.tsuSec * NS_PER_SEC) + (int64_t)(sim.tsuNs + (aheadNs * SimRate()));
+}
+
+static int64_t SimStamp(int64_t ns)
+{
+    return ns - (ns % SIM_TIMESTAMP_NS);
+}
+
+static double SimRate(void)
+{
+    return (1.0 + (sim.tsuPpm * 1e-6)) * sim.incRatio;
+}
+
+/* TSU pulse of pulseSec at edgeNs of TAI since start, stored for the TAI second it stands for */
+static void SimPps(double edgeNs, int64_t pulseSec, GmBackboneSimResult_t *pResult, int32_t *pPpsErrorNs, uint32_t durationS)
+{
+    double err = ((double)(pulseSec - SIM_TAI_START) * 1e9) - edgeNs;
+    int64_t sec;
+
+    while (err > (double)(NS_PER_SEC / 2)) {
+        err -= (double)NS_PER_SEC;
+    }
+    while (err <= -(double)(NS_PER_SEC / 2)) {
+        err += (double)NS_PER_SEC;
+    }
+    sec = (int64_t)(((edgeNs + err) / 1e9) + 0.5);
+    if (d.ppsEnabled && (NULL != pPpsErrorNs) && (sec >= 0) && (sec <= (int64_t)durationS)) {
+        pPpsErrorNs[sec] = (int32_t)err;
+    }
+    pResult->finalNs = (int32_t)err;
+    if ((0u != pResult->lockS) && (Clamp32((int64_t)((err < 0.0) ? -err : err)) > pResult->maxLockedNs)) {
+        pResult->maxLockedNs = Clamp32((int64_t)((err < 0.0) ? -err : err));
+    }
+}
@@ -0,0 +1,171 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Boundary clock backbone port
+
+  File Name:
+    gm_backbone.h
+
+  Summary:
+    gPTP slave port on the GMAC (100 Mbit/s RMII), its timer is the reference
+    of the grandmaster on the T1S segment
+
+  Description:
+    The GMAC timestamps PTP event frames with its own timer (TSU). This port
+    measures the link delay to its backbone neighbour by Pdelay and steers the
+    TSU to the Sync/Follow_Up of the backbone master with a PI loop. From the
+    first lock on, the TSU compare raises an event at every full second, in
+    holdover as well. In boundary clock mode the event system routes it to the
+    TC4 capture in place of the external 1PPS, so GmDiscipline steers the MAC-PHY clock to the TSU like it does to a GNSS
+    receiver, and the seconds come from GmBackbone_GetPps() instead of NMEA.
+    The TSU increment has a resolution of 2^-16 ns, about 1.8 ppm at 120 MHz.
+    The rest of a rate correction is applied as TA steps of a few ns.
+*******************************************************************************/
+
+#ifndef GM_BACKBONE_H
+#define GM_BACKBONE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GM_BB_PHY_ADDRESS           (0)         /* RMII PHY on the Ethernet PHY header */
+#define GM_BB_TSU_CLOCK_HZ          (120000000)
+#define GM_BB_PORT_NUMBER           (2)         /* the T1S port of the GM is port 1 */
+#define GM_BB_PDELAY_INTERVAL_MS    (1000)
+#define GM_BB_MAX_PATH_DELAY_NS     (10000)     /* larger results are dropped */
+#define GM_BB_SYNC_TIMEOUT_MS       (1000)
+#define GM_BB_LINK_POLL_MS          (500)
+#define GM_BB_STEP_THRESHOLD_NS     (20000)     /* larger offsets are stepped, not slewed */
+#define GM_BB_FREQ_WINDOW_MS        (1000)      /* first frequency estimate over this span */
+#define GM_BB_LOCK_NS               (100)
+#define GM_BB_LOCK_COUNT            (16)        /* Syncs within GM_BB_LOCK_NS until locked */
+#define GM_BB_UNLOCK_NS             (1000)
+#define GM_BB_MAX_PPB               (200000)
+#define GM_BB_KP                    (1.6)       /* ppb per ns of offset, tuned for 8 Syncs/s */
+#define GM_BB_KI                    (0.2)
+#define GM_BB_DITHER_NS             (4)         /* smallest TA step of the fine rate correction */
+#define GM_BB_SIM_MAX_S             (300)
+
+typedef enum
+{
+    GM_BB_FREERUN = 0,          /* no Sync, the TSU runs on its own */
+    GM_BB_ACQUIRE,              /* measuring frequency, phase is stepped once known */
+    GM_BB_TRACK,                /* PI loop closed */
+    GM_BB_LOCKED,               /* within GM_BB_LOCK_NS */
+    GM_BB_HOLDOVER              /* Syncs lost, last frequency kept */
+} GmBackboneState_t;
+
+typedef struct
+{
+    GmBackboneState_t state;
+    bool linkUp;
+    bool speed100;
+    bool fullDuplex;
+    int32_t offsetNs;           /* TSU against the backbone master, positive is ahead */
+    int32_t offsetAvgNs;        /* magnitude, averaged */
+    double freqPpb;             /* correction currently applied */
+    int32_t pathDelayNs;
+    bool pathDelayValid;
+    uint32_t syncCnt;
+    uint32_t followUpCnt;
+    uint32_t syncTimeoutCnt;
+    uint32_t stepCnt;
+    uint32_t pdelayCnt;         /* own requests completed */
+    uint32_t pdelayLostCnt;
+    uint32_t pdelayRejectCnt;
+    uint32_t pdelayAnsweredCnt; /* requests of the neighbour */
+    uint32_t rxFrameCnt;
+    uint32_t txBusyCnt;
+    uint32_t ppsCnt;
+    uint32_t taiSec;            /* second of the last TSU pulse */
+    uint8_t masterIdentity[8];
+    uint16_t masterPort;
+} GmBackboneStatus_t;
+
+/* Receives Sync, Follow_Up and Announce of the master for a transparent clock,
+ * PTP header on. ingressNs is the TSU timestamp of a Sync, linkDelayNs the
+ * path delay of the port. */
+typedef void (*GmBackboneRelay_t)(const uint8_t *pMsg, uint16_t len, int64_t ingressNs, int32_t linkDelayNs);
+
+/* Synthetic backbone for GmBackbone_SelfTest(), the master runs on TAI */
+typedef struct
+{
+    double tsuPpm;              /* TSU clock crystal error */
+    int64_t tsuOffsetNs;        /* TSU against TAI at start */
+    uint32_t pathDelayNs;
+    uint32_t syncJitterNs;      /* peak to peak, zero mean, on the Sync path only */
+    uint32_t syncGapStartS;     /* Syncs missing from here, 0 for none */
+    uint32_t syncGapS;
+    uint32_t durationS;         /* up to GM_BB_SIM_MAX_S */
+} GmBackboneSimCase_t;
+
+typedef struct
+{
+    uint32_t lockS;             /* seconds until locked, 0 if never */
+    uint32_t stepCnt;
+    int32_t maxLockedNs;        /* worst TSU pulse against TAI once locked */
+    int32_t finalNs;
+    int32_t delayErrorNs;       /* measured path delay against the true one */
+    double residualPpb;         /* rate error left at the end, fine correction included */
+    GmBackboneState_t finalState;
+    bool holdoverSeen;
+} GmBackboneSimResult_t;
+
+/* Sets up the GMAC, the PHY and the TSU, the port runs from here on. The MAC
+ * address is the one of the backbone port, the clock identity is shared with
+ * the T1S port. */
+void GmBackbone_Init(const uint8_t mac[6], const uint8_t clockIdentity[8]);
+
+/* Stops receive and transmit, the TSU keeps running */
+void GmBackbone_Stop(void);
+
+/* Polls the PHY, the receive queue and the timestamp events */
+void GmBackbone_Service(uint32_t nowMs);
+
+/* True once per TSU pulse while the TSU carries backbone time, with the TAI
+ * second the pulse marks */
+bool GmBackbone_GetPps(uint32_t *pTaiSec);
+
+/* The master's messages go to relay as well, NULL stops it. Init clears it. */
+void GmBackbone_SetRelay(GmBackboneRelay_t relay);
+
+void GmBackbone_GetStatus(GmBackboneStatus_t *pStatus);
+const char *GmBackbone_StateName(GmBackboneState_t state);
+
+/* Runs the servo against a simulated backbone master and TSU. The TSU pulse
+ * against TAI goes to pPpsErrorNs[second] (durationS + 1 entries, may be
+ * NULL), seconds without a pulse are GM_DISC_SIM_NO_PULSE. The live state is
+ * lost and has to be set up again with GmBackbone_Init(). */
+void GmBackbone_SelfTest(const GmBackboneSimCase_t *pCase, GmBackboneSimResult_t *pResult, int32_t *pPpsErrorNs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GM_BACKBONE_H */
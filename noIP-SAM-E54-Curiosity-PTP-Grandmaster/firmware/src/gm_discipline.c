@@ -0,0 +1,721 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Grandmaster clock discipline
+
+  File Name:
+    gm_discipline.c
+
+  Summary:
+    1PPS servo, NMEA time of day and the clock quality derived from both
+
+  Description:
+    A pulse is evaluated once the MAC-PHY pulse next to it is captured for
+    sure, half a second after the external edge. The phase is the distance
+    of the two edges, the MAC-PHY frequency error comes from the distance of
+    consecutive MAC-PHY edges. Both are scaled by the external second as
+    counted by the capture counter.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "gm_discipline.h"
+#include "ptp_frame.h"
+
+#define NS_PER_SEC                  (1000000000LL)
+#define NMEA_MAX_LEN                (82)
+#define TOD_CHECK_INTERVAL          (60)    /* pulses between time of day checks once valid */
+#define SIM_STEP_MS                 (10)
+#define SIM_NMEA_DELAY_MS           (200)
+#define SIM_TAI_START               (1760000037UL)
+
+#define CLOCK_CLASS_LOCKED          (6)
+#define CLOCK_CLASS_HOLDOVER        (7)
+#define CLOCK_CLASS_DEGRADED        (52)
+#define CLOCK_VARIANCE_LOCKED       (0x4E5D)
+
+typedef struct
+{
+    const GmDisciplineActuator_t *act;
+    GmDisciplineStatus_t st;
+    uint32_t ticksNominal;
+    /* Written by the capture interrupt */
+    volatile uint32_t extTicks;
+    volatile uint32_t extCnt;
+    volatile uint32_t lanTicks[2];      /* [0] is the latest */
+    volatile uint32_t lanCnt;
+    volatile bool extNew;
+    /* Pulse evaluation */
+    uint32_t extPrev;
+    uint32_t lanPrev;
+    uint32_t extCntDone;
+    uint32_t lastExtMs;
+    uint32_t holdoverStartMs;
+    double driftPpb;
+    double freqErrPpb;
+    uint8_t lockCnt;
+    uint8_t settle;
+    bool extPrevValid;
+    bool lanPrevValid;
+    bool freqValid;
+    /* Time of day */
+    char nmea[NMEA_MAX_LEN + 1];
+    uint8_t nmeaLen;
+    bool nmeaActive;
+    uint32_t todTai;                    /* TAI of the pulse number todExtCnt */
+    uint32_t todExtCnt;
+    uint32_t todCheckCnt;
+    bool todKnown;
+    bool todPending;
+    uint8_t timeSource;
+} GmDiscipline_t;
+
+typedef struct
+{
+    double lanPpm;
+    double mcuPpm;
+    double corrPpb;
+    double ticksPerMs;
+    int64_t lanSec;
+    double lanNs;
+    bool readPending;
+} GmDisciplineSim_t;
+
+static GmDiscipline_t d;
+static GmDisciplineSim_t sim;
+
+static void ProcessPps(uint32_t ext, uint32_t nowMs);
+static bool PickLanEdge(uint32_t ext, uint32_t *pLan);
+static void ApplyRate(double ppb);
+static void Step(int64_t ns);
+static bool NmeaParse(const char *s, uint32_t *pUtc);
+static bool NmeaField(const char *s, uint8_t idx, const char **pField);
+static uint32_t NmeaNumber(const char *p, uint8_t digits, bool *pOk);
+static int32_t DaysFromCivil(int32_t y, uint32_t mo, uint32_t dd);
+static void CivilFromDays(int32_t z, int32_t *pY, uint32_t *pMo, uint32_t *pD);
+static uint8_t AccuracyFromNs(int32_t ns);
+static int32_t AbsNs(int32_t ns);
+static bool SimSetRate(double ppb);
+static bool SimStepNs(int32_t ns);
+static bool SimSetTime(uint32_t sec, uint32_t nsec);
+static bool SimReadTime(void);
+static void SimFeedNmea(uint32_t tai);
+
+static const GmDisciplineActuator_t simActuator = {SimSetRate, SimStepNs, SimSetTime, SimReadTime};
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         PUBLIC FUNCTIONS                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+void GmDiscipline_Init(const GmDisciplineActuator_t *pActuator, uint32_t ticksNominal)
+{
+    memset(&d, 0, sizeof(d));
+    d.act = pActuator;
+    d.ticksNominal = ticksNominal;
+    d.st.state = GM_DISC_FREERUN;
+    d.timeSource = GM_DISC_TIME_SOURCE_GNSS;
+    ApplyRate(0.0);
+}
+
+void GmDiscipline_OnExtPps(uint32_t ticks)
+{
+    d.extTicks = ticks;
+    d.extCnt++;
+    d.extNew = true;
+}
+
+void GmDiscipline_OnLanPps(uint32_t ticks)
+{
+    d.lanTicks[1] = d.lanTicks[0];
+    d.lanTicks[0] = ticks;
+    d.lanCnt++;
+}
+
+void GmDiscipline_Service(uint32_t ticksNow, uint32_t nowMs)
+{
+    if (d.extNew && ((ticksNow - d.extTicks) > (d.ticksNominal / 2u))) {
+        d.extNew = false;
+        d.extCntDone = d.extCnt;
+        ProcessPps(d.extTicks, nowMs);
+    }
+    if (d.extPrevValid && ((nowMs - d.lastExtMs) > GM_DISC_PPS_TIMEOUT_MS)) {
+        d.extPrevValid = false;
+        d.lanPrevValid = false;
+        if ((GM_DISC_TRACK == d.st.state) || (GM_DISC_LOCKED == d.st.state)) {
+            /* Keep the learned frequency, drop the proportional part */
+            ApplyRate(d.driftPpb);
+            d.holdoverStartMs = nowMs;
+            d.st.state = GM_DISC_HOLDOVER;
+        } else if (GM_DISC_ACQUIRE == d.st.state) {
+            d.st.state = GM_DISC_FREERUN;
+        }
+    }
+    if (GM_DISC_HOLDOVER == d.st.state) {
+        d.st.holdoverS = (nowMs - d.holdoverStartMs) / 1000u;
+    }
+    if (d.todKnown && !d.todPending && (d.todCheckCnt == 0u) && (GM_DISC_ACQUIRE < d.st.state)) {
+        d.todPending = (NULL != d.act) && d.act->readTime();
+    }
+}
+
+bool GmDiscipline_NmeaPutChar(char c)
+{
+    if ('$' == c) {
+        d.nmeaActive = true;
+        d.nmeaLen = 0;
+    }
+    if (!d.nmeaActive) {
+        return false;
+    }
+    if (('\r' == c) || ('\n' == c)) {
+        uint32_t utc;
+        d.nmea[d.nmeaLen] = '\0';
+        d.nmeaActive = false;
+        if (NmeaParse(d.nmea, &utc)) {
+            /* The sentence tells the time of the pulse ahead of it */
+            GmDiscipline_SetTod(utc + GM_DISC_UTC_OFFSET_S);
+            d.st.nmeaCnt++;
+        } else {
+            d.st.nmeaErrorCnt++;
+        }
+    } else if (d.nmeaLen < NMEA_MAX_LEN) {
+        d.nmea[d.nmeaLen++] = c;
+    } else {
+        d.nmeaActive = false;
+        d.st.nmeaErrorCnt++;
+    }
+    return true;
+}
+
+void GmDiscipline_SetTod(uint32_t taiSec)
+{
+    d.todTai = taiSec;
+    d.todExtCnt = d.extCnt;
+    d.todKnown = true;
+}
+
+void GmDiscipline_SetTimeSource(uint8_t timeSource)
+{
+    d.timeSource = timeSource;
+}
+
+void GmDiscipline_OnLanTime(bool success, uint32_t sec, uint32_t nsec, uint32_t ticks)
+{
+    uint32_t elapsed = ticks - d.extTicks;
+    d.todPending = false;
+    if (!success || (0u == d.st.ticksPerSec) || (elapsed >= d.st.ticksPerSec) || (d.extCnt != d.extCntDone)) {
+        /* Another pulse came in meanwhile, try with the next sentence */
+        return;
+    }
+    int64_t elapsedNs = ((int64_t)elapsed * NS_PER_SEC) / d.st.ticksPerSec;
+    int64_t lanAtPps = ((int64_t)sec * NS_PER_SEC) + nsec - elapsedNs;
+    int64_t lanSec = (lanAtPps + (NS_PER_SEC / 2)) / NS_PER_SEC;
+    int64_t tai = (int64_t)d.todTai + (int32_t)(d.extCnt - d.todExtCnt);
+    int64_t diff = tai - lanSec;
+
+    d.todCheckCnt = TOD_CHECK_INTERVAL;
+    if (0 == diff) {
+        d.st.todValid = true;
+        return;
+    }
+    d.st.todValid = false;
+    d.todCheckCnt = 0;
+    if ((diff >= -2) && (diff <= 2)) {
+        /* MAC_TA takes up to one second per write, the next sentence does the rest */
+        Step((diff > 0) ? NS_PER_SEC : -NS_PER_SEC);
+    } else if (NULL != d.act) {
+        int64_t target = (tai * NS_PER_SEC) + elapsedNs;
+        if (d.act->setTime((uint32_t)(target / NS_PER_SEC), (uint32_t)(target % NS_PER_SEC))) {
+            d.st.stepCnt++;
+            d.st.timeBaseIndicator++;
+            d.st.lastPhaseChangeNs = diff * NS_PER_SEC;
+            d.lanPrevValid = false;
+            d.lockCnt = 0;
+            d.st.state = GM_DISC_TRACK;
+        }
+    }
+}
+
+void GmDiscipline_GetQuality(GmDisciplineQuality_t *pQuality)
+{
+    GmDisciplineQuality_t *q = pQuality;
+    q->clockClass = PTP_FRAME_DEFAULT_CLOCK_CLASS;
+    q->clockAccuracy = PTP_FRAME_DEFAULT_ACCURACY;
+    q->offsetScaledLogVariance = PTP_FRAME_DEFAULT_VARIANCE;
+    q->timeSource = PTP_FRAME_DEFAULT_TIME_SOURCE;
+    q->currentUtcOffset = GM_DISC_UTC_OFFSET_S;
+    q->utcOffsetValid = d.st.todValid;
+    q->timeTraceable = false;
+    q->frequencyTraceable = false;
+    if (!d.st.todValid) {
+        return;
+    }
+    if (GM_DISC_LOCKED == d.st.state) {
+        q->clockClass = CLOCK_CLASS_LOCKED;
+        q->clockAccuracy = AccuracyFromNs(d.st.offsetAvgNs);
+        q->offsetScaledLogVariance = CLOCK_VARIANCE_LOCKED;
+        q->timeSource = d.timeSource;
+        q->timeTraceable = true;
+        q->frequencyTraceable = true;
+    } else if (GM_DISC_HOLDOVER == d.st.state) {
+        bool inSpec = (d.st.holdoverS <= GM_DISC_HOLDOVER_LIMIT_S);
+        q->clockClass = inSpec ? CLOCK_CLASS_HOLDOVER : CLOCK_CLASS_DEGRADED;
+        q->timeSource = d.timeSource;
+        q->timeTraceable = inSpec;
+        q->frequencyTraceable = inSpec;
+    }
+}
+
+void GmDiscipline_GetStatus(GmDisciplineStatus_t *pStatus)
+{
+    *pStatus = d.st;
+}
+
+const char *GmDiscipline_StateName(GmDisciplineState_t state)
+{
+    static const char *names[] = {"freerun", "acquire", "track", "locked", "holdover"};
+    return (state <= GM_DISC_HOLDOVER) ? names[state] : "?";
+}
+
+/* Simulated time runs in SIM_STEP_MS steps. The MAC-PHY clock advances by its
+ * crystal error plus the servo correction, the capture counter by its own
+ * crystal error. Edges are placed in between steps by interpolation, the
+ * external one is moved by the reference offset of its second. */
+void GmDiscipline_SelfTest(const GmDisciplineSimCase_t *pCase, GmDisciplineSimResult_t *pResult)
+{
+    uint32_t ticksNominal = (0u != d.ticksNominal) ? d.ticksNominal : 60000000u;
+    uint32_t steps = pCase->durationS * (1000u / SIM_STEP_MS);
+    GmDisciplineQuality_t q;
+
+    memset(pResult, 0, sizeof(GmDisciplineSimResult_t));
+    memset(&sim, 0, sizeof(sim));
+    sim.lanPpm = pCase->lanPpm;
+    sim.mcuPpm = pCase->mcuPpm;
+    sim.ticksPerMs = (ticksNominal / 1000.0) * (1.0 + (pCase->mcuPpm * 1e-6));
+    sim.lanSec = (int64_t)SIM_TAI_START + (pCase->lanOffsetNs / NS_PER_SEC);
+    sim.lanNs = (double)(pCase->lanOffsetNs % NS_PER_SEC);
+    if (sim.lanNs < 0.0) {
+        sim.lanNs += (double)NS_PER_SEC;
+        sim.lanSec--;
+    }
+    GmDiscipline_Init(&simActuator, ticksNominal);
+
+    for (uint32_t i = 1; i <= steps; i++) {
+        uint32_t ms = i * SIM_STEP_MS;
+        uint32_t sec = ms / 1000u;
+        double rate = (1.0 + (sim.lanPpm * 1e-6)) * (1.0 + (sim.corrPpb * 1e-9));
+        double advance = SIM_STEP_MS * 1e6 * rate;
+        int32_t refNs = (NULL != pCase->pRefOffsetNs) ? pCase->pRefOffsetNs[sec] : 0;
+        bool gap = ((pCase->ppsGapStartS != 0u) && (sec >= pCase->ppsGapStartS) &&
+                    (sec < (pCase->ppsGapStartS + pCase->ppsGapS))) || (GM_DISC_SIM_NO_PULSE == refNs);
+
+        if ((sim.lanNs + advance) >= (double)NS_PER_SEC) {
+            double frac = ((double)NS_PER_SEC - sim.lanNs) / advance;
+            double edgeMs = (ms - SIM_STEP_MS) + (frac * SIM_STEP_MS);
+            GmDiscipline_OnLanPps((uint32_t)(uint64_t)(edgeMs * sim.ticksPerMs));
+            sim.lanNs += advance - (double)NS_PER_SEC;
+            sim.lanSec++;
+        } else {
+            sim.lanNs += advance;
+        }
+        if ((0u == (ms % 1000u)) && !gap) {
+            int64_t errNs = ((sim.lanSec - (int64_t)(SIM_TAI_START + sec)) * NS_PER_SEC) + (int64_t)sim.lanNs;
+            GmDiscipline_OnExtPps((uint32_t)(uint64_t)((ms - (refNs * 1e-6)) * sim.ticksPerMs));
+            pResult->finalNs = (int32_t)((errNs > INT32_MAX) ? INT32_MAX : ((errNs < -INT32_MAX) ? -INT32_MAX : errNs));
+            pResult->todErrorNs = errNs;
+            if ((0u == pResult->lockS) && (GM_DISC_LOCKED == d.st.state)) {
+                pResult->lockS = sec;
+            }
+            if ((0u != pResult->lockS) && (AbsNs(pResult->finalNs) > pResult->maxLockedNs)) {
+                pResult->maxLockedNs = AbsNs(pResult->finalNs);
+            }
+        }
+        if (((ms % 1000u) == SIM_NMEA_DELAY_MS) && !gap && (sec > 0u)) {
+            SimFeedNmea(SIM_TAI_START + sec);
+        }
+        GmDiscipline_Service((uint32_t)(uint64_t)(ms * sim.ticksPerMs), ms);
+        if (sim.readPending) {
+            sim.readPending = false;
+            GmDiscipline_OnLanTime(true, (uint32_t)sim.lanSec, (uint32_t)sim.lanNs, (uint32_t)(uint64_t)(ms * sim.ticksPerMs));
+        }
+        if (GM_DISC_HOLDOVER == d.st.state) {
+            pResult->holdoverSeen = true;
+        }
+    }
+    GmDiscipline_GetQuality(&q);
+    pResult->stepCnt = d.st.stepCnt;
+    pResult->residualPpb = (((1.0 + (sim.lanPpm * 1e-6)) * (1.0 + (sim.corrPpb * 1e-9))) - 1.0) * 1e9;
+    pResult->finalState = d.st.state;
+    pResult->finalClockClass = q.clockClass;
+    d.act = NULL;
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static void ProcessPps(uint32_t ext, uint32_t nowMs)
+{
+    uint32_t period = ext - d.extPrev;
+    uint32_t tolerance = (d.ticksNominal / 1000000u) * GM_DISC_TICK_TOLERANCE_PPM;
+    bool periodOk = d.extPrevValid && (period > (d.ticksNominal - tolerance)) && (period < (d.ticksNominal + tolerance));
+    uint32_t lan;
+
+    d.st.ppsCnt++;
+    d.lastExtMs = nowMs;
+    d.extPrev = ext;
+    d.extPrevValid = true;
+    if (d.todCheckCnt > 0u) {
+        d.todCheckCnt--;
+    }
+    if (d.todKnown) {
+        d.st.taiSec = d.todTai + (d.extCnt - d.todExtCnt);
+    }
+    if (!periodOk) {
+        /* First pulse after a gap, or a glitch */
+        d.st.ppsRejectCnt++;
+        d.lanPrevValid = false;
+        return;
+    }
+    d.st.ticksPerSec = period;
+    if (!PickLanEdge(ext, &lan)) {
+        d.st.ppsRejectCnt++;
+        d.lanPrevValid = false;
+        return;
+    }
+
+    int64_t offset = ((int64_t)(int32_t)(ext - lan) * NS_PER_SEC) / period;
+    while (offset > (NS_PER_SEC / 2)) {
+        offset -= NS_PER_SEC;
+    }
+    while (offset <= -(NS_PER_SEC / 2)) {
+        offset += NS_PER_SEC;
+    }
+    d.freqValid = false;
+    if (d.lanPrevValid) {
+        uint32_t lanPeriod = lan - d.lanPrev;
+        if ((lanPeriod > (period - tolerance)) && (lanPeriod < (period + tolerance))) {
+            d.freqErrPpb = (((double)period - (double)lanPeriod) * 1e9) / (double)lanPeriod;
+            d.freqValid = true;
+        }
+    }
+    d.lanPrev = lan;
+    d.lanPrevValid = true;
+    d.st.offsetNs = (int32_t)offset;
+    if (d.settle > 0u) {
+        /* Rate or phase was changed within the last period */
+        d.settle--;
+        return;
+    }
+
+    switch (d.st.state) {
+        case GM_DISC_FREERUN:
+            d.st.state = GM_DISC_ACQUIRE;
+            break;
+        case GM_DISC_ACQUIRE:
+            if (!d.freqValid) {
+                break;
+            }
+            d.driftPpb = d.st.freqPpb - d.freqErrPpb;
+            d.st.lastFreqChange = -d.freqErrPpb * 1e-9;
+            ApplyRate(d.driftPpb);
+            if ((offset > GM_DISC_STEP_THRESHOLD_NS) || (offset < -GM_DISC_STEP_THRESHOLD_NS)) {
+                Step(-offset);
+            } else {
+                d.st.timeBaseIndicator++;
+                d.st.lastPhaseChangeNs = 0;
+            }
+            d.lockCnt = 0;
+            d.settle = 1;
+            d.st.offsetAvgNs = AbsNs((int32_t)offset);
+            d.st.state = GM_DISC_TRACK;
+            break;
+        case GM_DISC_HOLDOVER:
+            d.st.holdoverS = 0;
+            d.lockCnt = 0;
+            d.st.state = GM_DISC_TRACK;
+            /* fall through */
+        case GM_DISC_TRACK:
+        case GM_DISC_LOCKED:
+            if ((offset > GM_DISC_STEP_THRESHOLD_NS) || (offset < -GM_DISC_STEP_THRESHOLD_NS)) {
+                Step(-offset);
+                d.lockCnt = 0;
+                d.settle = 1;
+                d.st.state = GM_DISC_TRACK;
+                break;
+            }
+            d.driftPpb -= GM_DISC_KI * (double)offset;
+            if (d.driftPpb > GM_DISC_MAX_PPB) {
+                d.driftPpb = GM_DISC_MAX_PPB;
+            } else if (d.driftPpb < -GM_DISC_MAX_PPB) {
+                d.driftPpb = -GM_DISC_MAX_PPB;
+            }
+            ApplyRate(d.driftPpb - (GM_DISC_KP * (double)offset));
+            d.st.offsetAvgNs += (AbsNs((int32_t)offset) - d.st.offsetAvgNs) / 8;
+            if (AbsNs((int32_t)offset) <= GM_DISC_LOCK_NS) {
+                if (d.lockCnt < GM_DISC_LOCK_COUNT) {
+                    d.lockCnt++;
+                }
+            } else {
+                d.lockCnt = 0;
+            }
+            if ((GM_DISC_TRACK == d.st.state) && (d.lockCnt >= GM_DISC_LOCK_COUNT)) {
+                d.st.state = GM_DISC_LOCKED;
+            } else if ((GM_DISC_LOCKED == d.st.state) && (AbsNs((int32_t)offset) > GM_DISC_UNLOCK_NS)) {
+                d.lockCnt = 0;
+                d.st.state = GM_DISC_TRACK;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* The MAC-PHY edge closest to the external one, either side of it */
+static bool PickLanEdge(uint32_t ext, uint32_t *pLan)
+{
+    uint32_t cnt = d.lanCnt;
+    uint32_t best = 0;
+    uint32_t bestDist = UINT32_MAX;
+
+    for (uint32_t i = 0; (i < 2u) && (i < cnt); i++) {
+        uint32_t l = d.lanTicks[i];
+        int32_t diff = (int32_t)(ext - l);
+        uint32_t dist = (diff < 0) ? (uint32_t)-diff : (uint32_t)diff;
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = l;
+        }
+    }
+    *pLan = best;
+    return (bestDist <= d.st.ticksPerSec);
+}
+
+static void ApplyRate(double ppb)
+{
+    if (ppb > GM_DISC_MAX_PPB) {
+        ppb = GM_DISC_MAX_PPB;
+    } else if (ppb < -GM_DISC_MAX_PPB) {
+        ppb = -GM_DISC_MAX_PPB;
+    }
+    if ((NULL != d.act) && d.act->setRate(ppb)) {
+        d.st.freqPpb = ppb;
+    }
+}
+
+static void Step(int64_t ns)
+{
+    if ((NULL != d.act) && d.act->stepNs((int32_t)ns)) {
+        d.st.stepCnt++;
+        d.st.timeBaseIndicator++;
+        d.st.lastPhaseChangeNs = ns;
+        d.lanPrevValid = false;
+    }
+}
+
+/* $xxZDA,hhmmss.ss,dd,mm,yyyy,... or $xxRMC,hhmmss.ss,A,...,ddmmyy,... with checksum */
+static bool NmeaParse(const char *s, uint32_t *pUtc)
+{
+    const char *star = strchr(s, '*');
+    const char *f;
+    uint8_t sum = 0;
+    bool ok = true;
+    uint32_t hh, mi, ss, dd, mo, yy;
+
+    if ((NULL == star) || (strlen(s) < 7u)) {
+        return false;
+    }
+    for (const char *p = &s[1]; p < star; p++) {
+        sum ^= (uint8_t)*p;
+    }
+    {
+        uint8_t given = 0;
+        for (uint8_t i = 1; i <= 2u; i++) {
+            char c = star[i];
+            given <<= 4;
+            if ((c >= '0') && (c <= '9')) {
+                given |= (uint8_t)(c - '0');
+            } else if ((c >= 'A') && (c <= 'F')) {
+                given |= (uint8_t)(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        if (given != sum) {
+            return false;
+        }
+    }
+    if (!NmeaField(s, 1, &f)) {
+        return false;
+    }
+    hh = NmeaNumber(&f[0], 2, &ok);
+    mi = NmeaNumber(&f[2], 2, &ok);
+    ss = NmeaNumber(&f[4], 2, &ok);
+    if (0 == strncmp(&s[3], "ZDA", 3)) {
+        ok = ok && NmeaField(s, 2, &f);
+        dd = ok ? NmeaNumber(f, 2, &ok) : 0u;
+        ok = ok && NmeaField(s, 3, &f);
+        mo = ok ? NmeaNumber(f, 2, &ok) : 0u;
+        ok = ok && NmeaField(s, 4, &f);
+        yy = ok ? NmeaNumber(f, 4, &ok) : 0u;
+    } else if (0 == strncmp(&s[3], "RMC", 3)) {
+        ok = ok && NmeaField(s, 2, &f) && ('A' == f[0]);
+        ok = ok && NmeaField(s, 9, &f);
+        dd = ok ? NmeaNumber(&f[0], 2, &ok) : 0u;
+        mo = ok ? NmeaNumber(&f[2], 2, &ok) : 0u;
+        yy = ok ? (2000u + NmeaNumber(&f[4], 2, &ok)) : 0u;
+    } else {
+        return false;
+    }
+    if (!ok || (hh > 23u) || (mi > 59u) || (ss > 60u) || (dd < 1u) || (dd > 31u) || (mo < 1u) || (mo > 12u) || (yy < 1970u)) {
+        return false;
+    }
+    *pUtc = ((uint32_t)DaysFromCivil((int32_t)yy, mo, dd) * 86400u) + (hh * 3600u) + (mi * 60u) + ss;
+    return true;
+}
+
+static bool NmeaField(const char *s, uint8_t idx, const char **pField)
+{
+    const char *p = s;
+    for (uint8_t i = 0; i < idx; i++) {
+        p = strchr(p, ',');
+        if (NULL == p) {
+            return false;
+        }
+        p++;
+    }
+    *pField = p;
+    return ((',' != *p) && ('*' != *p) && ('\0' != *p));
+}
+
+static uint32_t NmeaNumber(const char *p, uint8_t digits, bool *pOk)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < digits; i++) {
+        if ((p[i] < '0') || (p[i] > '9')) {
+            *pOk = false;
+            return 0;
+        }
+        v = (v * 10u) + (uint32_t)(p[i] - '0');
+    }
+    return v;
+}
+
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+static int32_t DaysFromCivil(int32_t y, uint32_t mo, uint32_t dd)
+{
+    y -= (mo <= 2u) ? 1 : 0;
+    int32_t era = ((y >= 0) ? y : (y - 399)) / 400;
+    uint32_t yoe = (uint32_t)(y - (era * 400));
+    uint32_t doy = (((153u * ((mo > 2u) ? (mo - 3u) : (mo + 9u))) + 2u) / 5u) + dd - 1u;
+    uint32_t doe = (yoe * 365u) + (yoe / 4u) - (yoe / 100u) + doy;
+    return (era * 146097) + (int32_t)doe - 719468;
+}
+
+static void CivilFromDays(int32_t z, int32_t *pY, uint32_t *pMo, uint32_t *pD)
+{
+    z += 719468;
+    int32_t era = ((z >= 0) ? z : (z - 146096)) / 146097;
+    uint32_t doe = (uint32_t)(z - (era * 146097));
+    uint32_t yoe = (doe - (doe / 1460u) + (doe / 36524u) - (doe / 146096u)) / 365u;
+    uint32_t doy = doe - ((365u * yoe) + (yoe / 4u) - (yoe / 100u));
+    uint32_t mp = ((5u * doy) + 2u) / 153u;
+    *pD = doy - (((153u * mp) + 2u) / 5u) + 1u;
+    *pMo = (mp < 10u) ? (mp + 3u) : (mp - 9u);
+    *pY = (int32_t)yoe + (era * 400) + ((*pMo <= 2u) ? 1 : 0);
+}
+
+/* IEEE 1588 clockAccuracy enumeration */
+static uint8_t AccuracyFromNs(int32_t ns)
+{
+    static const int32_t limits[] = {25, 100, 250, 1000, 2500, 10000, 25000, 100000, 250000, 1000000};
+    for (uint8_t i = 0; i < (sizeof(limits) / sizeof(limits[0])); i++) {
+        if (ns <= limits[i]) {
+            return (uint8_t)(0x20u + i);
+        }
+    }
+    return PTP_FRAME_DEFAULT_ACCURACY;
+}
+
+static int32_t AbsNs(int32_t ns)
+{
+    return (ns < 0) ? -ns : ns;
+}
+
+static bool SimSetRate(double ppb)
+{
+    sim.corrPpb = ppb;
+    return true;
+}
+
+static bool SimStepNs(int32_t ns)
+{
+    sim.lanNs += (double)ns;
+    while (sim.lanNs >= (double)NS_PER_SEC) {
+        sim.lanNs -= (double)NS_PER_SEC;
+        sim.lanSec++;
+    }
+    while (sim.lanNs < 0.0) {
+        sim.lanNs += (double)NS_PER_SEC;
+        sim.lanSec--;
+    }
+    return true;
+}
+
+static bool SimSetTime(uint32_t sec, uint32_t nsec)
+{
+    sim.lanSec = sec;
+    sim.lanNs = (double)nsec;
+    return true;
+}
+
+static bool SimReadTime(void)
+{
+    sim.readPending = true;
+    return true;
+}
+
+static void SimFeedNmea(uint32_t tai)
+{
+    char line[48];
+    uint32_t utc = tai - GM_DISC_UTC_OFFSET_S;
+    uint32_t tod = utc % 86400u;
+    int32_t y;
+    uint32_t mo, dd;
+    uint8_t sum = 0;
+    int len;
+
+    CivilFromDays((int32_t)(utc / 86400u), &y, &mo, &dd);
+    len = snprintf(line, sizeof(line), "$GPZDA,%02lu%02lu%02lu.00,%02lu,%02lu,%04li,00,00",
+                   tod / 3600u, (tod / 60u) % 60u, tod % 60u, dd, mo, y);
+    for (int i = 1; i < len; i++) {
+        sum ^= (uint8_t)line[i];
+    }
+    (void)snprintf(&line[len], sizeof(line) - (size_t)len, "*%02X\r\n", sum);
+    for (const char *p = line; '\0' != *p; p++) {
+        (void)GmDiscipline_NmeaPutChar(*p);
+    }
+}
@@ -0,0 +1,189 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Grandmaster clock discipline
+
+  File Name:
+    gm_discipline.h
+
+  Summary:
+    Steers the MAC-PHY clock of the grandmaster to an external 1PPS and NMEA time
+
+  Description:
+    The rising edges of the external 1PPS and of the MAC-PHY 1PPS output are
+    captured by the same free running MCU counter. The counter ticks between
+    two external pulses define the second, so the MCU oscillator drops out of
+    both the phase and the frequency measurement. A PI loop steers the clock
+    increment (MAC_TI/MAC_TISUBN), large offsets are stepped by MAC_TA.
+    The seconds are taken from $xxZDA or $xxRMC sentences, which refer to the
+    pulse ahead of them, or are handed over by GmDiscipline_SetTod() where the
+    reference is not a GNSS receiver.
+    The module owns no hardware, all clock writes go through the actuator.
+*******************************************************************************/
+
+#ifndef GM_DISCIPLINE_H
+#define GM_DISCIPLINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GM_DISC_UTC_OFFSET_S        (37)        /* TAI - UTC, until a source tells otherwise */
+#define GM_DISC_STEP_THRESHOLD_NS   (20000)     /* larger offsets are stepped, not slewed */
+#define GM_DISC_LOCK_NS             (100)
+#define GM_DISC_LOCK_COUNT          (8)         /* pulses within GM_DISC_LOCK_NS until locked */
+#define GM_DISC_UNLOCK_NS           (1000)
+#define GM_DISC_MAX_PPB             (200000)
+#define GM_DISC_KP                  (0.5)       /* ppb per ns of offset */
+#define GM_DISC_KI                  (0.1)
+#define GM_DISC_PPS_TIMEOUT_MS      (1500)
+#define GM_DISC_HOLDOVER_LIMIT_S    (3600)      /* holdover within spec, degraded afterwards */
+#define GM_DISC_TICK_TOLERANCE_PPM  (200)       /* capture counter against its nominal rate */
+#define GM_DISC_TIME_SOURCE_GNSS    (0x20)
+#define GM_DISC_TIME_SOURCE_PTP     (0x40)
+#define GM_DISC_SIM_NO_PULSE        (INT32_MIN) /* pRefOffsetNs entry of a missing pulse */
+
+typedef enum
+{
+    GM_DISC_FREERUN = 0,        /* no reference, the crystal runs on its own */
+    GM_DISC_ACQUIRE,            /* measuring frequency, phase is stepped once known */
+    GM_DISC_TRACK,              /* PI loop closed */
+    GM_DISC_LOCKED,             /* within GM_DISC_LOCK_NS */
+    GM_DISC_HOLDOVER            /* reference lost, last frequency kept */
+} GmDisciplineState_t;
+
+/* Clock writes, all of them may complete asynchronously */
+typedef struct
+{
+    /* Clock rate correction against nominal, positive runs faster */
+    bool (*setRate)(double ppb);
+    /* Adds ns to the clock, |ns| <= 10^9 */
+    bool (*stepNs)(int32_t ns);
+    /* Loads the clock as a whole */
+    bool (*setTime)(uint32_t sec, uint32_t nsec);
+    /* Reads the clock, the result goes to GmDiscipline_OnLanTime() */
+    bool (*readTime)(void);
+} GmDisciplineActuator_t;
+
+/* Announce fields out of the discipline state */
+typedef struct
+{
+    uint8_t clockClass;
+    uint8_t clockAccuracy;
+    uint16_t offsetScaledLogVariance;
+    uint8_t timeSource;
+    int16_t currentUtcOffset;
+    bool utcOffsetValid;
+    bool timeTraceable;
+    bool frequencyTraceable;
+} GmDisciplineQuality_t;
+
+typedef struct
+{
+    GmDisciplineState_t state;
+    int32_t offsetNs;           /* MAC-PHY 1PPS against the external one, positive is ahead */
+    int32_t offsetAvgNs;        /* magnitude, averaged */
+    double freqPpb;             /* correction currently applied */
+    uint32_t ticksPerSec;       /* capture counter ticks between external pulses */
+    uint32_t ppsCnt;
+    uint32_t ppsRejectCnt;
+    uint32_t stepCnt;
+    uint32_t nmeaCnt;
+    uint32_t nmeaErrorCnt;
+    uint32_t holdoverS;
+    uint32_t taiSec;            /* at the last external pulse, 0 until known */
+    bool todValid;
+    /* Time base changes for the Follow_Up information TLV */
+    uint16_t timeBaseIndicator;
+    int64_t lastPhaseChangeNs;
+    double lastFreqChange;
+} GmDisciplineStatus_t;
+
+/* Synthetic reference for GmDiscipline_SelfTest() */
+typedef struct
+{
+    double lanPpm;              /* MAC-PHY crystal error */
+    double mcuPpm;              /* capture counter crystal error */
+    int64_t lanOffsetNs;        /* MAC-PHY clock against TAI at start */
+    uint32_t ppsGapStartS;      /* external pulses missing from here, 0 for none */
+    uint32_t ppsGapS;
+    uint32_t durationS;
+    /* Reference pulse against TAI per second (durationS + 1 entries),
+     * positive is early, NULL for an ideal reference */
+    const int32_t *pRefOffsetNs;
+} GmDisciplineSimCase_t;
+
+typedef struct
+{
+    uint32_t lockS;             /* seconds until locked, 0 if never */
+    uint32_t stepCnt;
+    int32_t maxLockedNs;        /* worst offset once locked */
+    int32_t finalNs;
+    double residualPpb;         /* rate error left at the end */
+    int64_t todErrorNs;         /* simulated clock against TAI at the end */
+    GmDisciplineState_t finalState;
+    uint8_t finalClockClass;
+    bool holdoverSeen;
+} GmDisciplineSimResult_t;
+
+/* Resets the servo, the clock rate is set back to nominal */
+void GmDiscipline_Init(const GmDisciplineActuator_t *pActuator, uint32_t ticksNominal);
+
+/* Capture counter value at the external / MAC-PHY 1PPS, interrupt context */
+void GmDiscipline_OnExtPps(uint32_t ticks);
+void GmDiscipline_OnLanPps(uint32_t ticks);
+
+/* Runs the servo, the pulses are evaluated half a second after the external edge */
+void GmDiscipline_Service(uint32_t ticksNow, uint32_t nowMs);
+
+/* NMEA input character by character, returns true while inside a sentence */
+bool GmDiscipline_NmeaPutChar(char c);
+
+/* TAI of the last external pulse, for references which tell the time of day
+ * by other means than NMEA */
+void GmDiscipline_SetTod(uint32_t taiSec);
+
+/* Announce timeSource while the reference is traceable, GNSS after Init */
+void GmDiscipline_SetTimeSource(uint8_t timeSource);
+
+/* Clock read as requested by readTime(), ticks is the capture counter at the read */
+void GmDiscipline_OnLanTime(bool success, uint32_t sec, uint32_t nsec, uint32_t ticks);
+
+void GmDiscipline_GetQuality(GmDisciplineQuality_t *pQuality);
+void GmDiscipline_GetStatus(GmDisciplineStatus_t *pStatus);
+const char *GmDiscipline_StateName(GmDisciplineState_t state);
+
+/* Runs the servo against a simulated MAC-PHY clock and reference, the live
+ * state is lost and has to be set up again with GmDiscipline_Init() */
+void GmDiscipline_SelfTest(const GmDisciplineSimCase_t *pCase, GmDisciplineSimResult_t *pResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GM_DISCIPLINE_H */
@@ -0,0 +1,282 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Grandmaster egress latency calibration
+
+  File Name:
+    gm_egress_cal.c
+
+  Summary:
+    1PPS phase comparison against a reference follower and the flash record
+
+  Description:
+    A round waits GM_EGRESS_CAL_SETTLE_S for the follower, then averages
+    GM_EGRESS_CAL_SAMPLES phase offsets. The follower runs ahead of the GM
+    by (applied latency - true latency), so the mean is taken off the
+    applied latency. The next round checks the result.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "definitions.h"
+#include "gm_egress_cal.h"
+
+#define NS_PER_SEC              (1000000000LL)
+#define RECORD_MAGIC            (0x45434C31u)   /* "ECL1" */
+#define PPS_TIMEOUT_MS          (3000)
+#define PERIOD_TOLERANCE_PPM    (200)
+
+typedef struct
+{
+    uint32_t magic;
+    GmEgressCalSetup_t setup;
+    int32_t offsetNs;
+    uint32_t check;
+} GmEgressCalRecord_t;
+
+typedef struct
+{
+    GmEgressCalStatus_t st;
+    GmEgressCalSetup_t setup;
+    /* Written by the capture interrupt */
+    volatile uint32_t refTicks;
+    volatile uint32_t lanTicks[2];      /* [0] is the latest */
+    volatile uint32_t lanCnt;
+    volatile bool refNew;
+    uint32_t settleUntilMs;
+    uint32_t lastRefMs;
+    int64_t sumNs;
+    int32_t minNs;
+    int32_t maxNs;
+} GmEgressCal_t;
+
+static GmEgressCal_t c;
+
+static bool ProcessPps(uint32_t ref, int32_t *pErrorNs);
+static bool FinishRound(int32_t *pOffsetNs);
+static void StartRound(uint32_t nowMs);
+static bool Store(void);
+static uint32_t RecordCheck(const GmEgressCalRecord_t *pRec);
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         PUBLIC FUNCTIONS                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+bool GmEgressCal_Load(const GmEgressCalSetup_t *pSetup, int32_t *pOffsetNs)
+{
+    GmEgressCalRecord_t rec;
+    (void)NVMCTRL_Read((uint32_t *)&rec, sizeof(rec), GM_EGRESS_CAL_NVM_ADDRESS);
+    if ((RECORD_MAGIC != rec.magic) || (RecordCheck(&rec) != rec.check)) {
+        return false;
+    }
+    if ((rec.setup.spiClockHz != pSetup->spiClockHz) || (rec.setup.plcaNodeId != pSetup->plcaNodeId) ||
+        (rec.setup.plcaNodeCount != pSetup->plcaNodeCount) || (rec.setup.plcaBurstCount != pSetup->plcaBurstCount) ||
+        (rec.setup.plcaBurstTimer != pSetup->plcaBurstTimer) || (rec.setup.txCutThrough != pSetup->txCutThrough)) {
+        return false;
+    }
+    *pOffsetNs = rec.offsetNs;
+    return true;
+}
+
+void GmEgressCal_Start(const GmEgressCalSetup_t *pSetup, int32_t offsetNs, uint32_t nowMs)
+{
+    memset(&c, 0, sizeof(c));
+    c.setup = *pSetup;
+    c.st.offsetNs = offsetNs;
+    c.lastRefMs = nowMs;
+    StartRound(nowMs);
+}
+
+void GmEgressCal_Abort(void)
+{
+    c.st.state = GM_EGRESS_CAL_IDLE;
+}
+
+bool GmEgressCal_IsActive(void)
+{
+    return (GM_EGRESS_CAL_SETTLE == c.st.state) || (GM_EGRESS_CAL_MEASURE == c.st.state);
+}
+
+void GmEgressCal_OnRefPps(uint32_t ticks)
+{
+    c.refTicks = ticks;
+    c.refNew = true;
+}
+
+void GmEgressCal_OnLanPps(uint32_t ticks)
+{
+    c.lanTicks[1] = c.lanTicks[0];
+    c.lanTicks[0] = ticks;
+    c.lanCnt++;
+}
+
+bool GmEgressCal_Service(uint32_t ticksNow, uint32_t nowMs, int32_t *pOffsetNs)
+{
+    int32_t errorNs;
+    bool changed = false;
+
+    if (!GmEgressCal_IsActive()) {
+        return false;
+    }
+    if (c.refNew && ((ticksNow - c.refTicks) > (TC4_CaptureFrequencyGet() / 2u))) {
+        c.refNew = false;
+        c.lastRefMs = nowMs;
+        if ((GM_EGRESS_CAL_MEASURE == c.st.state) && ProcessPps(c.refTicks, &errorNs)) {
+            c.sumNs += errorNs;
+            if ((0u == c.st.samples) || (errorNs < c.minNs)) {
+                c.minNs = errorNs;
+            }
+            if ((0u == c.st.samples) || (errorNs > c.maxNs)) {
+                c.maxNs = errorNs;
+            }
+            c.st.samples++;
+            if (c.st.samples >= GM_EGRESS_CAL_SAMPLES) {
+                changed = FinishRound(pOffsetNs);
+                if (GmEgressCal_IsActive()) {
+                    StartRound(nowMs);
+                }
+            }
+        }
+    }
+    if ((nowMs - c.lastRefMs) > PPS_TIMEOUT_MS) {
+        /* No follower 1PPS on the external input */
+        c.st.state = GM_EGRESS_CAL_FAILED;
+    } else if ((GM_EGRESS_CAL_SETTLE == c.st.state) && ((int32_t)(nowMs - c.settleUntilMs) >= 0)) {
+        c.st.state = GM_EGRESS_CAL_MEASURE;
+    }
+    c.st.settleLeft = (GM_EGRESS_CAL_SETTLE == c.st.state) ? (uint16_t)((c.settleUntilMs - nowMs) / 1000u) : 0u;
+    return changed;
+}
+
+void GmEgressCal_GetStatus(GmEgressCalStatus_t *pStatus)
+{
+    *pStatus = c.st;
+}
+
+const char *GmEgressCal_StateName(GmEgressCalState_t state)
+{
+    static const char *names[] = {"idle", "settle", "measure", "done", "failed"};
+    return (state <= GM_EGRESS_CAL_FAILED) ? names[state] : "?";
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/* Follower ahead of the GM is positive, the GM second is the time base */
+static bool ProcessPps(uint32_t ref, int32_t *pErrorNs)
+{
+    uint32_t nominal = TC4_CaptureFrequencyGet();
+    uint32_t tolerance = (nominal / 1000000u) * PERIOD_TOLERANCE_PPM;
+    uint32_t period = c.lanTicks[0] - c.lanTicks[1];
+    uint32_t lan = c.lanTicks[0];
+
+    if ((c.lanCnt < 2u) || (period < (nominal - tolerance)) || (period > (nominal + tolerance))) {
+        return false;
+    }
+    /* The GM edge closest to the follower edge, either side of it */
+    if ((int32_t)(ref - lan) < 0) {
+        uint32_t prev = c.lanTicks[1];
+        if ((uint32_t)(lan - ref) > (uint32_t)(ref - prev)) {
+            lan = prev;
+        }
+    }
+    int64_t ns = ((int64_t)(int32_t)(lan - ref) * NS_PER_SEC) / period;
+    if ((ns > (NS_PER_SEC / 2)) || (ns < -(NS_PER_SEC / 2))) {
+        return false;
+    }
+    *pErrorNs = (int32_t)ns;
+    return true;
+}
+
+static bool FinishRound(int32_t *pOffsetNs)
+{
+    int32_t mean = (int32_t)(c.sumNs / c.st.samples);
+
+    c.st.lastErrorNs = mean;
+    c.st.lastSpreadNs = c.maxNs - c.minNs;
+    c.st.round++;
+    if (c.st.lastSpreadNs > GM_EGRESS_CAL_MAX_SPREAD_NS) {
+        /* Follower not settled yet, the round does not count for a correction */
+        if (c.st.round >= GM_EGRESS_CAL_ROUNDS) {
+            c.st.state = GM_EGRESS_CAL_FAILED;
+        }
+        return false;
+    }
+    if ((mean <= GM_EGRESS_CAL_DONE_NS) && (mean >= -GM_EGRESS_CAL_DONE_NS)) {
+        c.st.stored = Store();
+        c.st.state = c.st.stored ? GM_EGRESS_CAL_DONE : GM_EGRESS_CAL_FAILED;
+        return false;
+    }
+    if (((c.st.offsetNs - mean) < GM_EGRESS_CAL_MIN_NS) || ((c.st.offsetNs - mean) > GM_EGRESS_CAL_MAX_NS) ||
+        (c.st.round >= GM_EGRESS_CAL_ROUNDS)) {
+        c.st.state = GM_EGRESS_CAL_FAILED;
+        return false;
+    }
+    c.st.offsetNs -= mean;
+    *pOffsetNs = c.st.offsetNs;
+    return true;
+}
+
+static void StartRound(uint32_t nowMs)
+{
+    c.sumNs = 0;
+    c.st.samples = 0;
+    c.settleUntilMs = nowMs + (GM_EGRESS_CAL_SETTLE_S * 1000u);
+    c.st.state = GM_EGRESS_CAL_SETTLE;
+}
+
+/* The block sits in the second flash bank, the code keeps running from the first */
+static bool Store(void)
+{
+    static uint32_t page[NVMCTRL_FLASH_PAGESIZE / sizeof(uint32_t)];
+    GmEgressCalRecord_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = RECORD_MAGIC;
+    rec.setup = c.setup;
+    rec.offsetNs = c.st.offsetNs;
+    rec.check = RecordCheck(&rec);
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &rec, sizeof(rec));
+
+    (void)NVMCTRL_BlockErase(GM_EGRESS_CAL_NVM_ADDRESS);
+    while (NVMCTRL_IsBusy()) {
+    }
+    (void)NVMCTRL_PageWrite(page, GM_EGRESS_CAL_NVM_ADDRESS);
+    while (NVMCTRL_IsBusy()) {
+    }
+    return (0u == NVMCTRL_ErrorGet());
+}
+
+static uint32_t RecordCheck(const GmEgressCalRecord_t *pRec)
+{
+    const uint8_t *p = (const uint8_t *)pRec;
+    uint32_t sum = 0x811C9DC5u;
+    for (size_t i = 0; i < offsetof(GmEgressCalRecord_t, check); i++) {
+        sum = (sum ^ p[i]) * 0x01000193u;
+    }
+    return sum;
+}
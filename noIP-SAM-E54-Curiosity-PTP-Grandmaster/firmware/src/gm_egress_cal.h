@@ -0,0 +1,121 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Grandmaster egress latency calibration
+
+  File Name:
+    gm_egress_cal.h
+
+  Summary:
+    Measures the offset between the TX timestamp capture and the ingress
+    timestamp of a follower, and keeps it in flash per node
+
+  Description:
+    The preciseOriginTimestamp is the TX capture of the MAC-PHY plus a
+    latency, which depends on the board, the SPI clock and the PLCA setup.
+    A reference follower, synchronized to this GM, has its 1PPS output wired
+    to the external 1PPS input (PB07) for the time of the calibration. Any
+    error in the latency shows up as a phase offset between the 1PPS of the
+    follower and the 1PPS of this GM, both captured by TC4. The latency is
+    corrected by that offset until it is below GM_EGRESS_CAL_DONE_NS, then
+    it is stored in the last flash block together with the setup it was
+    measured for.
+*******************************************************************************/
+
+#ifndef GM_EGRESS_CAL_H
+#define GM_EGRESS_CAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GM_EGRESS_CAL_NVM_ADDRESS   (0x000FE000u)   /* last 8 KB block of the 1 MB flash */
+#define GM_EGRESS_CAL_SETTLE_S      (30)            /* follower settling after a change */
+#define GM_EGRESS_CAL_SAMPLES       (32)
+#define GM_EGRESS_CAL_ROUNDS        (4)
+#define GM_EGRESS_CAL_DONE_NS       (20)
+#define GM_EGRESS_CAL_MAX_SPREAD_NS (500)           /* samples of a round, max - min */
+#define GM_EGRESS_CAL_MIN_NS        (0)
+#define GM_EGRESS_CAL_MAX_NS        (100000)
+
+typedef enum
+{
+    GM_EGRESS_CAL_IDLE = 0,
+    GM_EGRESS_CAL_SETTLE,
+    GM_EGRESS_CAL_MEASURE,
+    GM_EGRESS_CAL_DONE,
+    GM_EGRESS_CAL_FAILED
+} GmEgressCalState_t;
+
+/* What the latency depends on, a stored value is only taken for the same setup */
+typedef struct
+{
+    uint32_t spiClockHz;
+    uint8_t plcaNodeId;
+    uint8_t plcaNodeCount;
+    uint8_t plcaBurstCount;
+    uint8_t plcaBurstTimer;
+    bool txCutThrough;
+} GmEgressCalSetup_t;
+
+typedef struct
+{
+    GmEgressCalState_t state;
+    int32_t offsetNs;           /* latency currently applied */
+    int32_t lastErrorNs;        /* follower 1PPS against GM 1PPS, mean of the last round */
+    int32_t lastSpreadNs;
+    uint8_t round;
+    uint8_t samples;
+    uint16_t settleLeft;
+    bool stored;
+} GmEgressCalStatus_t;
+
+/* Looks up the stored latency for this setup, returns false if there is none */
+bool GmEgressCal_Load(const GmEgressCalSetup_t *pSetup, int32_t *pOffsetNs);
+
+/* Starts a calibration from the latency currently applied */
+void GmEgressCal_Start(const GmEgressCalSetup_t *pSetup, int32_t offsetNs, uint32_t nowMs);
+void GmEgressCal_Abort(void);
+bool GmEgressCal_IsActive(void);
+
+/* Capture counter value at the follower / GM 1PPS, interrupt context */
+void GmEgressCal_OnRefPps(uint32_t ticks);
+void GmEgressCal_OnLanPps(uint32_t ticks);
+
+/* Evaluates a follower pulse half a second after it, returns true when the
+ * latency to apply has changed */
+bool GmEgressCal_Service(uint32_t ticksNow, uint32_t nowMs, int32_t *pOffsetNs);
+
+void GmEgressCal_GetStatus(GmEgressCalStatus_t *pStatus);
+const char *GmEgressCal_StateName(GmEgressCalState_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GM_EGRESS_CAL_H */
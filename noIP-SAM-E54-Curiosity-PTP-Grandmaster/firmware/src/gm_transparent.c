@@ -0,0 +1,470 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Transparent clock relay
+
+  File Name:
+    gm_transparent.c
+
+  Summary:
+    Residence time of Sync between the GMAC and the T1S port, patched into
+    the Follow_Up of the backbone master
+
+  Description:
+    One Sync is in flight at a time, the next one of the master comes a Sync
+    interval later. Its Follow_Up is sent once both the master Follow_Up and
+    the egress timestamp are in, whichever comes last. The correctionField is
+    added to in its raw 2^-16 ns form, so upstream sub-ns parts stay.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "gm_transparent.h"
+
+#define NS_PER_SEC                  (1000000000LL)
+#define OFS_TSMT                    (0)
+#define OFS_DOMAIN                  (4)
+#define OFS_FLAGS                   (6)
+#define OFS_CORRECTION              (8)
+#define OFS_SOURCE_PORT             (20)
+#define OFS_SEQUENCE_ID             (30)
+#define OFS_LOG_INTERVAL            (33)
+#define OFS_TIMESTAMP               (34)
+#define FLAG0_TWO_STEP              (0x02u)
+#define MSG_MIN_LEN                 (44)
+#define PORT_IDENTITY_LEN           (10)
+#define RESIDENCE_AVG_WEIGHT        (16)
+
+/* Simulated bridge */
+#define SIM_TAI_START               (1760000037LL)
+#define SIM_SYNC_INTERVAL_NS        (125000000LL)
+#define SIM_TIMESTAMP_NS            (8)
+#define SIM_SYNC_CORRECTION_NS      (1500)      /* of an upstream transparent clock */
+#define SIM_FOLLOW_UP_CORRECTION_NS (250)
+#define SIM_T1S_OFFSET_NS           (37)        /* T1S clock against the TSU */
+
+typedef struct
+{
+    ptpFrame_t sync;
+    ptpFrame_t followUp;
+    ptpFrame_t announce;
+    const ptpFrame_t *pNext;            /* handed out by GetTx */
+    const ptpFrame_t *pInFlight;        /* sent, untouched until the next GetTx */
+    uint8_t srcMac[6];
+    uint8_t port[PORT_IDENTITY_LEN];    /* sourcePortIdentity of the Sync in flight */
+    uint16_t seq;
+    int64_t ingressNs;
+    int64_t originNs;                   /* of a one-step Sync */
+    int64_t correctionNs;               /* residence time and link delay, once known */
+    int32_t linkDelayNs;
+    uint32_t residenceCnt;
+    bool pending;                       /* Sync taken in, its Follow_Up not out yet */
+    bool oneStep;
+    bool syncReady;
+    bool syncSent;
+    bool egressValid;
+    bool followUpIn;
+    bool followUpReady;
+    bool announceReady;
+    GmTransparentStatus_t st;
+} GmTransparent_t;
+
+static GmTransparent_t d;
+static const uint8_t ptpMulticast[6] = {0x01, 0x80, 0xC2, 0x00, 0x00, 0x0E};
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                      PRIVATE FUNCTION PROTOTYPES                     */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static void TakeSync(const uint8_t *pMsg, uint16_t len, int64_t ingressNs, int32_t linkDelayNs);
+static void TakeFollowUp(const uint8_t *pMsg, uint16_t len);
+static bool Copy(ptpFrame_t *pFrame, const uint8_t *pMsg, uint16_t len);
+static void Complete(void);
+static void BuildFollowUp(void);
+static void AddCorrection(uint8_t *pMsg, int64_t ns);
+static uint16_t Get16(const uint8_t *p);
+static int64_t GetTimestamp(const uint8_t *pMsg);
+static int64_t GetCorrection(const uint8_t *pMsg);
+static int32_t Clamp32(int64_t v);
+static const ptpFrame_t *SimTx(void);
+static int64_t SimTsu(int64_t ns, double ppm);
+static int64_t SimStamp(int64_t ns);
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         PUBLIC FUNCTIONS                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+void GmTransparent_Init(const uint8_t srcMac[6])
+{
+    memset(&d, 0, sizeof(d));
+    memcpy(d.srcMac, srcMac, sizeof(d.srcMac));
+}
+
+void GmTransparent_OnIngress(const uint8_t *pMsg, uint16_t len, int64_t ingressNs, int32_t linkDelayNs)
+{
+    if ((NULL == pMsg) || (len < MSG_MIN_LEN)) {
+        return;
+    }
+    switch (pMsg[OFS_TSMT] & 0x0Fu) {
+        case PTP_FRAME_SYNC:
+            TakeSync(pMsg, len, ingressNs, linkDelayNs);
+            break;
+        case PTP_FRAME_FOLLOW_UP:
+            TakeFollowUp(pMsg, len);
+            break;
+        case PTP_FRAME_ANNOUNCE:
+            if (Copy(&d.announce, pMsg, len)) {
+                d.announceReady = true;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* Sync ahead of everything else, its residence time starts at ingress */
+const ptpFrame_t *GmTransparent_GetTx(bool *pTimestamp)
+{
+    d.pInFlight = NULL;
+    d.pNext = NULL;
+    if (d.syncReady) {
+        d.pNext = &d.sync;
+    } else if (d.followUpReady) {
+        d.pNext = &d.followUp;
+    } else if (d.announceReady) {
+        d.pNext = &d.announce;
+    }
+    *pTimestamp = (&d.sync == d.pNext);
+    return d.pNext;
+}
+
+void GmTransparent_OnSent(void)
+{
+    if (&d.sync == d.pNext) {
+        d.syncReady = false;
+        d.syncSent = true;
+        d.st.syncCnt++;
+    } else if (&d.followUp == d.pNext) {
+        d.followUpReady = false;
+        d.st.followUpCnt++;
+    } else if (&d.announce == d.pNext) {
+        d.announceReady = false;
+        d.st.announceCnt++;
+    }
+    d.pInFlight = d.pNext;
+    d.pNext = NULL;
+}
+
+void GmTransparent_OnEgress(bool success, int64_t egressNs, int32_t clockOffsetNs)
+{
+    int64_t residence;
+
+    if (!d.syncSent) {
+        return;
+    }
+    d.syncSent = false;
+    if (!success) {
+        d.pending = false;
+        d.st.lostCnt++;
+        return;
+    }
+    residence = egressNs - clockOffsetNs - d.ingressNs;
+    d.st.residenceNs = Clamp32(residence);
+    if ((residence < 0) || (residence > GM_TC_MAX_RESIDENCE_NS)) {
+        /* The clocks are not aligned (yet), better no Follow_Up than a wrong one */
+        d.pending = false;
+        d.st.rejectCnt++;
+        return;
+    }
+    if ((0u == d.residenceCnt) || (d.st.residenceNs < d.st.residenceMinNs)) {
+        d.st.residenceMinNs = d.st.residenceNs;
+    }
+    if ((0u == d.residenceCnt) || (d.st.residenceNs > d.st.residenceMaxNs)) {
+        d.st.residenceMaxNs = d.st.residenceNs;
+    }
+    if (0u == d.residenceCnt) {
+        d.st.residenceAvgNs = d.st.residenceNs;
+    } else {
+        d.st.residenceAvgNs += (d.st.residenceNs - d.st.residenceAvgNs) / RESIDENCE_AVG_WEIGHT;
+    }
+    d.residenceCnt++;
+    d.correctionNs = residence + d.linkDelayNs;
+    d.egressValid = true;
+    Complete();
+}
+
+void GmTransparent_GetStatus(GmTransparentStatus_t *pStatus)
+{
+    *pStatus = d.st;
+}
+
+/* Master, backbone link, node and T1S link are played through per Sync. The
+ * master runs on TAI, the TSU off by the rate the servo left, the T1S clock a
+ * fixed offset ahead of the TSU. The follower takes the forwarded messages
+ * like processFollowUp() does, its own link delay cancels out. */
+void GmTransparent_SelfTest(const GmTransparentSimCase_t *pCase, GmTransparentSimResult_t *pResult)
+{
+    static const uint8_t simMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    static const uint8_t simMaster[8] = {0x02, 0x00, 0x00, 0xFF, 0xFE, 0x00, 0x00, 0x01};
+    uint32_t syncs = (pCase->syncs < GM_TC_SIM_MAX_SYNCS) ? pCase->syncs : GM_TC_SIM_MAX_SYNCS;
+    int64_t upstreamNs = SIM_SYNC_CORRECTION_NS + (pCase->oneStep ? 0 : SIM_FOLLOW_UP_CORRECTION_NS);
+    uint32_t seed = 1;
+    ptpFrameConfig_t cfg;
+    ptpFrame_t sync;
+    ptpFrame_t followUp;
+
+    memset(pResult, 0, sizeof(GmTransparentSimResult_t));
+    GmTransparent_Init(simMac);
+    memset(&cfg, 0, sizeof(cfg));
+    memcpy(cfg.srcMac, simMac, sizeof(cfg.srcMac));
+    memcpy(cfg.clockIdentity, simMaster, sizeof(cfg.clockIdentity));
+    cfg.portNumber = 1;
+    cfg.logMessageInterval = -3;
+    cfg.twoStep = !pCase->oneStep;
+    (void)ptpFrameBuild(&sync, PTP_FRAME_SYNC, &cfg);
+    (void)ptpFrameBuild(&followUp, PTP_FRAME_FOLLOW_UP, &cfg);
+    ptpFrameSetCorrection(&sync, SIM_SYNC_CORRECTION_NS);
+    ptpFrameSetCorrection(&followUp, SIM_FOLLOW_UP_CORRECTION_NS);
+
+    for (uint32_t i = 0; i < syncs; i++) {
+        int64_t t1 = (SIM_TAI_START * NS_PER_SEC) + ((int64_t)i * SIM_SYNC_INTERVAL_NS);
+        int64_t arrival = t1 + upstreamNs + pCase->pathDelayNs;
+        int64_t residence;
+        int64_t departure;
+        const ptpFrame_t *pOut;
+        int64_t syncCorrNs;
+        int64_t err;
+        int64_t uncorrected;
+
+        seed = (seed * 1103515245u) + 12345u;
+        residence = pCase->residenceMinNs +
+                    (int64_t)((((seed >> 8) & 0xFFFFu) / 65535.0) * (double)(pCase->residenceMaxNs - pCase->residenceMinNs));
+        departure = arrival + residence;
+
+        ptpFrameSetSequenceId(&sync, (uint16_t)i);
+        ptpFrameSetTimestamp(&sync, pCase->oneStep ? (uint64_t)(t1 / NS_PER_SEC) : 0u,
+                             pCase->oneStep ? (uint32_t)(t1 % NS_PER_SEC) : 0u);
+        ptpFrameSetSequenceId(&followUp, (uint16_t)i);
+        ptpFrameSetTimestamp(&followUp, (uint64_t)(t1 / NS_PER_SEC), (uint32_t)(t1 % NS_PER_SEC));
+
+        GmTransparent_OnIngress(&sync.buf[PTP_FRAME_ETH_HEADER_LEN], sync.len - PTP_FRAME_ETH_HEADER_LEN,
+                                SimStamp(SimTsu(arrival, pCase->tsuPpm)), (int32_t)pCase->pathDelayNs);
+        pOut = SimTx();
+        if ((&d.sync != pOut) || (0u == (pOut->buf[PTP_FRAME_ETH_HEADER_LEN + OFS_FLAGS] & FLAG0_TWO_STEP))) {
+            continue;
+        }
+        syncCorrNs = GetCorrection(&pOut->buf[PTP_FRAME_ETH_HEADER_LEN]);
+        if (!pCase->oneStep && pCase->followUpFirst) {
+            GmTransparent_OnIngress(&followUp.buf[PTP_FRAME_ETH_HEADER_LEN], followUp.len - PTP_FRAME_ETH_HEADER_LEN, 0, 0);
+        }
+        GmTransparent_OnEgress(true, SimStamp(SimTsu(departure, pCase->tsuPpm) + SIM_T1S_OFFSET_NS),
+                               SIM_T1S_OFFSET_NS - pCase->clockOffsetErrNs);
+        if (!pCase->oneStep && !pCase->followUpFirst) {
+            GmTransparent_OnIngress(&followUp.buf[PTP_FRAME_ETH_HEADER_LEN], followUp.len - PTP_FRAME_ETH_HEADER_LEN, 0, 0);
+        }
+        pOut = SimTx();
+        if ((&d.followUp != pOut) || ((uint16_t)i != Get16(&pOut->buf[PTP_FRAME_ETH_HEADER_LEN + OFS_SEQUENCE_ID]))) {
+            continue;
+        }
+        pResult->forwarded++;
+        err = GetTimestamp(&pOut->buf[PTP_FRAME_ETH_HEADER_LEN]) + syncCorrNs +
+              GetCorrection(&pOut->buf[PTP_FRAME_ETH_HEADER_LEN]) - departure;
+        uncorrected = t1 + upstreamNs - departure;
+        err = (err < 0) ? -err : err;
+        uncorrected = (uncorrected < 0) ? -uncorrected : uncorrected;
+        if (Clamp32(err) > pResult->maxErrorNs) {
+            pResult->maxErrorNs = Clamp32(err);
+        }
+        if (Clamp32(uncorrected) > pResult->maxUncorrectedNs) {
+            pResult->maxUncorrectedNs = Clamp32(uncorrected);
+        }
+    }
+    pResult->residenceMinNs = d.st.residenceMinNs;
+    pResult->residenceMaxNs = d.st.residenceMaxNs;
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+/* A Sync whose Follow_Up never went out is counted when the next one comes */
+static void TakeSync(const uint8_t *pMsg, uint16_t len, int64_t ingressNs, int32_t linkDelayNs)
+{
+    if (d.syncSent) {
+        d.st.dropCnt++;
+        return;
+    }
+    if (d.pending) {
+        d.pending = false;
+        d.st.lostCnt++;
+    }
+    if (!Copy(&d.sync, pMsg, len)) {
+        return;
+    }
+    memcpy(d.port, &pMsg[OFS_SOURCE_PORT], sizeof(d.port));
+    d.seq = Get16(&pMsg[OFS_SEQUENCE_ID]);
+    d.ingressNs = ingressNs;
+    d.linkDelayNs = linkDelayNs;
+    d.st.linkDelayNs = linkDelayNs;
+    d.oneStep = (0u == (pMsg[OFS_FLAGS] & FLAG0_TWO_STEP));
+    d.egressValid = false;
+    d.followUpIn = false;
+    if (d.oneStep) {
+        /* Passed on as two-step, the Follow_Up is made up at egress */
+        d.originNs = GetTimestamp(pMsg);
+        ptpFrameSetTwoStep(&d.sync, true);
+        d.followUpIn = true;
+        d.st.oneStepCnt++;
+    }
+    d.pending = true;
+    d.syncReady = true;
+}
+
+static void TakeFollowUp(const uint8_t *pMsg, uint16_t len)
+{
+    if (!d.pending || d.oneStep || d.followUpIn || (Get16(&pMsg[OFS_SEQUENCE_ID]) != d.seq) ||
+        (0 != memcmp(&pMsg[OFS_SOURCE_PORT], d.port, sizeof(d.port)))) {
+        return;
+    }
+    if (!Copy(&d.followUp, pMsg, len)) {
+        d.pending = false;
+        return;
+    }
+    d.followUpIn = true;
+    Complete();
+}
+
+/* The message goes behind an Ethernet header of the T1S port */
+static bool Copy(ptpFrame_t *pFrame, const uint8_t *pMsg, uint16_t len)
+{
+    if ((pFrame == d.pInFlight) || ((PTP_FRAME_ETH_HEADER_LEN + len) > PTP_FRAME_MAX_LEN)) {
+        d.st.dropCnt++;
+        return false;
+    }
+    memcpy(&pFrame->buf[0], ptpMulticast, sizeof(ptpMulticast));
+    memcpy(&pFrame->buf[6], d.srcMac, sizeof(d.srcMac));
+    pFrame->buf[12] = 0x88;
+    pFrame->buf[13] = 0xF7;
+    memcpy(&pFrame->buf[PTP_FRAME_ETH_HEADER_LEN], pMsg, len);
+    pFrame->len = PTP_FRAME_ETH_HEADER_LEN + len;
+    pFrame->type = (ptpFrameType_t)(pMsg[OFS_TSMT] & 0x0Fu);
+    return true;
+}
+
+static void Complete(void)
+{
+    if (!d.pending || !d.egressValid || !d.followUpIn) {
+        return;
+    }
+    if (d.oneStep) {
+        BuildFollowUp();
+    }
+    AddCorrection(&d.followUp.buf[PTP_FRAME_ETH_HEADER_LEN], d.correctionNs);
+    d.pending = false;
+    d.followUpIn = false;
+    d.followUpReady = true;
+}
+
+/* Follow_Up for a one-step Sync, under the identity of its master */
+static void BuildFollowUp(void)
+{
+    const uint8_t *msg = &d.sync.buf[PTP_FRAME_ETH_HEADER_LEN];
+    ptpFrameConfig_t cfg;
+
+    memset(&cfg, 0, sizeof(cfg));
+    memcpy(cfg.srcMac, d.srcMac, sizeof(cfg.srcMac));
+    memcpy(cfg.clockIdentity, d.port, sizeof(cfg.clockIdentity));
+    cfg.portNumber = Get16(&d.port[8]);
+    cfg.domainNumber = msg[OFS_DOMAIN];
+    cfg.logMessageInterval = (int8_t)msg[OFS_LOG_INTERVAL];
+    cfg.twoStep = true;
+    (void)ptpFrameBuild(&d.followUp, PTP_FRAME_FOLLOW_UP, &cfg);
+    ptpFrameSetSequenceId(&d.followUp, d.seq);
+    ptpFrameSetTimestamp(&d.followUp, (uint64_t)(d.originNs / NS_PER_SEC), (uint32_t)(d.originNs % NS_PER_SEC));
+}
+
+static void AddCorrection(uint8_t *pMsg, int64_t ns)
+{
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < 8u; i++) {
+        v = (v << 8) | pMsg[OFS_CORRECTION + i];
+    }
+    v += (uint64_t)(ns * 65536);
+    for (uint8_t i = 8u; i > 0u; i--) {
+        pMsg[OFS_CORRECTION + i - 1u] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+static uint16_t Get16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+/* 48 bit seconds, only the lower 32 bit are of use until 2106 */
+static int64_t GetTimestamp(const uint8_t *pMsg)
+{
+    const uint8_t *p = &pMsg[OFS_TIMESTAMP + 2];
+    uint32_t sec = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    uint32_t ns = ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | p[7];
+    return ((int64_t)sec * NS_PER_SEC) + ns;
+}
+
+/* correctionField in ns, the sub-ns part is dropped */
+static int64_t GetCorrection(const uint8_t *pMsg)
+{
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < 8u; i++) {
+        v = (v << 8) | pMsg[OFS_CORRECTION + i];
+    }
+    return (int64_t)v / 65536;
+}
+
+static int32_t Clamp32(int64_t v)
+{
+    return (int32_t)((v > INT32_MAX) ? INT32_MAX : ((v < -INT32_MAX) ? -INT32_MAX : v));
+}
+
+/* What main does on the T1S port, the frame is sent at once */
+static const ptpFrame_t *SimTx(void)
+{
+    bool timestamp;
+    const ptpFrame_t *pFrame = GmTransparent_GetTx(&timestamp);
+    if (NULL != pFrame) {
+        GmTransparent_OnSent();
+    }
+    return pFrame;
+}
+
+/* TSU at TAI ns, off by ppm from the start of the run */
+static int64_t SimTsu(int64_t ns, double ppm)
+{
+    return ns + (int64_t)((double)(ns - (SIM_TAI_START * NS_PER_SEC)) * ppm * 1e-6);
+}
+
+static int64_t SimStamp(int64_t ns)
+{
+    return ns - (ns % SIM_TIMESTAMP_NS);
+}
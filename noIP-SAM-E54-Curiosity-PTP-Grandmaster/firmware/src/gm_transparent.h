@@ -0,0 +1,134 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2025, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Transparent clock relay
+
+  File Name:
+    gm_transparent.h
+
+  Summary:
+    Forwards the Sync/Follow_Up of the backbone master onto the T1S segment
+    with the residence time of the node added to the correctionField
+
+  Description:
+    In transparent clock mode the node does not originate time on the T1S
+    segment. The Sync, Follow_Up and Announce messages of the backbone master
+    are passed on as they are, under the identity of the master. A Sync is
+    timestamped at ingress by the GMAC timer (TSU) and at egress by the
+    MAC-PHY, the difference is the time it spent in the node. As the two
+    clocks are separate, the egress timestamp is brought onto the TSU by the
+    offset the GM discipline measures between their 1PPS. Residence time and
+    the link delay of the backbone port go into the correctionField of the
+    Follow_Up (two-step). One-step Syncs are passed on as two-step with a
+    Follow_Up of their own, the MAC-PHY can not patch a frame on the fly.
+    Pdelay is link local and answered on each port, it is not forwarded.
+    The followers see the forwarded messages like those of a GM at the
+    master's place, so processFollowUp() no longer takes the forwarding delay
+    for an offset.
+*******************************************************************************/
+
+#ifndef GM_TRANSPARENT_H
+#define GM_TRANSPARENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ptp_frame.h"
+
+#define GM_TC_MAX_RESIDENCE_NS      (10000000)  /* longer stays are not corrected, the Follow_Up is dropped */
+#define GM_TC_SIM_MAX_SYNCS         (10000)
+
+typedef struct
+{
+    uint32_t syncCnt;           /* forwarded */
+    uint32_t followUpCnt;       /* forwarded with the residence time added */
+    uint32_t oneStepCnt;        /* one-step Syncs passed on as two-step */
+    uint32_t announceCnt;
+    uint32_t lostCnt;           /* Sync out without Follow_Up, no timestamp or no Follow_Up of the master */
+    uint32_t rejectCnt;         /* residence time out of range */
+    uint32_t dropCnt;           /* too long or a Sync still in flight */
+    int32_t residenceNs;        /* last */
+    int32_t residenceMinNs;
+    int32_t residenceMaxNs;
+    int32_t residenceAvgNs;
+    int32_t linkDelayNs;        /* of the backbone port, added along */
+} GmTransparentStatus_t;
+
+/* Synthetic bridge for GmTransparent_SelfTest(), the master runs on TAI */
+typedef struct
+{
+    uint32_t pathDelayNs;       /* backbone link */
+    uint32_t residenceMinNs;    /* spread uniformly in between */
+    uint32_t residenceMaxNs;
+    double tsuPpm;              /* TSU against the master, what the servo left */
+    int32_t clockOffsetErrNs;   /* error of the T1S against TSU offset handed over */
+    bool oneStep;               /* master sends one-step Syncs */
+    bool followUpFirst;         /* master Follow_Up ahead of the egress timestamp */
+    uint32_t syncs;             /* up to GM_TC_SIM_MAX_SYNCS */
+} GmTransparentSimCase_t;
+
+typedef struct
+{
+    uint32_t forwarded;         /* two-step Sync and matching Follow_Up out */
+    int32_t residenceMinNs;
+    int32_t residenceMaxNs;
+    int32_t maxErrorNs;         /* worst offset seen by a follower, corrections applied */
+    int32_t maxUncorrectedNs;   /* the same without the residence time and the link delay */
+} GmTransparentSimResult_t;
+
+/* Starts over with nothing in flight, srcMac is the one of the T1S port */
+void GmTransparent_Init(const uint8_t srcMac[6]);
+
+/* Message of the backbone master, PTP header on. ingressNs is the TSU
+ * timestamp for a Sync, linkDelayNs the path delay of the backbone port. */
+void GmTransparent_OnIngress(const uint8_t *pMsg, uint16_t len, int64_t ingressNs, int32_t linkDelayNs);
+
+/* Next frame for the T1S segment or NULL, Syncs go out with a TX timestamp.
+ * A frame stays untouched until the next call, which is to come once it is
+ * sent. */
+const ptpFrame_t *GmTransparent_GetTx(bool *pTimestamp);
+
+/* The frame of the last GmTransparent_GetTx() is on its way */
+void GmTransparent_OnSent(void);
+
+/* Egress timestamp of the forwarded Sync on the MAC-PHY clock, which runs
+ * clockOffsetNs ahead of the TSU */
+void GmTransparent_OnEgress(bool success, int64_t egressNs, int32_t clockOffsetNs);
+
+void GmTransparent_GetStatus(GmTransparentStatus_t *pStatus);
+
+/* Runs the relay between a simulated master and follower, the residence time
+ * and the clocks of the node are simulated. The live state is lost and has
+ * to be set up again with GmTransparent_Init(). */
+void GmTransparent_SelfTest(const GmTransparentSimCase_t *pCase, GmTransparentSimResult_t *pResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GM_TRANSPARENT_H */
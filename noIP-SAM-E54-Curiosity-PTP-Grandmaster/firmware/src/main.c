@@ -48,11 +48,17 @@ Microchip or any third party.
 #include <stdlib.h>                     // Defines EXIT_FAILURE
 #include <stdio.h>                      // printf
 #include <string.h>                     // memset, memcpy
+#include <math.h>                       // sqrt
 #include "definitions.h"                // SYS function prototypes
 #include "tc6.h"
 #include "tc6-noip.h"
 #include "tc6-regs.h"
 #include "ptp.h"
+#include "ptp_frame.h"
+#include "gm_discipline.h"
+#include "gm_egress_cal.h"
+#include "gm_backbone.h"
+#include "gm_transparent.h"
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                          USER ADJUSTABLE                             */
@@ -72,11 +78,21 @@ Microchip or any third party.
 #define MAC_PROMISCUOUS_MODE        (false)
 #define MAC_TX_CUT_THROUGH          (true)
 #define MAC_RX_CUT_THROUGH          (true)
+#define PTP_ONE_STEP_SYNC           (false)
 #define DELAY_BEACON_CHECK          (2000)
 #define DELAY_STAT_PRINT            (1000)
 #define DELAY_LED                   (333)
 
 #define UDP_PAYLOAD_OFFSET          (42)
+#define FRAME_BENCH_RUNS            (256)
+#ifndef FRAME_BENCH_LEGACY
+#define FRAME_BENCH_LEGACY          0   /* 1: 'f' also times the per message build the templates replaced */
+#endif
+#if FRAME_BENCH_LEGACY==1
+#define FRAME_BENCH_FIRST           (0)
+#else
+#define FRAME_BENCH_FIRST           (2)
+#endif
 
 #define ESC_CLEAR_TERMINAL          "\033[2J"
 #define ESC_CURSOR_X1Y1             "\033[1;1H"
@@ -88,6 +104,7 @@ Microchip or any third party.
 #define ESC_RED                     "\033[0;31m"
 #define ESC_YELLOW                  "\033[1;33m"
 #define ESC_BLUE                    "\033[0;36m"
+#define KEY_ESC                     (0x1B)
 
 #define MAX_PRINT_LINES             (30)
 
@@ -120,9 +137,120 @@ typedef struct
     uint32_t errors;
 } MainStats_t;
 
+typedef struct
+{
+    uint32_t syncCnt;
+    uint32_t followUpCnt;
+    uint32_t byteCnt;
+    uint32_t regAccessCnt;
+    uint32_t calibrationCnt;
+    uint32_t overrunCnt;
+    uint32_t timeoutCnt;
+    uint32_t intervalCnt;
+    int32_t intervalMinNs;
+    int32_t intervalMaxNs;
+    double intervalSum;
+    double intervalSumSq;
+    uint32_t dispatchMaxUs;
+    uint32_t followUpMinUs;
+    uint32_t followUpMaxUs;
+    uint32_t followUpSumUs;
+} PtpStats_t;
+
+typedef struct
+{
+    int8_t logInterval;
+    uint32_t syncCnt;
+    uint32_t followUpCnt;
+    uint32_t missingCnt;
+    uint32_t timeoutCnt;
+    uint32_t overrunCnt;
+    uint32_t busyCycles;
+    uint32_t elapsedCycles;
+    uint32_t spiTransactions;
+    uint32_t spiBytes;
+    uint32_t spiClockHz;
+    uint32_t dataBytes;
+    uint32_t followUpMaxUs;
+    int32_t intervalMinNs;
+    int32_t intervalMaxNs;
+    uint32_t intervalRmsNs;
+} SyncBenchResult_t;
+
+typedef struct
+{
+    SyncBenchResult_t results[SYNC_BENCH_STEPS];
+    TC6NoIP_SpiStats_t spiStart;
+    uint32_t stepMs;
+    uint32_t startCycles;
+    uint32_t dataStart;
+    uint8_t step;
+    int8_t logInterval;
+    bool active;
+    bool settling;
+} SyncBench_t;
+
+typedef struct
+{
+    clockIdentity_t clockIdentity;
+    uint32_t lastRequest;
+    int8_t logSyncInterval;
+    bool active;
+} PtpFollower_t;
+
+typedef enum
+{
+    GM_REF_GNSS = 0,                /* external 1PPS and NMEA */
+    GM_REF_BOUNDARY,                /* backbone port, the GM sends its own Sync */
+    GM_REF_TRANSPARENT              /* backbone port, the Syncs of its master are forwarded */
+} GmReference_t;
+
 typedef struct
 {
     MainStats_t stats[BOARD_INSTANCES_MAX];
+    PtpStats_t ptpStats;
+    PtpFollower_t followers[PTP_MAX_FOLLOWERS];
+    SyncBench_t bench;
+    ptpFrame_t syncFrame;
+    ptpFrame_t followUpFrame;
+    ptpFrame_t announceFrame;
+    clockIdentity_t clockIdentity;
+    uint32_t ptpState;
+    uint32_t stateMs;
+    uint32_t lastSyncMs;
+    uint32_t syncSentCycles;
+    uint32_t oneStepSec;
+    uint32_t oneStepNsec;
+    uint32_t timestampSec;
+    uint32_t timestampNsec;
+    uint64_t lastEgressNs;
+    volatile uint32_t syncDueCycles;
+    uint16_t seqId;
+    uint16_t lastEgressSeq;
+    uint16_t announceSeqId;
+    uint16_t gmTimeBaseIndicator;
+    uint32_t nextAnnounce;
+    uint32_t discLanSec;
+    bool discLanValid;
+    volatile bool syncDue;
+    bool syncOneStep;
+    bool calibrate;
+    bool secReread;
+    bool lastEgressValid;
+    uint32_t syncPeriodMs;
+    uint32_t syncPeriodNs;
+    uint32_t syncGuardTicks;
+    volatile uint64_t syncTimelineNs;
+    uint32_t busyCycles;
+    int8_t syncLogInterval;
+    int32_t egressLatencyNs;
+    int32_t txTimestampOffsetNs;
+    GmEgressCalSetup_t calSetup;
+    GmEgressCalState_t calState;
+    bool txOffsetCalibrated;
+    uint8_t t1sMac[6];
+    uint8_t backboneMac[6];
+    GmReference_t reference;
     uint32_t nextStat;
     uint32_t nextBeaconCheck;
     uint32_t nextLed;
@@ -134,6 +262,8 @@ typedef struct
     bool lastBeaconState;
     volatile bool txBusy;
     bool allowTxStress;
+    bool oneStep;
+    bool nmeaConsole;
 } MainLocal_t;
 
 static MainLocal_t m;
@@ -338,33 +468,71 @@ static uint8_t iperf[] = {
 
 static char *MoveCursor(bool newLine);
 static void PrintMenu(void);
+static void PrintPtpStats(void);
 static void CheckUartInput(void);
 static void SendIperfPacket(void);
 static void CheckButton(uint8_t instance, bool newLevel, bool *oldLevel);
 static void OnSendIperf(void *pDummy, const uint8_t *pTx, uint16_t len, uint32_t idx, void *pDummy2);
 
-static uint32_t invert_uint32(uint32_t in);
 static uint16_t invert_uint16(uint16_t in);
 static uint32_t init_PTP_master(void);
-static void register_access_helper_function(bool success, uint32_t *state_var, uint32_t next_state);
+#if FRAME_BENCH_LEGACY==1
+static uint32_t invert_uint32(uint32_t in);
+static void fill_sync_msg(syncMsg_t *msg, const uint8_t *clk, uint16_t seq_id, bool two_step);
+static void LegacyBuildSync(uint8_t *pBuf);
+static void LegacyBuildFollowUp(uint8_t *pBuf);
+#endif
+static void PrintFrameBuildCost(void);
+static void PtpService(uint32_t now);
+static void PtpSendSync(void);
+static void PtpSendFollowUp(void);
+static void PtpUpdateEgressStats(void);
+static void OnSyncTimer(TC_TIMER_STATUS status, uintptr_t context);
+static void OnPtpTimeRead(int8_t idx, bool success, uint32_t addr, uint32_t value);
+static void OnPtpTxTimestamp(int8_t idx, bool success, uint32_t sec, uint32_t nsec);
+static uint32_t CyclesToUs(uint32_t cycles);
+static void OnPtpSignaling(const signalingMsg_t *msg);
+static void UpdateSyncInterval(void);
+static void SetSyncPeriod(int8_t logInterval);
+static bool SyncGuardClear(void);
+static uint64_t SyncTimelineNs(void);
+static void ToggleTxGate(void);
+static void PrintTxGateStats(void);
+static void SyncBenchStart(uint32_t now);
+static void SyncBenchService(uint32_t now);
+static void SyncBenchRecord(SyncBenchResult_t *res);
+static void PrintSyncBench(void);
+static void PtpSendAnnounce(uint32_t now);
+static void PtpUpdateTimeBase(void);
+static void OnPpsCapture(TC_CAPTURE_STATUS status, uintptr_t context);
+static bool DiscSetRate(double ppb);
+static bool DiscStepNs(int32_t ns);
+static bool DiscSetTime(uint32_t sec, uint32_t nsec);
+static bool DiscReadTime(void);
+static void OnDiscTimeRead(int8_t idx, bool success, uint32_t addr, uint32_t value);
+static void PrintDiscipline(void);
+static void RunDisciplineSelfTest(void);
+static void LoadTxTimestampOffset(void);
+static void ToggleEgressCalibration(void);
+static void EgressCalService(uint32_t ticks, uint32_t now);
+static void RestartDiscipline(void);
+static void SelectPpsSource(bool tsu);
+static void CycleReference(void);
+static void BoundaryService(uint32_t now);
+static void TransparentService(uint32_t now);
+static void PrintBackbone(void);
+static void RunBoundarySelfTest(void);
+static void RunTransparentSelfTest(void);
+
+static const GmDisciplineActuator_t discActuator = {DiscSetRate, DiscStepNs, DiscSetTime, DiscReadTime};
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                         PUBLIC FUNCTIONS                             */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
-uint8_t temp_buffer[256] = {0};
-static uint32_t TC6_read_value = 0;
-
 int main(void)
 {
-    //this is for demo purposes: It shows that even if the timestamp is delayed several ms, the PTP will still work
-    uint32_t dly = 0;
-
-    uint16_t seq_id = 0;
-    uint32_t PTP_task_state = PTP_STATE_send_sync;
-    uint32_t Timestamp_Register = 0;
-    uint32_t timestamp_sec;
-    uint32_t timestamp_nsec;
-    const uint8_t temp_clk[8] = {0x40, 0x84, 0x32, 0xff, 0xfe, 0x7d, 0x07, 0xfa};
-    uint32_t last_now = 0;
+    static const uint8_t default_clk[8] = {0x40, 0x84, 0x32, 0xff, 0xfe, 0x7d, 0x07, 0xfa};
+    uint8_t mac[6] = {0x40, 0x84, 0x32, 0x7d, 0x07, 0xfa};
+    ptpFrameConfig_t frameCfg;
     uint32_t now = 0;
     uint32_t init_res = 0;
 
@@ -387,10 +555,37 @@ int main(void)
         PRINT(ESC_RED "%sFailed to initialize TC6 noIP Driver" ESC_RESETCOLOR "\r\n", MoveCursor(true));
         goto ERROR;
     }
+    memcpy(m.clockIdentity, default_clk, sizeof(clockIdentity_t));
+    /* EUI-64 clock identity out of the MAC address, followers tell GMs apart by it */
+    if (TC6NoIP_GetMacAddress(m.idxNoIp, mac)) {
+        memcpy(&m.clockIdentity[0], &mac[0], 3);
+        m.clockIdentity[3] = 0xFF;
+        m.clockIdentity[4] = 0xFE;
+        memcpy(&m.clockIdentity[5], &mac[3], 3);
+    }
+    /* The backbone port uses a locally administered variant */
+    memcpy(m.t1sMac, mac, sizeof(m.t1sMac));
+    memcpy(m.backboneMac, mac, sizeof(m.backboneMac));
+    m.backboneMac[0] |= 0x02u;
+    /* Sync and FollowUp are built once, only the per message fields are patched later */
+    memset(&frameCfg, 0, sizeof(frameCfg));
+    memcpy(frameCfg.srcMac, mac, sizeof(frameCfg.srcMac));
+    memcpy(frameCfg.clockIdentity, m.clockIdentity, sizeof(frameCfg.clockIdentity));
+    frameCfg.portNumber = 1;
+    frameCfg.logMessageInterval = SYNC_LOG_INTERVAL_DEFAULT;
+    frameCfg.twoStep = !PTP_ONE_STEP_SYNC;
+    (void)ptpFrameBuild(&m.syncFrame, PTP_FRAME_SYNC, &frameCfg);
+    (void)ptpFrameBuild(&m.followUpFrame, PTP_FRAME_FOLLOW_UP, &frameCfg);
+    (void)ptpFrameBuild(&m.announceFrame, PTP_FRAME_ANNOUNCE, &frameCfg);
+    ptpFrameSetLogInterval(&m.announceFrame, 0);
 
     m.nextStat = DELAY_STAT_PRINT;
     m.nextBeaconCheck = DELAY_BEACON_CHECK;
     m.allowTxStress = false;
+    m.oneStep = PTP_ONE_STEP_SYNC;
+    m.egressLatencyNs = ONE_STEP_EGRESS_LATENCY_NS;
+    m.txTimestampOffsetNs = STATIC_OFFSET;
+    m.ptpState = PTP_STATE_idle;
 
     PrintMenu();
     while(true)
@@ -406,224 +601,66 @@ int main(void)
         DBG_PRINT("Init res: %i\r\n",init_res );
         goto ERROR;
     }
+
+    /* Cycle counter for the dispatch and FollowUp latency statistics */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* TC0 raises the Sync period, the capture interrupt of the MAC-PHY triggers the FollowUp */
+    TC0_TimerCallbackRegister(OnSyncTimer, 0);
+    SetSyncPeriod(SYNC_LOG_INTERVAL_DEFAULT);
+    TC0_TimerStart();
+
+    /* Data is held off around the Syncs, which are scheduled on the TC0 timeline */
+    TC6NoIP_TxGateSetup(m.idxNoIp, SyncTimelineNs, SYNC_GUARD_TIME_US * 1000u, SYNC_FOLLOWUP_GUARD_US * 1000u);
+    TC6NoIP_TxGateEnable(m.idxNoIp, true);
+
+    LoadTxTimestampOffset();
+
+    /* TC4 captures the external 1PPS (CC0) and the 1PPS output of the MAC-PHY (CC1) */
+    GmDiscipline_Init(&discActuator, TC4_CaptureFrequencyGet());
+    TC4_CaptureCallbackRegister(OnPpsCapture, 0);
+    TC4_CaptureStart();
+
     while (true)
     {
+        uint32_t busyStart;
+        uint32_t ppsTicks;
+
         /* Maintain state machines of all polled MPLAB Harmony modules. */
         SYS_Tasks();
 
+        busyStart = DWT->CYCCNT;
         TC6NoIP_Service();
         now = systick.tickCounter;
 
-        if((false == m.txBusy) && (true == m.allowTxStress) )
+        /* Data goes through the TX gate, between the FollowUp and the guard time ahead of the next Sync */
+        if((false == m.txBusy) && (true == m.allowTxStress))
         {
-            if((systick.tickCounter-last_now > SYN_MESSAGE_CLEAR_TIME_MS) && (systick.tickCounter-last_now < ((SYNC_MESSAGE_PERIOD_MS-SYN_MESSAGE_CLEAR_TIME_MS)+dly)))
-            {
-                SendIperfPacket();
-                TC6NoIP_Service();
-            }
+            SendIperfPacket();
+            TC6NoIP_Service();
         }
 
-        switch(PTP_task_state)
+        if (GM_REF_TRANSPARENT == m.reference) {
+            TransparentService(now);
+        } else {
+            PtpService(now);
+        }
+        if (GM_REF_GNSS != m.reference) {
+            BoundaryService(now);
+        }
+        ppsTicks = TC4_Capture32bitCounterGet();
+        GmDiscipline_Service(ppsTicks, now);
+        EgressCalService(ppsTicks, now);
+        if ((GM_REF_TRANSPARENT != m.reference) && (false == m.txBusy) && (PTP_STATE_idle == m.ptpState) &&
+            !m.syncDue && SyncGuardClear())
         {
-            case PTP_STATE_send_sync:
-            {
-                if(((now - last_now) > (SYNC_MESSAGE_PERIOD_MS+dly)) && (false == m.txBusy) )
-                {
-                    DBG_PRINT("SYSTICK: %i\r\n", now);
-                    DBG_PRINT("sync:\r\n");
-                    dly++;
-                    if(dly>MAX_DELAY_MS) dly=0;
-                    last_now = now;
-
-                    syncMsg_t msg;
-                    memset(&msg, 0, sizeof(syncMsg_t));
-
-                    msg.header.tsmt = 0x10;
-                    msg.header.version = 0x02;
-                    msg.header.messageLength = invert_uint16((uint16_t) 0x2c);
-                    msg.header.domainNumber = 0;
-                    msg.header.flags[0] = 0x02;
-                    msg.header.flags[1] = 0x08;
-                    msg.header.correctionField = 0;
-
-                    memcpy( &msg.header.sourcePortIdentity.clockIdentity, temp_clk, 8);
-                    msg.header.sourcePortIdentity.portNumber = 1;
-                    msg.header.sequenceID = invert_uint16(seq_id);
-                    msg.header.controlField = 2;
-                    msg.header.logMessageInterval = 0xfd;
-
-                    memcpy(temp_buffer, buffer_header, BUFFER_HEADER_LEN);
-                    memcpy( &temp_buffer[BUFFER_HEADER_LEN],&msg, sizeof(syncMsg_t));
-                    m.txBusy = true;
-                    if (TC6NoIP_SendEthernetPacket_TimestampA(m.idxNoIp, temp_buffer, sizeof(syncMsg_t)+BUFFER_HEADER_LEN, OnSendIperf))
-                    {
-                        PTP_task_state = PTP_STATE_get_tx_status;
-                    }
-                    else
-                    {
-                        m.txBusy = false;
-                    }
-                    TC6NoIP_Service();
-                }
-                break;
-            } //case PTP_STATE_send_sync:
-            
-            case PTP_STATE_get_tx_status:
-            {
-                DBG_PRINT("gTX:\r\n");
-                register_access_helper_function(TC6_get_TXStatus(m.idxNoIp), &PTP_task_state, PTP_STATE_get_oa_status0);
-                break;
-            } //case PTP_STATE_get_tx_status:
-            
-            case PTP_STATE_get_oa_status0:
-            {
-                DBG_PRINT("gSTS:\r\n");
-                if(true == TC6_get_last_read_complete())
-                {
-                    TC6_read_value = TC6_get_last_read_value();
-                    if(TC6_read_value & TXMCTL_TXPMDET) //Transmit Packet Match Detection (Sync Message))
-                    {
-                        register_access_helper_function(TC6_read_OA_STATUS0_reg(m.idxNoIp), &PTP_task_state, PTP_STATE_get_timestamp_reg_sec);
-                    }
-                    else
-                    {
-                        DBG_PRINT("ERRORSTS:\r\n");
-                        PTP_task_state = PTP_STATE_send_sync;
-                    }
-                }
-                break;
-            } //case PTP_STATE_get_oa_status0:
-            
-            case PTP_STATE_get_timestamp_reg_sec:
-            {
-                DBG_PRINT("gsec:\r\n");
-                if(true == TC6_get_last_read_complete())
-                {
-                    TC6_read_value = TC6_get_last_read_value();
-                    Timestamp_Register = TC6_read_value;
-                    if(Timestamp_Register & OA_STS0_TTSCAA)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCAH), &PTP_task_state, PTP_STATE_get_timestamp_reg_nsec);
-                    }
-                    else if(Timestamp_Register & OA_STS0_TTSCAB)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCBH), &PTP_task_state, PTP_STATE_get_timestamp_reg_nsec);
-                    }
-                    else if(Timestamp_Register & OA_STS0_TTSCAC)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCCH), &PTP_task_state, PTP_STATE_get_timestamp_reg_nsec);
-                    }
-                    else
-                    {
-                        //ERROR!!!
-                        DBG_PRINT("ERRORsec:\r\n");
-                        PTP_task_state = PTP_STATE_send_sync;
-                    }
-                }
-                break;
-            } //case PTP_STATE_get_timestamp_reg_sec:
-            
-            case PTP_STATE_get_timestamp_reg_nsec:
-            {
-                DBG_PRINT("gnsec:\r\n");
-                if(true == TC6_get_last_read_complete())
-                {
-                    TC6_read_value = TC6_get_last_read_value();
-                    timestamp_sec = TC6_read_value;
-                    if(Timestamp_Register & OA_STS0_TTSCAA)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCAL), &PTP_task_state, PTP_STATE_clear_status_reg);
-                    }
-                    else if(Timestamp_Register & OA_STS0_TTSCAB)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCBL), &PTP_task_state, PTP_STATE_clear_status_reg);
-                    }
-                    else if(Timestamp_Register & OA_STS0_TTSCAC)
-                    {
-                        register_access_helper_function(TC6_read_reg(m.idxNoIp, OA_TTSCCL), &PTP_task_state, PTP_STATE_clear_status_reg);
-                    }
-                    else
-                    {
-                        //ERROR!!!
-                        DBG_PRINT("ERRORnsec:\r\n");
-                        PTP_task_state = PTP_STATE_send_sync;
-                    }
-                }
-                break;
-            } //case PTP_STATE_get_timestamp_reg_nsec:
-            
-            case PTP_STATE_clear_status_reg:
-            {
-                DBG_PRINT("clrSTS:\r\n");
-                if(true == TC6_get_last_read_complete())
-                {
-                    TC6_read_value = TC6_get_last_read_value();
-                    timestamp_nsec = TC6_read_value;
-                    register_access_helper_function(TC6_write_reg(m.idxNoIp, OA_STATUS0, invert_uint16(Timestamp_Register)), &PTP_task_state, PTP_STATE_send_followup);
-                }
-                break;
-            } //case PTP_STATE_clear_status_reg:
-            
-            case PTP_STATE_send_followup:
-            {
-                DBG_PRINT("follow:\r\n");
-
-                followUpMsg_t msg2;
-                memset(&msg2, 0, sizeof(followUpMsg_t));
-
-                msg2.preciseOriginTimestamp.secondsLsb = timestamp_sec;
-                msg2.preciseOriginTimestamp.nanoseconds =  timestamp_nsec + STATIC_OFFSET;
-                if(msg2.preciseOriginTimestamp.nanoseconds > MAX_MAC_TN_VAL)
-                {
-                    msg2.preciseOriginTimestamp.nanoseconds = msg2.preciseOriginTimestamp.nanoseconds - MAX_MAC_TN_VAL;
-                    msg2.preciseOriginTimestamp.secondsLsb++;
-                }
-                msg2.preciseOriginTimestamp.secondsLsb = invert_uint32(msg2.preciseOriginTimestamp.secondsLsb);
-                msg2.preciseOriginTimestamp.nanoseconds = invert_uint32(msg2.preciseOriginTimestamp.nanoseconds);
-
-                msg2.header.tsmt = 0x18;
-                msg2.header.version = 0x02;
-                msg2.header.messageLength = invert_uint16((uint16_t)0x4c);
-                msg2.header.domainNumber = 0;
-                msg2.header.flags[0] = 0x00;
-                msg2.header.flags[1] = 0x08;
-                msg2.header.correctionField = 0;
-
-                memcpy( &msg2.header.sourcePortIdentity.clockIdentity, temp_clk, 8);
-                msg2.header.sourcePortIdentity.portNumber = 1;
-                msg2.header.sequenceID = invert_uint16(seq_id);
-                msg2.header.controlField = 2;
-                msg2.header.logMessageInterval = 0xfd;
-
-                msg2.tlv.tlvType = invert_uint16((uint16_t)0x03);
-                msg2.tlv.lengthField = invert_uint16((uint16_t)28);
-                msg2.tlv.organizationId[0] = 0x00;
-                msg2.tlv.organizationId[1] = 0x80;
-                msg2.tlv.organizationId[2] = 0xc2;
-                msg2.tlv.organizationSubType[2] = 0x01;
-                msg2.tlv.cumulativescaledRateOffset = 0;
-                msg2.tlv.gmTimeBaseIndicator = 0;
-
-                memcpy( temp_buffer, buffer_header, BUFFER_HEADER_LEN);
-                memcpy( &temp_buffer[BUFFER_HEADER_LEN], &msg2, sizeof(followUpMsg_t));
-                m.txBusy = true;
-                if (TC6NoIP_SendEthernetPacket(m.idxNoIp, temp_buffer, sizeof(followUpMsg_t)+BUFFER_HEADER_LEN, OnSendIperf))
-                {
-                    DBG_PRINT("msgsent:\r\n");
-                    PTP_task_state = PTP_STATE_send_sync;
-                    seq_id++;
-                }
-                else
-                {
-                    m.txBusy = false;
-                }
-                TC6NoIP_Service();
-                break;
-            } //case PTP_STATE_send_followup:
-            
-            default:
-                break;
-        } //end switch(PTP_task_state)
+            PtpUpdateTimeBase();
+            PtpSendAnnounce(now);
+        }
+        m.busyCycles += DWT->CYCCNT - busyStart;
+        SyncBenchService(now);
 
         if (now > m.nextLed)
         {
@@ -652,27 +689,1060 @@ ERROR:
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                  PRIVATE  FUNCTION IMPLEMENTATIONS                   */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
-static void register_access_helper_function(bool success, uint32_t *state_var, uint32_t next_state)
+/* Runs the Sync/FollowUp engine on the events raised by the timer and the
+ * MAC-PHY, nothing is polled */
+static void PtpService(uint32_t now)
+{
+    uint32_t timeoutMs = (m.syncPeriodMs < SYNC_TIMESTAMP_TIMEOUT_MS) ? m.syncPeriodMs : SYNC_TIMESTAMP_TIMEOUT_MS;
+    if ((PTP_STATE_idle != m.ptpState) && ((now - m.stateMs) > timeoutMs)) {
+        DBG_PRINT("timeout %lu\r\n", m.ptpState);
+        m.ptpStats.timeoutCnt++;
+        m.ptpState = PTP_STATE_idle;
+    }
+    switch (m.ptpState) {
+        case PTP_STATE_idle:
+            if (m.syncDue) {
+                m.syncDue = false;
+                UpdateSyncInterval();
+                m.stateMs = now;
+                m.syncOneStep = m.oneStep;
+                m.calibrate = false;
+                m.secReread = false;
+                if (m.syncOneStep) {
+                    m.ptpState = PTP_STATE_read_time;
+                    if (!TC6NoIP_ReadRegisters(m.idxNoIp, MAC_TSL, 2u, OnPtpTimeRead)) {
+                        m.ptpState = PTP_STATE_idle;
+                    }
+                } else {
+                    m.ptpState = PTP_STATE_send_sync;
+                    PtpSendSync();
+                }
+            }
+            break;
+        case PTP_STATE_send_sync:
+            PtpSendSync();
+            break;
+        case PTP_STATE_send_followup:
+            PtpSendFollowUp();
+            break;
+        default:
+            /* Register reads or timestamp capture in flight */
+            break;
+    }
+}
+
+static void PtpSendSync(void)
+{
+    ptpFrame_t *frame = &m.syncFrame;
+    bool timestamp = true;
+    bool sent;
+
+    if (m.txBusy) {
+        return;
+    }
+    ptpFrameSetSequenceId(frame, m.seqId);
+    ptpFrameSetTwoStep(frame, !m.syncOneStep);
+    if (m.syncOneStep) {
+        uint64_t origin = ((uint64_t)m.oneStepSec * MAX_MAC_TN_VAL) + m.oneStepNsec + (uint64_t)m.egressLatencyNs;
+        ptpFrameSetTimestamp(frame, origin / MAX_MAC_TN_VAL, (uint32_t)(origin % MAX_MAC_TN_VAL));
+        /* Only every n-th Sync is timestamped, to keep the egress latency calibrated */
+        m.calibrate = (0 == (m.ptpStats.syncCnt % ONE_STEP_CALIBRATION_INTERVAL));
+        timestamp = m.calibrate;
+    } else {
+        ptpFrameSetTimestamp(frame, 0, 0);
+    }
+
+    m.txBusy = true;
+    if (timestamp) {
+        sent = TC6NoIP_SendEthernetPacket_TimestampA(m.idxNoIp, frame->buf, frame->len, OnSendIperf);
+    } else {
+        sent = TC6NoIP_SendEthernetPacket(m.idxNoIp, frame->buf, frame->len, OnSendIperf);
+    }
+    if (!sent) {
+        m.txBusy = false;
+        return;
+    }
+    m.syncSentCycles = DWT->CYCCNT;
+    uint32_t dispatchUs = CyclesToUs(m.syncSentCycles - m.syncDueCycles);
+    if (dispatchUs > m.ptpStats.dispatchMaxUs) {
+        m.ptpStats.dispatchMaxUs = dispatchUs;
+    }
+    m.lastSyncMs = systick.tickCounter;
+    m.ptpStats.syncCnt++;
+    m.ptpStats.byteCnt += frame->len;
+    if (timestamp) {
+        m.stateMs = m.lastSyncMs;
+        m.ptpState = PTP_STATE_wait_timestamp;
+    } else {
+        m.ptpState = PTP_STATE_idle;
+        m.seqId++;
+    }
+    TC6NoIP_Service();
+}
+
+static void PtpSendFollowUp(void)
 {
-    static uint32_t num_reg_access_failures = 0;
-    if(true == success )
+    if (m.calibrate) {
+        /* The Sync was sent one-step, use its capture to correct the egress latency */
+        int64_t departure = ((int64_t)m.timestampSec * MAX_MAC_TN_VAL) + m.timestampNsec + m.txTimestampOffsetNs;
+        int64_t measured = departure - (((int64_t)m.oneStepSec * MAX_MAC_TN_VAL) + m.oneStepNsec);
+        if((measured > 0) && (measured < (int64_t)m.syncPeriodNs))
+        {
+            if(0 == m.ptpStats.calibrationCnt)
+            {
+                m.egressLatencyNs = (int32_t)measured;
+            }
+            else
+            {
+                m.egressLatencyNs += ((int32_t)measured - m.egressLatencyNs) / 4;
+            }
+            m.ptpStats.calibrationCnt++;
+        }
+        DBG_PRINT("lat: %li\r\n", (int32_t)measured);
+        m.calibrate = false;
+        m.ptpState = PTP_STATE_idle;
+        m.seqId++;
+        return;
+    }
+    if (m.txBusy) {
+        return;
+    }
+
+    ptpFrame_t *frame = &m.followUpFrame;
+    uint64_t sec = m.timestampSec;
+    uint32_t nsec = m.timestampNsec + (uint32_t)m.txTimestampOffsetNs;
+    if (nsec >= MAX_MAC_TN_VAL) {
+        nsec -= MAX_MAC_TN_VAL;
+        sec++;
+    }
+    ptpFrameSetSequenceId(frame, m.seqId);
+    ptpFrameSetTimestamp(frame, sec, nsec);
+
+    m.txBusy = true;
+    if (TC6NoIP_SendEthernetPacket(m.idxNoIp, frame->buf, frame->len, OnSendIperf))
     {
-        num_reg_access_failures = 0;
-        *state_var = next_state;
+        uint32_t latencyUs = CyclesToUs(DWT->CYCCNT - m.syncSentCycles);
+        if ((0 == m.ptpStats.followUpCnt) || (latencyUs < m.ptpStats.followUpMinUs)) {
+            m.ptpStats.followUpMinUs = latencyUs;
+        }
+        if (latencyUs > m.ptpStats.followUpMaxUs) {
+            m.ptpStats.followUpMaxUs = latencyUs;
+        }
+        m.ptpStats.followUpSumUs += latencyUs;
+        m.ptpStats.followUpCnt++;
+        TC6NoIP_TxGateAddPtpLatency(m.idxNoIp, latencyUs * 1000u);
+        m.ptpStats.byteCnt += frame->len;
+        m.ptpState = PTP_STATE_idle;
+        m.seqId++;
     }
     else
     {
-        num_reg_access_failures++;
-        if(num_reg_access_failures > MAX_NUM_REG_RETRIES)
-        {
-            num_reg_access_failures = 0;
-            *state_var = PTP_STATE_send_sync;
-            DBG_PRINT("RegAccessFail!\r\n");
+        m.txBusy = false;
+    }
+    TC6NoIP_Service();
+}
+
+/* Sync period jitter out of consecutive egress timestamps, against the nominal period */
+static void PtpUpdateEgressStats(void)
+{
+    uint64_t egress = ((uint64_t)m.timestampSec * MAX_MAC_TN_VAL) + m.timestampNsec;
+    if (m.lastEgressValid && ((uint16_t)(m.lastEgressSeq + 1u) == m.seqId)) {
+        int64_t dev = (int64_t)(egress - m.lastEgressNs) - (int64_t)m.syncPeriodNs;
+        if ((dev > -(int64_t)INT32_MAX) && (dev < (int64_t)INT32_MAX)) {
+            if ((0 == m.ptpStats.intervalCnt) || (dev < m.ptpStats.intervalMinNs)) {
+                m.ptpStats.intervalMinNs = (int32_t)dev;
+            }
+            if ((0 == m.ptpStats.intervalCnt) || (dev > m.ptpStats.intervalMaxNs)) {
+                m.ptpStats.intervalMaxNs = (int32_t)dev;
+            }
+            m.ptpStats.intervalSum += (double)dev;
+            m.ptpStats.intervalSumSq += (double)dev * (double)dev;
+            m.ptpStats.intervalCnt++;
+        }
+    }
+    m.lastEgressNs = egress;
+    m.lastEgressSeq = m.seqId;
+    m.lastEgressValid = true;
+}
+
+static void OnSyncTimer(TC_TIMER_STATUS status, uintptr_t context)
+{
+    (void)status;
+    (void)context;
+    if (m.syncDue || (PTP_STATE_idle != m.ptpState)) {
+        m.ptpStats.overrunCnt++;
+    }
+    m.syncDueCycles = DWT->CYCCNT;
+    m.syncTimelineNs += m.syncPeriodNs;
+    m.syncDue = true;
+}
+
+static void OnPtpTimeRead(int8_t idx, bool success, uint32_t addr, uint32_t value)
+{
+    if (PTP_STATE_read_time != m.ptpState) {
+        return;
+    }
+    if (!success) {
+        m.ptpState = PTP_STATE_idle;
+        return;
+    }
+    m.ptpStats.regAccessCnt++;
+    if (MAC_TSL == addr) {
+        m.oneStepSec = value;
+        if (m.secReread) {
+            m.ptpState = PTP_STATE_send_sync;
+        }
+    } else if (value < ONE_STEP_ROLLOVER_GUARD_NS) {
+        /* Seconds may have been read before the rollover, read them again */
+        m.oneStepNsec = value;
+        m.secReread = true;
+        if (!TC6NoIP_ReadRegister(idx, MAC_TSL, OnPtpTimeRead)) {
+            m.ptpState = PTP_STATE_idle;
+        }
+    } else {
+        m.oneStepNsec = value;
+        m.ptpState = PTP_STATE_send_sync;
+    }
+}
+
+static void OnPtpTxTimestamp(int8_t idx, bool success, uint32_t sec, uint32_t nsec)
+{
+    (void)idx;
+    if (PTP_STATE_wait_timestamp != m.ptpState) {
+        DBG_PRINT("Stray capture\r\n");
+        return;
+    }
+    if (!success) {
+        m.ptpState = PTP_STATE_idle;
+        return;
+    }
+    m.ptpStats.regAccessCnt += 2u;
+    m.timestampSec = sec;
+    m.timestampNsec = nsec;
+    if (!m.calibrate) {
+        PtpUpdateEgressStats();
+    }
+    m.ptpState = PTP_STATE_send_followup;
+}
+
+static uint32_t CyclesToUs(uint32_t cycles)
+{
+    return cycles / (CPU_CLOCK_FREQUENCY / 1000000u);
+}
+
+#if FRAME_BENCH_LEGACY==1
+static void fill_sync_msg(syncMsg_t *msg, const uint8_t *clk, uint16_t seq_id, bool two_step)
+{
+    memset(msg, 0, sizeof(syncMsg_t));
+
+    msg->header.tsmt = 0x10;
+    msg->header.version = 0x02;
+    msg->header.messageLength = invert_uint16((uint16_t) 0x2c);
+    msg->header.domainNumber = 0;
+    msg->header.flags[0] = two_step ? 0x02 : 0x00;
+    msg->header.flags[1] = 0x08;
+    msg->header.correctionField = 0;
+
+    memcpy( &msg->header.sourcePortIdentity.clockIdentity, clk, 8);
+    msg->header.sourcePortIdentity.portNumber = 1;
+    msg->header.sequenceID = invert_uint16(seq_id);
+    msg->header.controlField = 2;
+    msg->header.logMessageInterval = (uint8_t)m.syncLogInterval;
+}
+
+/* Per message build as done before the frame templates, only built with
+ * FRAME_BENCH_LEGACY as the reference for PrintFrameBuildCost() */
+static const uint8_t legacyEthHeader[BUFFER_HEADER_LEN] = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x0e, 0x40, 0x84, 0x32, 0x7d, 0x07, 0xfa, 0x88, 0xf7};
+
+static void LegacyBuildSync(uint8_t *pBuf)
+{
+    syncMsg_t msg;
+    fill_sync_msg(&msg, m.clockIdentity, m.seqId, true);
+    memcpy(pBuf, legacyEthHeader, BUFFER_HEADER_LEN);
+    memcpy(&pBuf[BUFFER_HEADER_LEN], &msg, sizeof(syncMsg_t));
+}
+
+static void LegacyBuildFollowUp(uint8_t *pBuf)
+{
+    followUpMsg_t msg2;
+    memset(&msg2, 0, sizeof(followUpMsg_t));
+
+    msg2.preciseOriginTimestamp.secondsLsb = m.timestampSec;
+    msg2.preciseOriginTimestamp.nanoseconds =  m.timestampNsec + (uint32_t)m.txTimestampOffsetNs;
+    if(msg2.preciseOriginTimestamp.nanoseconds > MAX_MAC_TN_VAL)
+    {
+        msg2.preciseOriginTimestamp.nanoseconds = msg2.preciseOriginTimestamp.nanoseconds - MAX_MAC_TN_VAL;
+        msg2.preciseOriginTimestamp.secondsLsb++;
+    }
+    msg2.preciseOriginTimestamp.secondsLsb = invert_uint32(msg2.preciseOriginTimestamp.secondsLsb);
+    msg2.preciseOriginTimestamp.nanoseconds = invert_uint32(msg2.preciseOriginTimestamp.nanoseconds);
+
+    msg2.header.tsmt = 0x18;
+    msg2.header.version = 0x02;
+    msg2.header.messageLength = invert_uint16((uint16_t)0x4c);
+    msg2.header.domainNumber = 0;
+    msg2.header.flags[0] = 0x00;
+    msg2.header.flags[1] = 0x08;
+    msg2.header.correctionField = 0;
+
+    memcpy( &msg2.header.sourcePortIdentity.clockIdentity, m.clockIdentity, 8);
+    msg2.header.sourcePortIdentity.portNumber = 1;
+    msg2.header.sequenceID = invert_uint16(m.seqId);
+    msg2.header.controlField = 2;
+    msg2.header.logMessageInterval = (uint8_t)m.syncLogInterval;
+
+    msg2.tlv.tlvType = invert_uint16((uint16_t)0x03);
+    msg2.tlv.lengthField = invert_uint16((uint16_t)28);
+    msg2.tlv.organizationId[0] = 0x00;
+    msg2.tlv.organizationId[1] = 0x80;
+    msg2.tlv.organizationId[2] = 0xc2;
+    msg2.tlv.organizationSubType[2] = 0x01;
+    msg2.tlv.cumulativescaledRateOffset = 0;
+    msg2.tlv.gmTimeBaseIndicator = 0;
+
+    memcpy( pBuf, legacyEthHeader, BUFFER_HEADER_LEN);
+    memcpy( &pBuf[BUFFER_HEADER_LEN], &msg2, sizeof(followUpMsg_t));
+}
+#endif
+
+/* CPU cycles to get a message ready for TX: full build per message against
+ * patching the template. Works on copies, the live frames may be in flight.
+ * min is the undisturbed figure, avg includes interrupts. */
+static void PrintFrameBuildCost(void)
+{
+#if FRAME_BENCH_LEGACY==1
+    static uint8_t legacyBuf[BUFFER_HEADER_LEN + sizeof(followUpMsg_t)];
+#endif
+    static ptpFrame_t frames[4];
+    static const char *names[] = {"Sync legacy", "FollowUp legacy", "Sync patch", "FollowUp patch",
+                                  "Pdelay_Resp patch", "Announce patch", "template build"};
+    uint32_t minCycles[7];
+    uint32_t sumCycles[7];
+    ptpFrameConfig_t cfg;
+
+    memset(&cfg, 0, sizeof(cfg));
+    memcpy(cfg.srcMac, &m.syncFrame.buf[6], sizeof(cfg.srcMac));
+    memcpy(cfg.clockIdentity, m.clockIdentity, sizeof(cfg.clockIdentity));
+    cfg.portNumber = 1;
+    cfg.logMessageInterval = m.syncLogInterval;
+    cfg.twoStep = true;
+    (void)ptpFrameBuild(&frames[0], PTP_FRAME_SYNC, &cfg);
+    (void)ptpFrameBuild(&frames[1], PTP_FRAME_FOLLOW_UP, &cfg);
+    (void)ptpFrameBuild(&frames[2], PTP_FRAME_PDELAY_RESP, &cfg);
+    (void)ptpFrameBuild(&frames[3], PTP_FRAME_ANNOUNCE, &cfg);
+
+    for (uint32_t t = FRAME_BENCH_FIRST; t < 7; t++) {
+        minCycles[t] = UINT32_MAX;
+        sumCycles[t] = 0;
+        for (uint32_t i = 0; i < FRAME_BENCH_RUNS; i++) {
+            uint16_t seqId = (uint16_t)(m.seqId + i);
+            uint32_t start = DWT->CYCCNT;
+            uint32_t cycles;
+            switch (t) {
+#if FRAME_BENCH_LEGACY==1
+                case 0:
+                    LegacyBuildSync(legacyBuf);
+                    break;
+                case 1:
+                    LegacyBuildFollowUp(legacyBuf);
+                    break;
+#endif
+                case 2:
+                    ptpFrameSetSequenceId(&frames[0], seqId);
+                    ptpFrameSetTwoStep(&frames[0], true);
+                    ptpFrameSetTimestamp(&frames[0], 0, 0);
+                    break;
+                case 3:
+                    ptpFrameSetSequenceId(&frames[1], seqId);
+                    ptpFrameSetTimestamp(&frames[1], m.timestampSec, m.timestampNsec);
+                    break;
+                case 4:
+                    ptpFrameSetSequenceId(&frames[2], seqId);
+                    ptpFrameSetTimestamp(&frames[2], m.timestampSec, m.timestampNsec);
+                    ptpFrameSetRequestingPort(&frames[2], m.clockIdentity, 1);
+                    ptpFrameSetCorrection(&frames[2], 0);
+                    break;
+                case 5:
+                    ptpFrameSetSequenceId(&frames[3], seqId);
+                    ptpFrameSetTimestamp(&frames[3], m.timestampSec, m.timestampNsec);
+                    break;
+                default:
+                    (void)ptpFrameBuild(&frames[1], PTP_FRAME_FOLLOW_UP, &cfg);
+                    break;
+            }
+            cycles = DWT->CYCCNT - start;
+            if (cycles < minCycles[t]) {
+                minCycles[t] = cycles;
+            }
+            sumCycles[t] += cycles;
+        }
+    }
+    PRINT("%sFrame build cost in CPU cycles (%u runs)", MoveCursor(true), FRAME_BENCH_RUNS);
+    for (uint32_t t = FRAME_BENCH_FIRST; t < 7; t++) {
+        PRINT("%s  %-18s min=%4lu avg=%4lu", MoveCursor(true), names[t], minCycles[t], sumCycles[t] / FRAME_BENCH_RUNS);
+    }
+    PRINT("\r\n");
+}
+
+static void OnPtpSignaling(const signalingMsg_t *msg)
+{
+    PtpFollower_t *entry = NULL;
+    int8_t req = msg->tlv.timeSyncInterval;
+
+    if ((invert_uint16(msg->tlv.tlvType) != 0x0003u) || (msg->tlv.organizationSubType[2] != 0x02u) || (LOG_INTERVAL_NO_CHANGE == req)) {
+        return;
+    }
+    for (uint32_t i = 0; i < PTP_MAX_FOLLOWERS; i++) {
+        if (0 == memcmp(m.followers[i].clockIdentity, msg->header.sourcePortIdentity.clockIdentity, sizeof(clockIdentity_t))) {
+            entry = &m.followers[i];
+            break;
+        }
+        if ((NULL == entry) && !m.followers[i].active) {
+            entry = &m.followers[i];
+        }
+    }
+    if (NULL == entry) {
+        DBG_PRINT("No room for follower\r\n");
+        return;
+    }
+    memcpy(entry->clockIdentity, msg->header.sourcePortIdentity.clockIdentity, sizeof(clockIdentity_t));
+    if ((LOG_INTERVAL_STOP == req) || (LOG_INTERVAL_INITIAL == req)) {
+        entry->active = false;
+    } else {
+        if (req < SYNC_LOG_INTERVAL_MIN) req = SYNC_LOG_INTERVAL_MIN;
+        if (req > SYNC_LOG_INTERVAL_MAX) req = SYNC_LOG_INTERVAL_MAX;
+        entry->logSyncInterval = req;
+        entry->lastRequest = systick.tickCounter;
+        entry->active = true;
+    }
+    UpdateSyncInterval();
+}
+
+/* Sync goes to all followers on the segment, so the fastest request wins */
+static void UpdateSyncInterval(void)
+{
+    int8_t logInterval = SYNC_LOG_INTERVAL_MAX + 1;
+    uint32_t now = systick.tickCounter;
+
+    for (uint32_t i = 0; i < PTP_MAX_FOLLOWERS; i++) {
+        if (m.followers[i].active && ((now - m.followers[i].lastRequest) > PTP_SIGNALING_TIMEOUT_MS)) {
+            m.followers[i].active = false;
+        }
+        if (m.followers[i].active && (m.followers[i].logSyncInterval < logInterval)) {
+            logInterval = m.followers[i].logSyncInterval;
         }
     }
+    if (logInterval > SYNC_LOG_INTERVAL_MAX) {
+        logInterval = SYNC_LOG_INTERVAL_DEFAULT;
+    }
+    if (m.bench.active) {
+        logInterval = m.bench.logInterval;
+    }
+    if (logInterval != m.syncLogInterval) {
+        SetSyncPeriod(logInterval);
+        PRINT("%sSync interval 2^%d s (%lu ns)\r\n", MoveCursor(true), logInterval, m.syncPeriodNs);
+    }
+}
+
+static void SetSyncPeriod(int8_t logInterval)
+{
+    uint32_t freq = TC0_TimerFrequencyGet();
+    uint32_t ticks = (logInterval >= 0) ? (freq << logInterval) : (freq >> -logInterval);
+    uint64_t timeline;
+
+    NVIC_DisableIRQ(TC0_IRQn);
+    timeline = SyncTimelineNs();
+    m.syncLogInterval = logInterval;
+    m.syncPeriodMs = (logInterval >= 0) ? (1000u << logInterval) : (1000u >> -logInterval);
+    /* 2^-7 s is no whole number of timer ticks, the jitter is taken against the programmed period */
+    m.syncPeriodNs = (uint32_t)(((uint64_t)ticks * 1000000000u) / freq);
+    m.syncGuardTicks = (uint32_t)(((uint64_t)freq * SYNC_GUARD_TIME_US) / 1000000u);
+    /* The timeline restarts on the new grid, a full new period ahead so it stays monotonic */
+    m.syncTimelineNs = timeline + m.syncPeriodNs;
+    TC0_Timer32bitPeriodSet(ticks - 1u);
+    ptpFrameSetLogInterval(&m.syncFrame, logInterval);
+    ptpFrameSetLogInterval(&m.followUpFrame, logInterval);
+    /* A shorter period must not let the counter run past the new compare value */
+    TC0_Timer32bitCounterSet(0);
+    NVIC_EnableIRQ(TC0_IRQn);
+    TC6NoIP_TxGateSetWindow(m.idxNoIp, 0, m.syncTimelineNs, m.syncPeriodNs);
+    m.lastEgressValid = false;
+}
+
+/* true, while the next Sync is further away than the guard time */
+static bool SyncGuardClear(void)
+{
+    uint32_t left = TC0_Timer32bitPeriodGet() - TC0_Timer32bitCounterGet();
+    return (left > m.syncGuardTicks);
+}
+
+/* Time of the Sync timer, the Syncs are due at multiples of the period. An
+ * overflow not yet counted by the interrupt is off by one whole period, which
+ * does not move the gate windows. */
+static uint64_t SyncTimelineNs(void)
+{
+    uint64_t base;
+    uint32_t count;
+    do {
+        base = m.syncTimelineNs;
+        count = TC0_Timer32bitCounterGet();
+    } while (base != m.syncTimelineNs);
+    return base + (((uint64_t)count * m.syncPeriodNs) / ((uint64_t)TC0_Timer32bitPeriodGet() + 1u));
+}
+
+/* Steps the Sync rate from 2^SYNC_BENCH_LOG_INTERVAL_FIRST down to
+ * 2^SYNC_BENCH_LOG_INTERVAL_LAST, the follower requests are overruled meanwhile */
+static void SyncBenchStart(uint32_t now)
+{
+    memset(&m.bench, 0, sizeof(m.bench));
+    m.bench.logInterval = SYNC_BENCH_LOG_INTERVAL_FIRST;
+    m.bench.active = true;
+    m.bench.settling = true;
+    m.bench.stepMs = now;
+    UpdateSyncInterval();
+    PRINT("%sSync benchmark: %d rates, %d ms each, stress %s\r\n", MoveCursor(true), SYNC_BENCH_STEPS,
+          SYNC_BENCH_STEP_MS, m.allowTxStress ? "on" : "off");
+}
+
+static void SyncBenchService(uint32_t now)
+{
+    if (!m.bench.active) {
+        return;
+    }
+    if (m.bench.settling) {
+        if ((now - m.bench.stepMs) >= SYNC_BENCH_SETTLE_MS) {
+            memset(&m.ptpStats, 0, sizeof(m.ptpStats));
+            (void)TC6NoIP_GetSpiStats(m.idxNoIp, &m.bench.spiStart);
+            m.bench.dataStart = m.stats[BOARD_INSTANCE].byteCntTotal;
+            m.busyCycles = 0;
+            m.bench.startCycles = DWT->CYCCNT;
+            m.bench.stepMs = now;
+            m.bench.settling = false;
+        }
+    } else if ((now - m.bench.stepMs) >= SYNC_BENCH_STEP_MS) {
+        SyncBenchRecord(&m.bench.results[m.bench.step]);
+        m.bench.step++;
+        if (m.bench.logInterval > SYNC_BENCH_LOG_INTERVAL_LAST) {
+            m.bench.logInterval--;
+            m.bench.settling = true;
+            m.bench.stepMs = now;
+        } else {
+            m.bench.active = false;
+            PrintSyncBench();
+        }
+        UpdateSyncInterval();
+    }
+}
+
+static void SyncBenchRecord(SyncBenchResult_t *res)
+{
+    TC6NoIP_SpiStats_t spi;
+    PtpStats_t *ps = &m.ptpStats;
+
+    memset(res, 0, sizeof(SyncBenchResult_t));
+    (void)TC6NoIP_GetSpiStats(m.idxNoIp, &spi);
+    res->logInterval = m.bench.logInterval;
+    res->elapsedCycles = DWT->CYCCNT - m.bench.startCycles;
+    res->busyCycles = m.busyCycles;
+    res->syncCnt = ps->syncCnt;
+    res->followUpCnt = ps->followUpCnt;
+    res->timeoutCnt = ps->timeoutCnt;
+    res->overrunCnt = ps->overrunCnt;
+    if (!m.oneStep && (ps->syncCnt > ps->followUpCnt)) {
+        /* One FollowUp may still be on its way */
+        res->missingCnt = ps->syncCnt - ps->followUpCnt;
+        if (PTP_STATE_idle != m.ptpState) {
+            res->missingCnt--;
+        }
+    }
+    res->spiTransactions = spi.transactions - m.bench.spiStart.transactions;
+    res->spiBytes = spi.bytes - m.bench.spiStart.bytes;
+    res->spiClockHz = spi.clockHz;
+    res->dataBytes = m.stats[BOARD_INSTANCE].byteCntTotal - m.bench.dataStart;
+    res->followUpMaxUs = ps->followUpMaxUs;
+    if (ps->intervalCnt > 0) {
+        double mean = ps->intervalSum / ps->intervalCnt;
+        double var = (ps->intervalSumSq / ps->intervalCnt) - (mean * mean);
+        res->intervalMinNs = ps->intervalMinNs;
+        res->intervalMaxNs = ps->intervalMaxNs;
+        res->intervalRmsNs = (uint32_t)sqrt((var > 0.0) ? var : 0.0);
+    }
+}
+
+static void PrintSyncBench(void)
+{
+    int8_t maxRate = LOG_INTERVAL_NO_CHANGE;
+
+    PRINT("%sSync/s  sent  fup miss ovr  cpu us/sync  cpu%%  spi xfer/sync  B/sync  spi%%  fup max us  jitter min/max/rms ns  data kbit/s", MoveCursor(true));
+    for (uint8_t i = 0; i < m.bench.step; i++) {
+        SyncBenchResult_t *r = &m.bench.results[i];
+        uint32_t syncs = (r->syncCnt > 0) ? r->syncCnt : 1;
+        uint32_t elapsedUs = CyclesToUs(r->elapsedCycles);
+        uint32_t cpuPermille = (r->elapsedCycles > 0) ? (uint32_t)(((uint64_t)r->busyCycles * 1000u) / r->elapsedCycles) : 0;
+        uint32_t spiPermille = ((elapsedUs > 0) && (r->spiClockHz > 0)) ?
+            (uint32_t)(((uint64_t)r->spiBytes * 8u * 1000u * 1000000u) / ((uint64_t)r->spiClockHz * elapsedUs)) : 0;
+        uint32_t dataKbit = (elapsedUs > 0) ? (uint32_t)(((uint64_t)r->dataBytes * 8u * 1000u) / elapsedUs) : 0;
+        bool sustained = (r->syncCnt > 0) && (0 == r->missingCnt) && (0 == r->timeoutCnt) && (0 == r->overrunCnt);
+
+        PRINT("%s%s%6u %5lu %4lu %4lu %3lu %12lu %3lu.%lu %14lu %7lu %3lu.%lu %11lu %6li/%li/%lu %12lu" ESC_RESETCOLOR, MoveCursor(true),
+              sustained ? ESC_GREEN : ESC_RED, (1u << -r->logInterval), r->syncCnt, r->followUpCnt, r->missingCnt,
+              r->overrunCnt + r->timeoutCnt, CyclesToUs(r->busyCycles / syncs), cpuPermille / 10u, cpuPermille % 10u,
+              r->spiTransactions / syncs, r->spiBytes / syncs, spiPermille / 10u, spiPermille % 10u,
+              r->followUpMaxUs, r->intervalMinNs, r->intervalMaxNs, r->intervalRmsNs, dataKbit);
+        if (sustained && ((LOG_INTERVAL_NO_CHANGE == maxRate) || (r->logInterval < maxRate))) {
+            maxRate = r->logInterval;
+        }
+    }
+    if (LOG_INTERVAL_NO_CHANGE == maxRate) {
+        PRINT("%sNo Sync rate was sustained\r\n", MoveCursor(true));
+    } else {
+        PRINT("%sMax sustainable Sync rate: %u/s (2^%d s)\r\n", MoveCursor(true), (1u << -maxRate), maxRate);
+    }
+}
+
+/* Announce carries the clock quality as derived from the discipline state */
+static void PtpSendAnnounce(uint32_t now)
+{
+    GmDisciplineQuality_t q;
+    ptpFrame_t *frame = &m.announceFrame;
+
+    if ((now - m.nextAnnounce) > (uint32_t)INT32_MAX) {
+        return;
+    }
+    GmDiscipline_GetQuality(&q);
+    ptpFrameSetSequenceId(frame, m.announceSeqId);
+    ptpFrameSetAnnounceQuality(frame, PTP_FRAME_DEFAULT_PRIORITY, q.clockClass, q.clockAccuracy,
+                               q.offsetScaledLogVariance, PTP_FRAME_DEFAULT_PRIORITY, q.timeSource);
+    ptpFrameSetTimeProperties(frame, q.currentUtcOffset, q.utcOffsetValid, q.timeTraceable, q.frequencyTraceable);
+    m.txBusy = true;
+    if (TC6NoIP_SendEthernetPacket(m.idxNoIp, frame->buf, frame->len, OnSendIperf)) {
+        m.announceSeqId++;
+        m.nextAnnounce = now + ANNOUNCE_PERIOD_MS;
+    } else {
+        m.txBusy = false;
+    }
+}
+
+/* A step of the GM clock goes into the FollowUp TLV, the followers restart
+ * their filters instead of slewing through it */
+static void PtpUpdateTimeBase(void)
+{
+    GmDisciplineStatus_t st;
+    GmDiscipline_GetStatus(&st);
+    if (st.timeBaseIndicator != m.gmTimeBaseIndicator) {
+        m.gmTimeBaseIndicator = st.timeBaseIndicator;
+        ptpFrameSetGmTimeBase(&m.followUpFrame, st.timeBaseIndicator, st.lastPhaseChangeNs, st.lastFreqChange);
+    }
+}
+
+static void OnPpsCapture(TC_CAPTURE_STATUS status, uintptr_t context)
+{
+    (void)context;
+    if (0u != ((uint32_t)status & (uint32_t)TC_CAPTURE_STATUS_CAPTURE0_READY)) {
+        /* While calibrating, the external input carries the 1PPS of the reference follower */
+        if (GmEgressCal_IsActive()) {
+            GmEgressCal_OnRefPps(TC4_Capture32bitChannel0Get());
+        } else {
+            GmDiscipline_OnExtPps(TC4_Capture32bitChannel0Get());
+        }
+    }
+    if (0u != ((uint32_t)status & (uint32_t)TC_CAPTURE_STATUS_CAPTURE1_READY)) {
+        uint32_t lan = TC4_Capture32bitChannel1Get();
+        GmDiscipline_OnLanPps(lan);
+        GmEgressCal_OnLanPps(lan);
+    }
+}
+
+/* Same increment encoding as the follower: MAC_TI holds the whole ns,
+ * MAC_TISUBN the fraction in 2^-24 ns with the low byte on top */
+static bool DiscSetRate(double ppb)
+{
+    double inc = CLOCK_CYCLE_NS * (1.0 + (ppb * 1e-9));
+    uint8_t ti = (uint8_t)inc;
+    uint32_t sub = (uint32_t)((inc - (double)ti) * 16777216.0);
+    sub = ((sub >> 8) & 0xFFFFu) | ((sub & 0xFFu) << 24);
+    return TC6NoIP_WriteRegister(m.idxNoIp, MAC_TISUBN, sub, NULL) &&
+           TC6NoIP_WriteRegister(m.idxNoIp, MAC_TI, ti, NULL);
+}
+
+/* MAC_TA: bit 31 subtracts, the lower bits hold the ns */
+static bool DiscStepNs(int32_t ns)
+{
+    uint32_t value = (ns < 0) ? (0x80000000u | (uint32_t)-ns) : (uint32_t)ns;
+    return TC6NoIP_WriteRegister(m.idxNoIp, MAC_TA, value, NULL) &&
+           TC6NoIP_OnClockStep(m.idxNoIp);
+}
+
+static bool DiscSetTime(uint32_t sec, uint32_t nsec)
+{
+    const uint32_t values[2] = {sec, nsec};
+    return TC6NoIP_WriteRegister(m.idxNoIp, MAC_TSH, 0, NULL) &&
+           TC6NoIP_WriteRegisters(m.idxNoIp, MAC_TSL, values, 2u, NULL) &&
+           TC6NoIP_OnClockStep(m.idxNoIp);
+}
+
+static bool DiscReadTime(void)
+{
+    return TC6NoIP_ReadRegisters(m.idxNoIp, MAC_TSL, 2u, OnDiscTimeRead);
+}
+
+static void OnDiscTimeRead(int8_t idx, bool success, uint32_t addr, uint32_t value)
+{
+    (void)idx;
+    if (MAC_TSL == addr) {
+        m.discLanSec = value;
+        m.discLanValid = success;
+    } else {
+        GmDiscipline_OnLanTime(m.discLanValid && success, m.discLanSec, value, TC4_Capture32bitCounterGet());
+    }
+}
+
+static void PrintDiscipline(void)
+{
+    GmDisciplineStatus_t st;
+    GmDisciplineQuality_t q;
+    GmDiscipline_GetStatus(&st);
+    GmDiscipline_GetQuality(&q);
+    PRINT("%sGM discipline: %s offset=%li ns avg=%li ns freq=%li ppb", MoveCursor(true),
+          GmDiscipline_StateName(st.state), st.offsetNs, st.offsetAvgNs, (int32_t)st.freqPpb);
+    PRINT("%s  pps=%lu rejected=%lu steps=%lu ticks/s=%lu holdover=%lu s", MoveCursor(true),
+          st.ppsCnt, st.ppsRejectCnt, st.stepCnt, st.ticksPerSec, st.holdoverS);
+    PRINT("%s  nmea=%lu errors=%lu tai=%lu %s timeBase=%u", MoveCursor(true), st.nmeaCnt, st.nmeaErrorCnt,
+          st.taiSec, st.todValid ? "valid" : "unknown", st.timeBaseIndicator);
+    PRINT("%s  clockClass=%u accuracy=0x%02X timeSource=0x%02X\r\n", MoveCursor(true),
+          q.clockClass, q.clockAccuracy, q.timeSource);
+}
+
+/* Runs the servo against simulated clocks, the capture is stopped meanwhile
+ * and the discipline of the real clock starts over afterwards */
+static void RunDisciplineSelfTest(void)
+{
+    static const GmDisciplineSimCase_t cases[] = {
+        /* lanPpm, mcuPpm, lanOffsetNs, gapStartS, gapS, durationS, pRefOffsetNs */
+        {  20.0,  30.0,                 300000,  0,  0, 120, NULL },
+        { -50.0, -10.0,             -400000000,  0,  0, 120, NULL },
+        {  80.0, -40.0,            2250000000LL, 0,  0, 120, NULL },
+        {   5.0,   0.0,      100000123456LL, 0,  0, 120, NULL },
+        {  10.0,  20.0,                   5000, 60, 20, 150, NULL },
+    };
+    GmDisciplineSimResult_t r;
+
+    TC4_CaptureStop();
+    PRINT("%sDiscipline self-test, PTP paused", MoveCursor(true));
+    PRINT("%s  lan ppm  mcu ppm  offset us  lock s steps max ns final ns resid ppb state    class", MoveCursor(true));
+    for (uint32_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++) {
+        const GmDisciplineSimCase_t *c = &cases[i];
+        GmDiscipline_SelfTest(c, &r);
+        PRINT("%s%s  %7li %8li %9li %7lu %5lu %6li %8li %9li %-8s %5u" ESC_RESETCOLOR, MoveCursor(true),
+              ((0u != r.lockS) && (GM_DISC_LOCKED == r.finalState)) ? ESC_GREEN : ESC_RED,
+              (int32_t)c->lanPpm, (int32_t)c->mcuPpm, (int32_t)(c->lanOffsetNs / 1000), r.lockS, r.stepCnt, r.maxLockedNs,
+              r.finalNs, (int32_t)r.residualPpb, GmDiscipline_StateName(r.finalState), r.finalClockClass);
+    }
+    PRINT("\r\n");
+    RestartDiscipline();
+}
+
+/* The latency depends on the SPI clock and the PLCA setup, a stored value is
+ * only taken for the setup it was measured with */
+static void LoadTxTimestampOffset(void)
+{
+    TC6NoIP_SpiStats_t spi;
+    int32_t offsetNs;
+
+    memset(&m.calSetup, 0, sizeof(m.calSetup));
+    if (TC6NoIP_GetSpiStats(m.idxNoIp, &spi)) {
+        m.calSetup.spiClockHz = spi.clockHz;
+    }
+    m.calSetup.plcaNodeId = T1S_PLCA_NODE_ID;
+    m.calSetup.plcaNodeCount = T1S_PLCA_NODE_COUNT;
+    m.calSetup.plcaBurstCount = T1S_PLCA_BURST_COUNT;
+    m.calSetup.plcaBurstTimer = T1S_PLCA_BURST_TIMER;
+    m.calSetup.txCutThrough = MAC_TX_CUT_THROUGH;
+    m.txOffsetCalibrated = GmEgressCal_Load(&m.calSetup, &offsetNs);
+    if (m.txOffsetCalibrated) {
+        m.txTimestampOffsetNs = offsetNs;
+    }
+    PRINT("%sTX timestamp offset %li ns (%s)\r\n", MoveCursor(true), m.txTimestampOffsetNs,
+          m.txOffsetCalibrated ? "calibrated" : "default, press 'e' to calibrate");
+}
+
+static void ToggleEgressCalibration(void)
+{
+    if (GmEgressCal_IsActive()) {
+        GmEgressCal_Abort();
+        PRINT("%sEgress calibration aborted, TX timestamp offset %li ns\r\n", MoveCursor(true), m.txTimestampOffsetNs);
+        return;
+    }
+    if (GM_REF_GNSS != m.reference) {
+        PRINT("%sEgress calibration needs the external input, switch back to it with 'a' first\r\n", MoveCursor(true));
+        return;
+    }
+    GmEgressCal_Start(&m.calSetup, m.txTimestampOffsetNs, systick.tickCounter);
+    m.calState = GM_EGRESS_CAL_SETTLE;
+    PRINT("%sEgress calibration: 1PPS of a synchronized follower on PB07, %d rounds of %d s + %d pulses",
+          MoveCursor(true), GM_EGRESS_CAL_ROUNDS, GM_EGRESS_CAL_SETTLE_S, GM_EGRESS_CAL_SAMPLES);
+    PRINT("%s  the GM clock discipline is in holdover meanwhile, reconnect its 1PPS afterwards\r\n", MoveCursor(true));
+}
+
+static void EgressCalService(uint32_t ticks, uint32_t now)
+{
+    GmEgressCalStatus_t st;
+    int32_t offsetNs;
+
+    if (GmEgressCal_Service(ticks, now, &offsetNs)) {
+        m.txTimestampOffsetNs = offsetNs;
+        GmEgressCal_GetStatus(&st);
+        PRINT("%sEgress calibration round %u: follower %li ns ahead (spread %li ns), offset now %li ns\r\n",
+              MoveCursor(true), st.round, st.lastErrorNs, st.lastSpreadNs, offsetNs);
+    }
+    GmEgressCal_GetStatus(&st);
+    if (st.state == m.calState) {
+        return;
+    }
+    m.calState = st.state;
+    if (GM_EGRESS_CAL_DONE == st.state) {
+        m.txOffsetCalibrated = true;
+        PRINT("%s" ESC_GREEN "Egress calibration done: TX timestamp offset %li ns, residual %li ns, stored" ESC_RESETCOLOR "\r\n",
+              MoveCursor(true), m.txTimestampOffsetNs, st.lastErrorNs);
+    } else if (GM_EGRESS_CAL_FAILED == st.state) {
+        PRINT("%s" ESC_RED "Egress calibration failed after %u rounds (error %li ns, spread %li ns, %u pulses), offset %li ns" ESC_RESETCOLOR "\r\n",
+              MoveCursor(true), st.round, st.lastErrorNs, st.lastSpreadNs, st.samples, m.txTimestampOffsetNs);
+    }
+}
+
+/* The discipline starts over on the current reference, the capture is stopped
+ * by the caller */
+static void RestartDiscipline(void)
+{
+    GmDiscipline_Init(&discActuator, TC4_CaptureFrequencyGet());
+    GmDiscipline_SetTimeSource((GM_REF_GNSS != m.reference) ? GM_DISC_TIME_SOURCE_PTP : GM_DISC_TIME_SOURCE_GNSS);
+    m.gmTimeBaseIndicator = 0;
+    TC4_CaptureStart();
+}
+
+/* TC4 capture channel 0 takes either the external 1PPS (EIC EXTINT7) or the
+ * compare event of the GMAC timer, both on the asynchronous path */
+static void SelectPpsSource(bool tsu)
+{
+    EVSYS_REGS->CHANNEL[0].EVSYS_CHANNEL = EVSYS_CHANNEL_EVGEN(tsu ? EVENT_ID_GEN_GMAC_TSU_CMP : EVENT_ID_GEN_EIC_EXTINT_7) |
+                                           EVSYS_CHANNEL_PATH(2U) | EVSYS_CHANNEL_EDGSEL(0U);
+}
+
+/* External 1PPS -> boundary clock -> transparent clock -> external 1PPS. The
+ * backbone port and the discipline keep running from boundary to transparent,
+ * the T1S clock stays the time base of the residence time. */
+static void CycleReference(void)
+{
+    if (GmEgressCal_IsActive()) {
+        PRINT("%sEgress calibration is running, abort it first\r\n", MoveCursor(true));
+        return;
+    }
+    /* A capture still due belongs to the old mode */
+    m.ptpState = PTP_STATE_idle;
+    switch (m.reference) {
+        case GM_REF_GNSS:
+            m.reference = GM_REF_BOUNDARY;
+            TC4_CaptureStop();
+            GmBackbone_Init(m.backboneMac, m.clockIdentity);
+            SelectPpsSource(true);
+            RestartDiscipline();
+            PRINT("%sBoundary clock: backbone port %02X:%02X:%02X:%02X:%02X:%02X, the GM follows its timer\r\n",
+                  MoveCursor(true), m.backboneMac[0], m.backboneMac[1], m.backboneMac[2], m.backboneMac[3],
+                  m.backboneMac[4], m.backboneMac[5]);
+            break;
+        case GM_REF_BOUNDARY:
+            m.reference = GM_REF_TRANSPARENT;
+            GmTransparent_Init(m.t1sMac);
+            GmBackbone_SetRelay(GmTransparent_OnIngress);
+            PRINT("%sTransparent clock: Sync/FollowUp/Announce of the backbone master are forwarded\r\n", MoveCursor(true));
+            break;
+        default:
+            m.reference = GM_REF_GNSS;
+            TC4_CaptureStop();
+            GmBackbone_Stop();
+            SelectPpsSource(false);
+            RestartDiscipline();
+            PRINT("%sBackbone port off, the GM follows the external 1PPS\r\n", MoveCursor(true));
+            break;
+    }
 }
 
+/* The TSU pulse reaches the discipline through the event system, its second
+ * comes from here in place of an NMEA sentence */
+static void BoundaryService(uint32_t now)
+{
+    uint32_t taiSec;
+
+    GmBackbone_Service(now);
+    if (GmBackbone_GetPps(&taiSec)) {
+        GmDiscipline_SetTod(taiSec);
+    }
+}
+
+/* Forwards what the backbone master sends instead of the own Syncs. The
+ * egress timestamp comes in through OnPtpTxTimestamp() like for an own Sync,
+ * it only counts while the T1S clock is locked to the TSU. */
+static void TransparentService(uint32_t now)
+{
+    const ptpFrame_t *frame;
+    GmDisciplineStatus_t st;
+    bool timestamp;
+    bool sent;
+
+    m.syncDue = false;
+    if ((PTP_STATE_wait_timestamp == m.ptpState) && ((now - m.stateMs) > SYNC_TIMESTAMP_TIMEOUT_MS)) {
+        m.ptpStats.timeoutCnt++;
+        m.ptpState = PTP_STATE_idle;
+        GmTransparent_OnEgress(false, 0, 0);
+    }
+    if (PTP_STATE_send_followup == m.ptpState) {
+        GmDiscipline_GetStatus(&st);
+        GmTransparent_OnEgress(GM_DISC_LOCKED == st.state,
+                               ((int64_t)m.timestampSec * MAX_MAC_TN_VAL) + m.timestampNsec + m.txTimestampOffsetNs,
+                               st.offsetNs);
+        m.ptpState = PTP_STATE_idle;
+    }
+    if (m.txBusy || (PTP_STATE_idle != m.ptpState)) {
+        return;
+    }
+    frame = GmTransparent_GetTx(&timestamp);
+    if (NULL == frame) {
+        return;
+    }
+    m.txBusy = true;
+    if (timestamp) {
+        m.calibrate = false;
+        sent = TC6NoIP_SendEthernetPacket_TimestampA(m.idxNoIp, frame->buf, frame->len, OnSendIperf);
+    } else {
+        sent = TC6NoIP_SendEthernetPacket(m.idxNoIp, frame->buf, frame->len, OnSendIperf);
+    }
+    if (!sent) {
+        m.txBusy = false;
+        return;
+    }
+    GmTransparent_OnSent();
+    m.ptpStats.byteCnt += frame->len;
+    if (timestamp) {
+        m.stateMs = now;
+        m.ptpState = PTP_STATE_wait_timestamp;
+    }
+    TC6NoIP_Service();
+}
+
+static void PrintBackbone(void)
+{
+    GmBackboneStatus_t st;
+    GmTransparentStatus_t tc;
+
+    if (GM_REF_GNSS == m.reference) {
+        PRINT("%sBackbone port is off, press 'a' to turn it on\r\n", MoveCursor(true));
+        return;
+    }
+    GmBackbone_GetStatus(&st);
+    PRINT("%sBackbone port: link %s %s %s, %s offset=%li ns avg=%li ns freq=%li ppb", MoveCursor(true),
+          st.linkUp ? "up" : "down", st.speed100 ? "100M" : "10M", st.fullDuplex ? "FD" : "HD",
+          GmBackbone_StateName(st.state), st.offsetNs, st.offsetAvgNs, (int32_t)st.freqPpb);
+    PRINT("%s  master %02X%02X%02X.%02X%02X.%02X%02X%02X-%u pathDelay=%li ns (%s)", MoveCursor(true),
+          st.masterIdentity[0], st.masterIdentity[1], st.masterIdentity[2], st.masterIdentity[3],
+          st.masterIdentity[4], st.masterIdentity[5], st.masterIdentity[6], st.masterIdentity[7],
+          st.masterPort, st.pathDelayNs, st.pathDelayValid ? "valid" : "unknown");
+    PRINT("%s  sync=%lu followUp=%lu timeouts=%lu steps=%lu pps=%lu tai=%lu", MoveCursor(true),
+          st.syncCnt, st.followUpCnt, st.syncTimeoutCnt, st.stepCnt, st.ppsCnt, st.taiSec);
+    PRINT("%s  pdelay=%lu lost=%lu rejected=%lu answered=%lu rx=%lu txBusy=%lu", MoveCursor(true),
+          st.pdelayCnt, st.pdelayLostCnt, st.pdelayRejectCnt, st.pdelayAnsweredCnt, st.rxFrameCnt, st.txBusyCnt);
+    if (GM_REF_TRANSPARENT == m.reference) {
+        GmTransparent_GetStatus(&tc);
+        PRINT("%s  forwarded sync=%lu followUp=%lu (one-step %lu) announce=%lu lost=%lu rejected=%lu dropped=%lu",
+              MoveCursor(true), tc.syncCnt, tc.followUpCnt, tc.oneStepCnt, tc.announceCnt, tc.lostCnt,
+              tc.rejectCnt, tc.dropCnt);
+        PRINT("%s  residence last=%li min=%li avg=%li max=%li ns, link delay %li ns added", MoveCursor(true),
+              tc.residenceNs, tc.residenceMinNs, tc.residenceAvgNs, tc.residenceMaxNs, tc.linkDelayNs);
+    }
+    PRINT("\r\n");
+}
+
+/* Runs the backbone servo against a simulated master, then the discipline
+ * against the TSU pulses it produced, so the whole chain from the backbone to
+ * the T1S clock is covered. The capture is stopped meanwhile. */
+static void RunBoundarySelfTest(void)
+{
+    static const GmBackboneSimCase_t cases[] = {
+        /* tsuPpm, tsuOffsetNs, pathDelayNs, syncJitterNs, syncGapStartS, syncGapS, durationS */
+        {  15.0,                  250000,  500,    0,  0,  0, 120 },
+        { -40.0,           -3000000000LL, 2000,  200,  0,  0, 120 },
+        {  60.0,               12345678,   800,  150,  0,  0, 120 },
+        {  10.0,                       0,  500,  100, 60, 10, 150 },
+        {   0.3, -1760000000000000000LL,   500,   50,  0,  0, 120 },  /* TSU from reset */
+    };
+    static int32_t ppsErrorNs[GM_BB_SIM_MAX_S + 1];
+    GmBackboneSimResult_t r;
+    GmDisciplineSimResult_t dr;
+
+    TC4_CaptureStop();
+    PRINT("%sBoundary clock self-test, PTP paused", MoveCursor(true));
+    PRINT("%s  tsu ppm delay ns jitter  lock s steps max ns delay err resid ppb state    | T1S lock s max ns state", MoveCursor(true));
+    for (uint32_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++) {
+        const GmBackboneSimCase_t *c = &cases[i];
+        /* ppsErrorNs holds GM_BB_SIM_MAX_S + 1 seconds, the discipline must not read beyond */
+        uint32_t durationS = (c->durationS < GM_BB_SIM_MAX_S) ? c->durationS : GM_BB_SIM_MAX_S;
+        GmDisciplineSimCase_t dc = {20.0, 30.0, 300000, 0, 0, durationS, ppsErrorNs};
+        bool pass;
 
+        GmBackbone_SelfTest(c, &r, ppsErrorNs);
+        GmDiscipline_SelfTest(&dc, &dr);
+        pass = (0u != r.lockS) && (GM_BB_LOCKED == r.finalState) && (0u != dr.lockS) && (GM_DISC_LOCKED == dr.finalState);
+        PRINT("%s%s  %7li %8lu %6lu %7lu %5lu %6li %9li %9li %-8s | %10lu %6li %-8s" ESC_RESETCOLOR, MoveCursor(true),
+              pass ? ESC_GREEN : ESC_RED, (int32_t)c->tsuPpm, c->pathDelayNs, c->syncJitterNs, r.lockS, r.stepCnt,
+              r.maxLockedNs, r.delayErrorNs, (int32_t)r.residualPpb, GmBackbone_StateName(r.finalState),
+              dr.lockS, dr.maxLockedNs, GmDiscipline_StateName(dr.finalState));
+    }
+    PRINT("\r\n");
+    if (GM_REF_GNSS != m.reference) {
+        GmBackbone_Init(m.backboneMac, m.clockIdentity);
+    }
+    if (GM_REF_TRANSPARENT == m.reference) {
+        GmBackbone_SetRelay(GmTransparent_OnIngress);
+    }
+    RestartDiscipline();
+}
+
+/* Forwards Syncs through a simulated node and checks the offset a follower
+ * sees. The error left is that of the clock offset handed over, the
+ * timestamp resolution and the TSU rate error over the residence time. */
+static void RunTransparentSelfTest(void)
+{
+    static const GmTransparentSimCase_t cases[] = {
+        /* pathDelayNs, residenceMinNs, residenceMaxNs, tsuPpm, clockOffsetErrNs, oneStep, followUpFirst, syncs */
+        {  500,  50000,  400000,  0.0,   0, false, false, 400 },
+        {  500,  50000,  400000,  0.0,   0, false,  true, 400 },
+        {  800,  50000,  900000,  0.0,  20,  true, false, 400 },
+        {  500,  50000,  400000,  0.1, -30, false,  true, 400 },
+        { 2000, 200000, 5000000, 50.0,   0, false, false, 400 },  /* TSU not syntonized */
+    };
+    GmTransparentSimResult_t r;
+
+    PRINT("%sTransparent clock self-test", MoveCursor(true));
+    PRINT("%s  delay ns residence us tsu ppm offset err sync     | fwd residence us max err ns uncorrected ns", MoveCursor(true));
+    for (uint32_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++) {
+        const GmTransparentSimCase_t *c = &cases[i];
+        /* Two timestamps of 8 ns resolution */
+        int32_t tolerance = abs(c->clockOffsetErrNs) + 16 + (int32_t)(fabs(c->tsuPpm) * c->residenceMaxNs * 1e-6);
+        bool pass;
+
+        GmTransparent_SelfTest(c, &r);
+        pass = (r.forwarded == c->syncs) && (r.maxErrorNs <= tolerance);
+        PRINT("%s%s  %8lu %5lu-%-6lu %7li %10li %-8s | %3lu %5li-%-6li %10li %14li" ESC_RESETCOLOR, MoveCursor(true),
+              pass ? ESC_GREEN : ESC_RED, c->pathDelayNs, c->residenceMinNs / 1000u, c->residenceMaxNs / 1000u,
+              (int32_t)c->tsuPpm, c->clockOffsetErrNs, c->oneStep ? "one-step" : "two-step", r.forwarded,
+              r.residenceMinNs / 1000, r.residenceMaxNs / 1000, r.maxErrorNs, r.maxUncorrectedNs);
+    }
+    PRINT("\r\n");
+    if (GM_REF_TRANSPARENT == m.reference) {
+        GmTransparent_Init(m.t1sMac);
+    }
+}
+
+#if FRAME_BENCH_LEGACY==1
 static uint32_t invert_uint32(const uint32_t in_var)
 {
     uint32_t out_var = 0;
@@ -682,6 +1752,7 @@ static uint32_t invert_uint32(const uint32_t in_var)
                 (uint32_t)( ((in_var & 0xff000000) >> 24) <<  0) ;
     return out_var;
 }
+#endif
 
 static uint16_t invert_uint16(const uint16_t in_var)
 {
@@ -694,6 +1765,9 @@ static uint16_t invert_uint16(const uint16_t in_var)
 static uint32_t init_PTP_master(void)
 {
     uint32_t res = TC6_ptp_master_init(m.idxNoIp);
+    if ((0 == res) && !TC6NoIP_SetTxTimestampCallback(m.idxNoIp, OnPtpTxTimestamp)) {
+        res = (uint32_t)-12;
+    }
     return res;
 }
 static char *MoveCursor(bool newLine)
@@ -717,15 +1791,68 @@ static void PrintMenu(void)
     PRINT("%s c - clear screen", MoveCursor(true));
     PRINT("%s s - clear statisitcs", MoveCursor(true));
     PRINT("%s i - toggle stress tx test", MoveCursor(true));
+    PRINT("%s o - toggle one-step / two-step sync", MoveCursor(true));
+    PRINT("%s t - print PTP statistics", MoveCursor(true));
+    PRINT("%s b - run / abort Sync rate benchmark", MoveCursor(true));
+    PRINT("%s f - measure PTP frame build cost", MoveCursor(true));
+    PRINT("%s d - print GM clock discipline status", MoveCursor(true));
+    PRINT("%s x - run GM discipline self-test (synthetic 1PPS/NMEA)", MoveCursor(true));
+    PRINT("%s e - start / abort egress latency calibration", MoveCursor(true));
+    PRINT("%s g - toggle TX gate (data held off around Sync/FollowUp)", MoveCursor(true));
+    PRINT("%s a - cycle reference: external 1PPS / boundary clock / transparent clock", MoveCursor(true));
+    PRINT("%s p - print backbone port status", MoveCursor(true));
+    PRINT("%s k - run boundary clock self-test (synthetic backbone)", MoveCursor(true));
+    PRINT("%s j - run transparent clock self-test (simulated bridge)", MoveCursor(true));
+    PRINT("%s n - hand the console input to the NMEA time receiver (ESC to leave)", MoveCursor(true));
     PRINT("%s======================\r\n", MoveCursor(true));
 }
 
+static void PrintPtpStats(void)
+{
+    uint32_t syncs = (m.ptpStats.syncCnt > 0) ? m.ptpStats.syncCnt : 1;
+    PRINT("%sPTP %s-step: Sync=%lu FollowUp=%lu", MoveCursor(true), m.oneStep ? "one" : "two",
+          m.ptpStats.syncCnt, m.ptpStats.followUpCnt);
+    PRINT("%s  bytes/sync=%lu regAccess/sync=%lu.%02lu", MoveCursor(true), m.ptpStats.byteCnt / syncs,
+          m.ptpStats.regAccessCnt / syncs, ((m.ptpStats.regAccessCnt % syncs) * 100) / syncs);
+    PRINT("%s  egressLatency=%li ns calibrations=%lu txTimestampOffset=%li ns (%s)", MoveCursor(true), m.egressLatencyNs,
+          m.ptpStats.calibrationCnt, m.txTimestampOffsetNs, m.txOffsetCalibrated ? "calibrated" : "default");
+    PRINT("%s  timer overruns=%lu timestamp timeouts=%lu dispatch max=%lu us", MoveCursor(true),
+          m.ptpStats.overrunCnt, m.ptpStats.timeoutCnt, m.ptpStats.dispatchMaxUs);
+    if (m.ptpStats.intervalCnt > 0) {
+        double mean = m.ptpStats.intervalSum / m.ptpStats.intervalCnt;
+        double var = (m.ptpStats.intervalSumSq / m.ptpStats.intervalCnt) - (mean * mean);
+        PRINT("%s  Sync period jitter: min=%li max=%li rms=%lu ns (%lu periods)", MoveCursor(true),
+              m.ptpStats.intervalMinNs, m.ptpStats.intervalMaxNs, (uint32_t)sqrt((var > 0.0) ? var : 0.0),
+              m.ptpStats.intervalCnt);
+    }
+    if (m.ptpStats.followUpCnt > 0) {
+        PRINT("%s  FollowUp after Sync: min=%lu avg=%lu max=%lu us", MoveCursor(true), m.ptpStats.followUpMinUs,
+              m.ptpStats.followUpSumUs / m.ptpStats.followUpCnt, m.ptpStats.followUpMaxUs);
+    }
+    PrintTxGateStats();
+    PRINT("\r\n");
+}
+
 static void CheckUartInput(void)
 {
     static uint8_t m_rx = 0;
 
     if (m_rx && SERCOM1_USART_ReadCountGet()) {
+        if (m.nmeaConsole) {
+            /* The time receiver owns the console input until ESC */
+            if (KEY_ESC == m_rx) {
+                m.nmeaConsole = false;
+                PRINT("%sConsole back in command mode\r\n", MoveCursor(true));
+            } else {
+                (void)GmDiscipline_NmeaPutChar((char)m_rx);
+            }
+            m_rx = 0;
+        }
         switch(m_rx) {
+            case 0:
+            case '\r':
+            case '\n':
+                break;
             case 'M':
             case 'm':
                 PrintMenu();
@@ -742,12 +1869,75 @@ static void CheckUartInput(void)
             case 'S':
             case 's':
                 memset(m.stats, 0, sizeof(m.stats));
+                memset(&m.ptpStats, 0, sizeof(m.ptpStats));
+                m.lastEgressValid = false;
                 break;
             case 'I':
             case 'i':
                 m.allowTxStress = !m.allowTxStress;
                 PRINT("%sStress is %s\r\n", MoveCursor(true), m.allowTxStress ? "enabled" : "disabled");
                 break;
+            case 'O':
+            case 'o':
+                m.oneStep = !m.oneStep;
+                memset(&m.ptpStats, 0, sizeof(m.ptpStats));
+                PRINT("%sSync is %s-step\r\n", MoveCursor(true), m.oneStep ? "one" : "two");
+                break;
+            case 'T':
+            case 't':
+                PrintPtpStats();
+                break;
+            case 'F':
+            case 'f':
+                PrintFrameBuildCost();
+                break;
+            case 'B':
+            case 'b':
+                if (m.bench.active) {
+                    m.bench.active = false;
+                    UpdateSyncInterval();
+                    PRINT("%sSync benchmark aborted\r\n", MoveCursor(true));
+                } else {
+                    SyncBenchStart(systick.tickCounter);
+                }
+                break;
+            case 'D':
+            case 'd':
+                PrintDiscipline();
+                break;
+            case 'X':
+            case 'x':
+                RunDisciplineSelfTest();
+                break;
+            case 'E':
+            case 'e':
+                ToggleEgressCalibration();
+                break;
+            case 'G':
+            case 'g':
+                ToggleTxGate();
+                break;
+            case 'A':
+            case 'a':
+                CycleReference();
+                break;
+            case 'P':
+            case 'p':
+                PrintBackbone();
+                break;
+            case 'K':
+            case 'k':
+                RunBoundarySelfTest();
+                break;
+            case 'J':
+            case 'j':
+                RunTransparentSelfTest();
+                break;
+            case 'N':
+            case 'n':
+                m.nmeaConsole = true;
+                PRINT("%sConsole input goes to the NMEA parser, ESC returns to command mode\r\n", MoveCursor(true));
+                break;
             default:
                 PRINT("%sUnknown key='%c'(0x%X)\r\n", MoveCursor(true), m_rx, m_rx);
                 break;
@@ -758,6 +1948,29 @@ static void CheckUartInput(void)
     }
 }
 
+static void ToggleTxGate(void)
+{
+    PrintTxGateStats();
+    TC6NoIP_TxGateEnable(m.idxNoIp, !TC6NoIP_TxGateIsEnabled(m.idxNoIp));
+    PRINT("%sTX gate is %s\r\n", MoveCursor(true), TC6NoIP_TxGateIsEnabled(m.idxNoIp) ? "on" : "off");
+}
+
+/* Data throughput and FollowUp latency, separately for the gate off and on */
+static void PrintTxGateStats(void)
+{
+    TC6NoIP_TxGateStats_t st;
+    uint8_t on;
+    for (on = 0; on < 2u; on++) {
+        if (TC6NoIP_GetTxGateStats(m.idxNoIp, (0u != on), &st) && (st.ms > 0u)) {
+            PRINT("%s  TX gate %s: data %lu kbit/s (%lu frames, held off %lu), FollowUp after Sync avg=%lu max=%lu us (%lu)",
+                  MoveCursor(true), on ? "on " : "off", (uint32_t)(((uint64_t)st.bulkBytes * 8u) / st.ms),
+                  st.bulkFrames, st.heldOff,
+                  (st.ptpFrames > 0u) ? (uint32_t)(st.ptpLatencySumNs / st.ptpFrames / 1000u) : 0u,
+                  st.ptpLatencyMaxNs / 1000u, st.ptpFrames);
+        }
+    }
+}
+
 static void OnSendIperf(void *pDummy, const uint8_t *pTx, uint16_t len, uint32_t idx, void *pDummy2)
 {
     m.txBusy = false;
@@ -775,7 +1988,7 @@ static void SendIperfPacket(void)
         iperf[i++] = (m.iperfTx >> 8) & 0xFF;
         iperf[i++] = (m.iperfTx) & 0xFF;
         m.txBusy = true;
-        if (TC6NoIP_SendEthernetPacket(m.idxNoIp, iperf, len, OnSendIperf)) {
+        if (TC6NoIP_SendBulkEthernetPacket(m.idxNoIp, iperf, len, OnSendIperf)) {
             m.iperfTx++;
             m.stats[BOARD_INSTANCE].packetCntCurrent++;
             m.stats[BOARD_INSTANCE].packetCntTotal++;
@@ -803,6 +2016,13 @@ static void CheckButton(uint8_t instance, bool newLevel, bool *oldLevel)
 
 void TC6NoIP_CB_OnEthernetReceive(int8_t idx, const uint8_t *pRx, uint16_t len)
 {
+    if ((len >= (BUFFER_HEADER_LEN + sizeof(signalingMsg_t))) && (0x88 == pRx[12]) && (0xF7 == pRx[13])) {
+        const signalingMsg_t *msg = (const signalingMsg_t *)&pRx[BUFFER_HEADER_LEN];
+        if (MSG_SIGNALING == (msg->header.tsmt & 0x0Fu)) {
+            OnPtpSignaling(msg);
+        }
+        return;
+    }
     if (len >= (UDP_PAYLOAD_OFFSET + 5)) {
         uint16_t i = UDP_PAYLOAD_OFFSET;
         uint8_t idx = pRx[i++];
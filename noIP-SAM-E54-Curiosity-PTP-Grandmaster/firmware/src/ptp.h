@@ -26,16 +26,51 @@ Microchip or any third party.
 #ifndef PTP_H
 #define	PTP_H
 
+/* TX capture to follower ingress, used until a calibration for this setup
+ * is stored, see gm_egress_cal.h */
 #define STATIC_OFFSET               7650
 #define MAX_MAC_TN_VAL              0x3B9ACA00
+#define CLOCK_CYCLE_NS              40      /* nominal MAC_TI, 25 MHz */
+#define ANNOUNCE_PERIOD_MS          1000
 #define SYNC_MESSAGE_PERIOD_MS      125
-#define SYN_MESSAGE_CLEAR_TIME_MS   5
 #define MAX_NUM_REG_RETRIES         5
-
-#define MAX_DELAY_MS                50
+/* No data frame is started closer than this to the next Sync, a full sized
+ * frame occupies the 10 Mbit/s segment for about 1.2 ms */
+#define SYNC_GUARD_TIME_US          1500
+/* With the TX gate on, data also stays off the medium this long after the
+ * Sync, until the FollowUp is out */
+#define SYNC_FOLLOWUP_GUARD_US      1000
+/* Sync engine: a state that does not advance within this time (missed
+ * capture, failed register read) is dropped and the next Sync starts over.
+ * At high Sync rates the Sync period is the limit instead. */
+#define SYNC_TIMESTAMP_TIMEOUT_MS   20
+
+/* 802.1AS message interval requests, intervals are log2 of the interval in seconds */
+#define SYNC_LOG_INTERVAL_DEFAULT   (-3)    /* 2^-3 s = SYNC_MESSAGE_PERIOD_MS */
+#define SYNC_LOG_INTERVAL_MIN       (-7)    /* 128 Sync/s */
+#define SYNC_LOG_INTERVAL_MAX       (0)
+#define LOG_INTERVAL_NO_CHANGE      (-128)
+#define LOG_INTERVAL_INITIAL        (126)
+#define LOG_INTERVAL_STOP           (127)
+#define PTP_MAX_FOLLOWERS           8
+#define PTP_SIGNALING_TIMEOUT_MS    30000
+
+/* One-step Sync: originTimestamp = MAC_TSL/MAC_TN read + egress latency.
+ * The latency is re-calibrated against the TX timestamp capture every
+ * ONE_STEP_CALIBRATION_INTERVAL Syncs, the initial value is only a start point. */
+#define ONE_STEP_EGRESS_LATENCY_NS      250000
+#define ONE_STEP_CALIBRATION_INTERVAL   16
+#define ONE_STEP_ROLLOVER_GUARD_NS      1000000
+
+/* Sync rate benchmark: every interval from FIRST down to LAST is held for
+ * SYNC_BENCH_STEP_MS, statistics start after SYNC_BENCH_SETTLE_MS */
+#define SYNC_BENCH_LOG_INTERVAL_FIRST   (-3)
+#define SYNC_BENCH_LOG_INTERVAL_LAST    SYNC_LOG_INTERVAL_MIN
+#define SYNC_BENCH_STEPS                (SYNC_BENCH_LOG_INTERVAL_FIRST - SYNC_BENCH_LOG_INTERVAL_LAST + 1)
+#define SYNC_BENCH_STEP_MS              5000
+#define SYNC_BENCH_SETTLE_MS            500
 
 #define BUFFER_HEADER_LEN           14
-const uint8_t buffer_header[BUFFER_HEADER_LEN] = {0x01, 0x80, 0xc2, 0x00, 0x00, 0x0e, 0x40, 0x84, 0x32, 0x7d, 0x07, 0xfa, 0x88, 0xf7};
 
 typedef enum
 {
@@ -46,7 +81,8 @@ typedef enum
   MSG_FOLLOW_UP         = 0x08,
   MSG_DELAY_RESP        = 0x09,
   MSG_PDELAY_RESP_FUP   = 0x0A,
-  MSG_ANNOUNCE          = 0x0B
+  MSG_ANNOUNCE          = 0x0B,
+  MSG_SIGNALING         = 0x0C
 } ptpMsgType_t;
 
 typedef struct
@@ -116,15 +152,33 @@ typedef struct
   tlv_followUp_t        tlv;
 } followUpMsg_t;
 
+typedef struct
+{
+  uint16_t              tlvType;
+  uint16_t              lengthField;
+  uint8_t               organizationId[3];
+  uint8_t               organizationSubType[3];
+  int8_t                linkDelayInterval;
+  int8_t                timeSyncInterval;
+  int8_t                announceInterval;
+  uint8_t               flags;
+  uint8_t               reserved[2];
+} tlv_msgIntervalReq_t;
+
+typedef struct
+{
+  ptpHeader_t           header;
+  portIdentity_t        targetPortIdentity;
+  tlv_msgIntervalReq_t  tlv;
+} signalingMsg_t;
+
 typedef enum
 {
-    PTP_STATE_send_sync = 0,
-    PTP_STATE_get_tx_status,
-    PTP_STATE_get_oa_status0,
-    PTP_STATE_get_timestamp_reg_sec,
-	PTP_STATE_get_timestamp_reg_nsec,
-    PTP_STATE_clear_status_reg,
-    PTP_STATE_send_followup
+    PTP_STATE_idle = 0,             /* Waiting for the Sync timer */
+    PTP_STATE_read_time,            /* One-step: MAC_TSL/MAC_TN reads in flight */
+    PTP_STATE_send_sync,            /* Sync ready, waiting for the TX path */
+    PTP_STATE_wait_timestamp,       /* Sync sent, waiting for the capture interrupt */
+    PTP_STATE_send_followup         /* Capture read, FollowUp ready */
 }enum_PTP_task_state;
 
 #endif	/* PTP_H */
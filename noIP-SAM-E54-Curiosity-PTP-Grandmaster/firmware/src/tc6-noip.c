@@ -45,6 +45,7 @@ Microchip or any third party.
 #include <stdio.h>
 #include "tc6-conf.h"
 #include "tc6-regs.h"
+#include "tc6-events.h"
 #include "tc6-stub.h"
 #include "tc6-noip.h"
 
@@ -77,6 +78,23 @@ Microchip or any third party.
 #define ESC_BLUE                    "\033[0;36m"
 #define TC6_NUM_RETRIES             5
 
+typedef struct
+{
+    uint64_t anchorNs;
+    uint32_t periodNs;
+} TxGateWindow_t;
+
+typedef struct
+{
+    TC6NoIP_GetTimeNs_t getTime;
+    TxGateWindow_t windows[TC6NOIP_TX_GATE_WINDOWS];
+    TC6NoIP_TxGateStats_t stats[2];     /* [0] gate open, [1] gate active */
+    uint32_t sinceMs;
+    uint32_t preNs;
+    uint32_t postNs;
+    bool enabled;
+} TxGate_t;
+
 typedef struct
 {
     uint8_t ethRxBuf[1516];
@@ -84,6 +102,12 @@ typedef struct
     TC6_t *tc6;
     struct pbuf *pbuf;
     TC6NoIP_On_PlcaStatus pStatusCallback;
+    TxGate_t gate;
+    TC6NoIP_OnTxTimestamp_t pTxTsCallback;
+    uint32_t txTsSec;
+    uint32_t spiTransactions;
+    uint32_t spiBytes;
+    bool txTsValid;
     uint16_t rxLen;
     bool rxInvalid;
 } TC6Lib_t;
@@ -103,8 +127,12 @@ static TC6NoIP_t mlw[TC6_MAX_INSTANCES];
 
 static void PrintRateLimited(const char *statement, ...);
 static void OnPlcaStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
+static bool TxGateClosed(TxGate_t *pg, bool *pNoTime);
+static void OnTxTimestamp(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
+static void OnRegRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag);
 static bool TC6_ptp_master_init_write_helper(int8_t idx, TC6_t *pInst, uint32_t addr, uint32_t value, bool secure, TC6_RegCallback_t txCallback, void *pTag);
 static bool TC6_ptp_master_init_RMW_helper(int8_t idx, TC6_t *pInst, uint32_t addr, uint32_t value, uint32_t mask, bool secure, TC6_RegCallback_t modifyCallback, void *pTag);
+static bool TC6_ptp_master_init_events_helper(int8_t idx, TC6_t *pInst);
 
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                         PUBLIC FUNCTIONS                             */
@@ -220,6 +248,180 @@ bool TC6NoIP_GetMacAddress(int8_t idx, uint8_t mac[6])
     return success;
 }
 
+bool TC6NoIP_SetTxTimestampCallback(int8_t idx, TC6NoIP_OnTxTimestamp_t txTsCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TC6NoIP_t *lw = &mlw[idx];
+        /* IMASK0: unmask TTSCAA so the capture raises the extended status */
+        success = TC6_WriteRegister(lw->tc.tc6, OA_IMASK0, ((NULL != txTsCallback) ? 0x00000000u : 0x00000100u), true, NULL, NULL);
+        if (success) {
+            lw->tc.pTxTsCallback = txTsCallback;
+        }
+    }
+    return success;
+}
+
+bool TC6NoIP_ReadRegister(int8_t idx, uint32_t addr, TC6NoIP_OnRegRead_t readCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != readCallback)) {
+        success = TC6_ReadRegister(mlw[idx].tc.tc6, addr, true, OnRegRead, (void *)readCallback);
+    }
+    return success;
+}
+
+bool TC6NoIP_ReadRegisters(int8_t idx, uint32_t addr, uint8_t count, TC6NoIP_OnRegRead_t readCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != readCallback)) {
+        success = TC6_ReadRegisters(mlw[idx].tc.tc6, addr, count, true, OnRegRead, (void *)readCallback);
+    }
+    return success;
+}
+
+bool TC6NoIP_WriteRegister(int8_t idx, uint32_t addr, uint32_t value, TC6NoIP_OnRegRead_t writeCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        success = TC6_WriteRegister(mlw[idx].tc.tc6, addr, value, true,
+                                    (NULL != writeCallback) ? OnRegRead : NULL, (void *)writeCallback);
+    }
+    return success;
+}
+
+bool TC6NoIP_WriteRegisters(int8_t idx, uint32_t addr, const uint32_t *pValues, uint8_t count, TC6NoIP_OnRegRead_t writeCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != pValues)) {
+        success = TC6_WriteRegisters(mlw[idx].tc.tc6, addr, pValues, count, true,
+                                     (NULL != writeCallback) ? OnRegRead : NULL, (void *)writeCallback);
+    }
+    return success;
+}
+
+bool TC6NoIP_OnClockStep(int8_t idx)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        success = TC6Events_OnClockStep(mlw[idx].tc.tc6);
+    }
+    return success;
+}
+
+bool TC6NoIP_GetSpiStats(int8_t idx, TC6NoIP_SpiStats_t *pStats)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != pStats)) {
+        TC6NoIP_t *lw = &mlw[idx];
+        pStats->transactions = lw->tc.spiTransactions;
+        pStats->bytes = lw->tc.spiBytes;
+        pStats->clockHz = TC6Stub_GetSpiSpeed(lw->idx);
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateSetup(int8_t idx, TC6NoIP_GetTimeNs_t getTime, uint32_t preNs, uint32_t postNs)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        pg->getTime = getTime;
+        pg->preNs = preNs;
+        pg->postNs = postNs;
+        pg->sinceMs = TC6Stub_GetTick();
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateSetWindow(int8_t idx, uint8_t window, uint64_t anchorNs, uint32_t periodNs)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (window < TC6NOIP_TX_GATE_WINDOWS)) {
+        TxGateWindow_t *pw = &mlw[idx].tc.gate.windows[window];
+        pw->anchorNs = anchorNs;
+        pw->periodNs = periodNs;
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateEnable(int8_t idx, bool enable)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        uint32_t now = TC6Stub_GetTick();
+        pg->stats[pg->enabled ? 1 : 0].ms += now - pg->sinceMs;
+        pg->sinceMs = now;
+        pg->enabled = enable;
+        success = true;
+    }
+    return success;
+}
+
+bool TC6NoIP_TxGateIsEnabled(int8_t idx)
+{
+    bool enabled = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        enabled = mlw[idx].tc.gate.enabled;
+    }
+    return enabled;
+}
+
+bool TC6NoIP_SendBulkEthernetPacket(int8_t idx, const uint8_t *pTx, uint16_t len, TC6NoIP_OnTxCallback_t txCallback)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        TC6NoIP_TxGateStats_t *ps = &pg->stats[pg->enabled ? 1 : 0];
+        bool noTime = false;
+        if (TxGateClosed(pg, &noTime)) {
+            ps->heldOff++;
+        } else {
+            uint32_t idxCpy = idx;
+            success = TC6_SendRawEthernetPacket(mlw[idx].tc.tc6, pTx, len, 0, (TC6_RawTxCallback_t)txCallback, (void *)idxCpy);
+            if (success) {
+                ps->bulkFrames++;
+                ps->bulkBytes += len;
+                if (noTime) {
+                    ps->noTime++;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+void TC6NoIP_TxGateAddPtpLatency(int8_t idx, uint32_t latencyNs)
+{
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        TC6NoIP_TxGateStats_t *ps = &pg->stats[pg->enabled ? 1 : 0];
+        if (latencyNs > ps->ptpLatencyMaxNs) {
+            ps->ptpLatencyMaxNs = latencyNs;
+        }
+        ps->ptpLatencySumNs += latencyNs;
+        ps->ptpFrames++;
+    }
+}
+
+bool TC6NoIP_GetTxGateStats(int8_t idx, bool enabled, TC6NoIP_TxGateStats_t *pStats)
+{
+    bool success = false;
+    if ((idx >= 0) && (idx < TC6_MAX_INSTANCES) && (NULL != pStats)) {
+        TxGate_t *pg = &mlw[idx].tc.gate;
+        *pStats = pg->stats[enabled ? 1 : 0];
+        if (enabled == pg->enabled) {
+            pStats->ms += TC6Stub_GetTick() - pg->sinceMs;
+        }
+        success = true;
+    }
+    return success;
+}
+
 static bool TC6_ptp_master_init_write_helper(int8_t idx, TC6_t *pInst, uint32_t addr, uint32_t value, bool secure, TC6_RegCallback_t txCallback, void *pTag)
 {
     bool success = false;
@@ -238,6 +440,24 @@ static bool TC6_ptp_master_init_write_helper(int8_t idx, TC6_t *pInst, uint32_t
     return success;
 }
 
+//Event generator helper, enables the EGxDONE interrupts
+static bool TC6_ptp_master_init_events_helper(int8_t idx, TC6_t *pInst)
+{
+    bool success = false;
+    TC6NoIP_t *lw = &mlw[idx];
+    for( uint32_t x = 0; x < TC6_NUM_RETRIES; x++)
+    {
+        if(true == TC6Events_Init(pInst) )
+        {
+            success = true;
+            TC6_Service(lw->tc.tc6, true);
+            break;
+        }
+        TC6_Service(lw->tc.tc6, true);
+    }
+    return success;
+}
+
 //Read-Modify-Write helper
 static bool TC6_ptp_master_init_RMW_helper(int8_t idx, TC6_t *pInst, uint32_t addr, uint32_t value, uint32_t mask, bool secure, TC6_RegCallback_t modifyCallback, void *pTag)
 {
@@ -281,9 +501,32 @@ uint32_t TC6_ptp_master_init(int8_t idx)
     if(false == TC6_ptp_master_init_RMW_helper(idx, lw->tc.tc6, PADCTRL, 0x100, 0x300, true, NULL, NULL) ) return -9;
     
     if(false == TC6_ptp_master_init_write_helper(idx, lw->tc.tc6, PPSCTL, 0x0000007Du, true, NULL, NULL) ) return -10;
+    if(false == TC6_ptp_master_init_events_helper(idx, lw->tc.tc6) ) return -11;
     return 0;
 }
 
+static void OnTxTimestamp(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
+{
+    TC6NoIP_t *lw = pGlobalTag;
+    (void)pInst;
+    (void)tag;
+    if ((OA_TTSCAH == addr) && success) {
+        lw->tc.txTsSec = value;
+        lw->tc.txTsValid = true;
+    } else if (NULL != lw->tc.pTxTsCallback) {
+        lw->tc.pTxTsCallback((int8_t)lw->idx, (success && lw->tc.txTsValid), lw->tc.txTsSec, value);
+        lw->tc.txTsValid = false;
+    }
+}
+
+static void OnRegRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
+{
+    TC6NoIP_t *lw = pGlobalTag;
+    TC6NoIP_OnRegRead_t readCallback = (TC6NoIP_OnRegRead_t)tag;
+    (void)pInst;
+    readCallback((int8_t)lw->idx, success, addr, value);
+}
+
 static void _ReadComplete(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *tag, void *pGlobalTag)
 {
     (void)pInst;
@@ -468,7 +711,14 @@ void TC6Regs_CB_OnEvent(TC6_t *pInst, TC6Regs_Event_t event, void *pTag)
             PRINT(ESC_CLEAR_LINE ESC_GREEN "[%d]PHY_Interrupt" ESC_RESETCOLOR "\r\n", lw->idx);
             break;
         case TC6Regs_Event_Transmit_Timestamp_Capture_Available_A:
-            PRINT(ESC_CLEAR_LINE ESC_GREEN "[%d]Transmit_Timestamp_Capture_Available_A" ESC_RESETCOLOR "\r\n", lw->idx);
+            if (NULL != lw->tc.pTxTsCallback) {
+                /* Both halves in one control transaction, ahead of the status clear */
+                if (!TC6_ReadRegisters(pInst, OA_TTSCAH, 2u, true, OnTxTimestamp, NULL)) {
+                    lw->tc.pTxTsCallback((int8_t)lw->idx, false, 0u, 0u);
+                }
+            } else {
+                PRINT(ESC_CLEAR_LINE ESC_GREEN "[%d]Transmit_Timestamp_Capture_Available_A" ESC_RESETCOLOR "\r\n", lw->idx);
+            }
             break;
         case TC6Regs_Event_Transmit_Timestamp_Capture_Available_B:
             PRINT(ESC_CLEAR_LINE ESC_GREEN "[%d]Transmit_Timestamp_Capture_Available_B" ESC_RESETCOLOR "\r\n", lw->idx);
@@ -524,7 +774,7 @@ void TC6Regs_CB_OnEvent(TC6_t *pInst, TC6Regs_Event_t event, void *pTag)
             PRINT(ESC_CLEAR_LINE ESC_YELLOW "[%d]MCLK_GEN_Status" ESC_RESETCOLOR "\r\n", lw->idx);
             break;
         case TC6Regs_Event_gPTP_PA_TS_EG_Status:
-            PRINT(ESC_CLEAR_LINE ESC_YELLOW "g[%d]PTP_PA_TS_EG_Status" ESC_RESETCOLOR "\r\n", lw->idx);
+            /* Periodic (PPS, event generators), SEVSTS is handled by tc6-events */
             break;
         case TC6Regs_Event_Extended_Block_Status:
             PRINT(ESC_CLEAR_LINE ESC_YELLOW "[%d]Extended_Block_Status" ESC_RESETCOLOR "\r\n", lw->idx);
@@ -556,6 +806,37 @@ void TC6Regs_CB_OnEvent(TC6_t *pInst, TC6Regs_Event_t event, void *pTag)
     }
 }
 
+/* true, while now lies within preNs ahead or postNs after one of the protected transmissions */
+static bool TxGateClosed(TxGate_t *pg, bool *pNoTime)
+{
+    uint64_t now;
+    uint8_t i;
+    if (!pg->enabled || (NULL == pg->getTime)) {
+        return false;
+    }
+    now = pg->getTime();
+    if (0u == now) {
+        *pNoTime = true;
+        return false;
+    }
+    for (i = 0; i < TC6NOIP_TX_GATE_WINDOWS; i++) {
+        const TxGateWindow_t *pw = &pg->windows[i];
+        uint64_t phase;
+        if (0u == pw->periodNs) {
+            continue;
+        }
+        if (now >= pw->anchorNs) {
+            phase = (now - pw->anchorNs) % pw->periodNs;
+        } else {
+            phase = (pw->periodNs - ((pw->anchorNs - now) % pw->periodNs)) % pw->periodNs;
+        }
+        if ((phase < pg->postNs) || ((pw->periodNs - phase) <= pg->preNs)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void PrintRateLimited(const char *statement, ...)
 {
     static uint32_t cnt_ = 0;
@@ -598,5 +879,11 @@ static void OnPlcaStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t val
 
 bool TC6_CB_OnSpiTransaction(uint8_t tc6instance, uint8_t *pTx, uint8_t *pRx, uint16_t len, void *pGlobalTag)
 {
-    return TC6Stub_SpiTransaction(tc6instance, pTx, pRx, len);
+    TC6NoIP_t *lw = pGlobalTag;
+    bool success = TC6Stub_SpiTransaction(tc6instance, pTx, pRx, len);
+    if (success && (NULL != lw)) {
+        lw->tc.spiTransactions++;
+        lw->tc.spiBytes += len;
+    }
+    return success;
 }
@@ -122,6 +122,170 @@ bool TC6NoIP_SendEthernetPacket_TimestampA(int8_t idx, const uint8_t *pTx, uint1
  */
 bool TC6NoIP_GetMacAddress(int8_t idx, uint8_t mac[6]);
 
+/**
+ * \brief Callback when the transmit timestamp of a packet sent with TC6NoIP_SendEthernetPacket_TimestampA() is available.
+ * \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ * \param success - true, if the capture registers could be read. false, otherwise.
+ * \param sec - Seconds part of the timestamp (OA_TTSCAH).
+ * \param nsec - Nanoseconds part of the timestamp (OA_TTSCAL).
+ */
+typedef void (*TC6NoIP_OnTxTimestamp_t)(int8_t idx, bool success, uint32_t sec, uint32_t nsec);
+
+/** \brief Enables the timestamp capture A interrupt and registers the callback for it.
+ *  \note The capture is signaled by the MAC-PHY interrupt (extended status), OA_STATUS0 and TXMCTL do not need to be polled.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param txTsCallback - Callback function, NULL to stop reporting.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_SetTxTimestampCallback(int8_t idx, TC6NoIP_OnTxTimestamp_t txTsCallback);
+
+/**
+ * \brief Callback when a register access enqueued with TC6NoIP_ReadRegister() or TC6NoIP_WriteRegister() has finished.
+ * \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ * \param success - true, if the register was accessed. false, otherwise.
+ * \param addr - The register address.
+ * \param value - The register value, for a write the value written.
+ */
+typedef void (*TC6NoIP_OnRegRead_t)(int8_t idx, bool success, uint32_t addr, uint32_t value);
+
+/** \brief Enqueues a register read, the result is reported by callback.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param addr - The register address.
+ *  \param readCallback - Callback function.
+ *  \return true, if the read was enqueued. false, otherwise.
+ */
+bool TC6NoIP_ReadRegister(int8_t idx, uint32_t addr, TC6NoIP_OnRegRead_t readCallback);
+
+/** \brief Enqueues a read of consecutive registers as one control transaction, the callback is called once per register.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param addr - The address of the first register.
+ *  \param count - Number of registers, 1 up to TC6_MAX_CNTRL_VARS.
+ *  \param readCallback - Callback function.
+ *  \return true, if the read was enqueued. false, otherwise.
+ */
+bool TC6NoIP_ReadRegisters(int8_t idx, uint32_t addr, uint8_t count, TC6NoIP_OnRegRead_t readCallback);
+
+/** \brief Enqueues a register write.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param addr - The register address.
+ *  \param value - The value to write.
+ *  \param writeCallback - Callback function when the write has finished, may be NULL.
+ *  \return true, if the write was enqueued. false, otherwise.
+ */
+bool TC6NoIP_WriteRegister(int8_t idx, uint32_t addr, uint32_t value, TC6NoIP_OnRegRead_t writeCallback);
+
+/** \brief Enqueues a write of consecutive registers as one control transaction, so all values take effect together.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param addr - The address of the first register.
+ *  \param pValues - The values to write, copied before the function returns.
+ *  \param count - Number of registers, 1 up to TC6_MAX_CNTRL_VARS.
+ *  \param writeCallback - Callback function called once per register, may be NULL.
+ *  \return true, if the write was enqueued. false, otherwise.
+ */
+bool TC6NoIP_WriteRegisters(int8_t idx, uint32_t addr, const uint32_t *pValues, uint8_t count, TC6NoIP_OnRegRead_t writeCallback);
+
+/** \brief Tells the event generators that the PTP clock was stepped, so they get reprogrammed to the new time.
+ *  \note Call right after enqueuing a write to MAC_TA or MAC_TSL/MAC_TN.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \return true, if the reprogramming was enqueued or no event generator is active. false, otherwise.
+ */
+bool TC6NoIP_OnClockStep(int8_t idx);
+
+/**
+ * \brief SPI load of a MAC-PHY instance, the counters are free running since TC6NoIP_Init().
+ */
+typedef struct
+{
+    uint32_t transactions;      /* SPI transfers handed to the driver */
+    uint32_t bytes;             /* Bytes clocked in both directions per transfer */
+    uint32_t clockHz;           /* SPI clock, to turn bytes into bus utilization */
+} TC6NoIP_SpiStats_t;
+
+/** \brief Reads the SPI load counters.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param pStats - Filled with the current counter values.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_GetSpiStats(int8_t idx, TC6NoIP_SpiStats_t *pStats);
+
+/** \brief Number of protected windows of the TX gate per instance. */
+#define TC6NOIP_TX_GATE_WINDOWS     (4u)
+
+/**
+ * \brief Clock of the TX gate, the synchronized time in nanoseconds.
+ * \return The current time, 0 while it is not available. Bulk traffic then passes the gate.
+ */
+typedef uint64_t (*TC6NoIP_GetTimeNs_t)(void);
+
+/**
+ * \brief TX gate statistics, kept separately for the open (off) and the active (on) gate.
+ */
+typedef struct
+{
+    uint32_t ms;                /* Time spent in this gate state */
+    uint32_t bulkFrames;        /* Frames sent with TC6NoIP_SendBulkEthernetPacket() */
+    uint32_t bulkBytes;
+    uint32_t heldOff;           /* Bulk sends refused inside a protected window */
+    uint32_t noTime;            /* Bulk frames passed because the clock was not available */
+    uint32_t ptpFrames;         /* Latencies reported with TC6NoIP_TxGateAddPtpLatency() */
+    uint32_t ptpLatencyMaxNs;
+    uint64_t ptpLatencySumNs;
+} TC6NoIP_TxGateStats_t;
+
+/** \brief Sets up the time-aware TX gate, it holds bulk traffic off around the protected transmissions.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param getTime - The synchronized clock the windows are given in. NULL turns the gate off.
+ *  \param preNs - Guard time ahead of each protected transmission.
+ *  \param postNs - Guard time after each protected transmission, covers e.g. the FollowUp of a Sync.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateSetup(int8_t idx, TC6NoIP_GetTimeNs_t getTime, uint32_t preNs, uint32_t postNs);
+
+/** \brief Sets a recurring protected transmission, at anchorNs + k * periodNs.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param window - Window number, 0 up to TC6NOIP_TX_GATE_WINDOWS - 1.
+ *  \param anchorNs - Any one time of the transmission, in the clock given to TC6NoIP_TxGateSetup().
+ *  \param periodNs - Period of the transmission, 0 removes the window.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateSetWindow(int8_t idx, uint8_t window, uint64_t anchorNs, uint32_t periodNs);
+
+/** \brief Activates or opens the gate without losing its setup, the statistics switch along.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param enable - true, bulk traffic is held off inside the windows. false, it always passes.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_TxGateEnable(int8_t idx, bool enable);
+
+/** \brief Tells whether the gate is active.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \return true, if bulk traffic is held off inside the windows. false, otherwise.
+ */
+bool TC6NoIP_TxGateIsEnabled(int8_t idx);
+
+/** \brief Sends a raw Ethernet packet of bulk traffic through the TX gate.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param pTx - Filled byte array holding an entire Ethernet packet. Warning, the buffer must stay valid until the txCallback with this pointer as parameter was called.
+ *  \param len - Length of the byte array.
+ *  \param txCallback - Callback function if desired, NULL otherwise.
+ *  \return true, on success. false, the gate is closed or the queue is full, try again later.
+ */
+bool TC6NoIP_SendBulkEthernetPacket(int8_t idx, const uint8_t *pTx, uint16_t len, TC6NoIP_OnTxCallback_t txCallback);
+
+/** \brief Adds a PTP frame latency sample to the statistics of the current gate state.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param latencyNs - The latency as measured by the application, e.g. FollowUp after Sync.
+ */
+void TC6NoIP_TxGateAddPtpLatency(int8_t idx, uint32_t latencyNs);
+
+/** \brief Reads the TX gate statistics of one gate state.
+ *  \param idx - The instance number as returned from the TC6NoIP_Init() function.
+ *  \param enabled - true, for the statistics while the gate was active. false, while it was open.
+ *  \param pStats - Filled with the statistics.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6NoIP_GetTxGateStats(int8_t idx, bool enabled, TC6NoIP_TxGateStats_t *pStats);
+
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                 Callback to be implemented in higher layers          */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
@@ -195,6 +195,12 @@ bool TC6Stub_SpiTransaction(uint8_t idx, uint8_t *pTx, uint8_t *pRx, uint16_t le
     return success;
 }
 
+uint32_t TC6Stub_GetSpiSpeed(uint8_t idx)
+{
+    ASSERT(idx < TC6_MAX_INSTANCES);
+    return d[idx].spiSetup.baudRateInHz;
+}
+
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
@@ -76,4 +76,10 @@ uint32_t TC6Stub_GetTick(void);
  * \param len - The length of both buffers (pTx and pRx). The entire length must be transfered via SPI.
  * \return true, if the SPI data was enqueued/transfered. false, there was an error.
  */
-bool TC6Stub_SpiTransaction(uint8_t idx, uint8_t *pTx, uint8_t *pRx, uint16_t len);
\ No newline at end of file
+bool TC6Stub_SpiTransaction(uint8_t idx, uint8_t *pTx, uint8_t *pRx, uint16_t len);
+
+/** \brief Returns the SPI clock configured for the given instance.
+ *  \param idx - The instance number of the hardware. Starting with 0 for the first hardware.
+ *  \return The SPI clock in Hz.
+ */
+uint32_t TC6Stub_GetSpiSpeed(uint8_t idx);
\ No newline at end of file
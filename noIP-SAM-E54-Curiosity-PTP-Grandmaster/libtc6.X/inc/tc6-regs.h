@@ -42,6 +42,11 @@ Microchip or any third party.
 /*                            DEFINITIONS                               */
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 #define PADCTRL             (0x000A0088u)
+#define MAC_TISUBN          (0x0001006Fu)
+#define MAC_TSH             (0x00010070u)
+#define MAC_TSL             (0x00010074u)
+#define MAC_TN              (0x00010075u)
+#define MAC_TA              (0x00010076u)
 #define MAC_TI              (0x00010077u)
 #define TXMLOC              (0x00040045)
 #define TXMPATH             (0x00040041)
@@ -52,6 +57,7 @@ Microchip or any third party.
 #define PPSCTL              (0x000A0239u)
 #define OA_CONFIG0          (0x00000004)
 #define OA_STATUS0          (0x00000008)
+#define OA_IMASK0           (0x0000000C)    //Interrupt Mask Register 0
 #define OA_TTSCAH           (0x00000010)    //Transmit Timestamp Capture A High
 #define OA_TTSCAL           (0x00000011)    //Transmit Timestamp Capture A Low
 #define OA_TTSCBH           (0x00000012)    //Transmit Timestamp Capture B High
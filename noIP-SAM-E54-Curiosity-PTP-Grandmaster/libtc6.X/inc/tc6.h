@@ -227,6 +227,31 @@ bool TC6_ReadModifyWriteRegister(TC6_t *pInst, uint32_t addr, uint32_t value, ui
  */
 uint16_t TC6_MultipleRegisterAccess(TC6_t *pInst, const MemoryMap_t *pMap, uint16_t mapLength, TC6_RegCallback_t multipleCallback, void *pTag);
 
+/** \brief Writes consecutive MAC / Phy registers within a single control transaction
+ *  \note The registers are written back to back by the MAC-PHY, use it for register pairs which must not be updated independently.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param addr - The 32 Bit register offset of the first register.
+ *  \param pValues - The 32 Bit register values for addr, addr + 1, ... The values are copied, the array may be released after the call.
+ *  \param count - Number of registers to be written, 1 up to TC6_MAX_CNTRL_VARS.
+ *  \param secure - true, enables protected control data transmission (normal + inverted data). false, no protection feature is used.
+ *  \param txCallback - Pointer to a callback handler. May left NULL. The value given in the callback is the one of the first register.
+ *  \param pTag - Any pointer. Will be given back in given txCallback. May left NULL.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6_WriteRegisters(TC6_t *pInst, uint32_t addr, const uint32_t *pValues, uint8_t count, bool secure, TC6_RegCallback_t txCallback, void *pTag);
+
+
+/** \brief Reads consecutive MAC / Phy registers within a single control transaction
+ *  \note Saves the per-transaction overhead on the SPI for register pairs which are always read together.
+ *  \param pInst - The pointer returned by TC6_Init.
+ *  \param addr - The 32 Bit register offset of the first register.
+ *  \param count - Number of registers to be read, 1 up to TC6_MAX_CNTRL_VARS.
+ *  \param secure - true, enables protected control data transmission (normal + inverted data). false, no protection feature is used.
+ *  \param rxCallback - Pointer to a callback handler. May left NULL. It is called once per register, in ascending address order.
+ *  \param pTag - Any pointer. Will be given back in given rxCallback. May left NULL.
+ *  \return true, on success. false, otherwise.
+ */
+bool TC6_ReadRegisters(TC6_t *pInst, uint32_t addr, uint8_t count, bool secure, TC6_RegCallback_t rxCallback, void *pTag);
 
 /** \brief Reenable the reporting of extended status flag via TC6_CB_OnExtendedStatus() callback.
  *  \note This feature was introduced to not trigger thousands of extended status callbacks, when there is a lot of traffic ongoing.
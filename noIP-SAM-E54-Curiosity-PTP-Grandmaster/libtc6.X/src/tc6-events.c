@@ -0,0 +1,495 @@
+//DOM-IGNORE-BEGIN
+/*
+Copyright (C) 2023, Microchip Technology Inc., and its subsidiaries. All rights reserved.
+
+The software and documentation is provided by microchip and its contributors
+"as is" and any express, implied or statutory warranties, including, but not
+limited to, the implied warranties of merchantability, fitness for a particular
+purpose and non-infringement of third party intellectual property rights are
+disclaimed to the fullest extent permitted by law. In no event shall microchip
+or its contributors be liable for any direct, indirect, incidental, special,
+exemplary, or consequential damages (including, but not limited to, procurement
+of substitute goods or services; loss of use, data, or profits; or business
+interruption) however caused and on any theory of liability, whether in contract,
+strict liability, or tort (including negligence or otherwise) arising in any way
+out of the use of the software and documentation, even if advised of the
+possibility of such damage.
+
+Except as expressly permitted hereunder and subject to the applicable license terms
+for any third-party software incorporated in the software and any applicable open
+source software license terms, no license or other rights, whether express or
+implied, are granted under any patent or other intellectual property rights of
+Microchip or any third party.
+*/
+//DOM-IGNORE-END
+/*******************************************************************************
+  Event Generator and Event Capture Support for Microchip LAN865x 10BASE-T1S MACPHY
+
+  Company:
+    Microchip Technology Inc.
+    
+  File Name:
+    tc6-events.c
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "tc6.h"
+#include "tc6-conf.h"
+#include "tc6-events.h"
+
+/* LAN865x registers */
+#define EG0STNS             (0x000A0221u)   /* EGxSTNS, EGxSTSECL, EGxSTSECH, EGxPW, EGxIT, EGxCTL */
+#define EG_REG_STRIDE       (6u)
+#define EG_REG_COUNT        (6u)
+#define EG_CTL_OFFSET       (5u)
+#define SEVINTEN            (0x000A023Au)
+#define SEVSTS              (0x000A023Du)
+#define OA_IMASK1           (0x0000000Du)
+#define EC0CTL              (0x000A0204u)   /* ECxCTL, one per capture input */
+#define EC0TSSECH           (0x000A0210u)   /* ECxTSSECH, ECxTSSECL, ECxTSNS */
+#define EC_TS_STRIDE        (3u)
+#define EC_TS_COUNT         (3u)
+#define MAC_TSL             (0x00010074u)
+#define MAC_TN              (0x00010075u)
+
+#define EGCTL_START         (0x00000001u)
+#define EGCTL_STOP          (0x00000002u)
+#define EGCTL_AH            (0x00000004u)
+#define EGCTL_REP           (0x00000008u)
+#define SEV_EGDONE_POS      (16u)
+#define SEV_EGDONE_MASK     (0x000F0000u)
+#define SEV_ECCAP_POS       (20u)
+#define SEV_ECOVF_POS       (24u)
+#define ECCTL_EN            (0x00000001u)
+#define ECCTL_EDGE_POS      (1u)
+#define IMASK1_SEVM         (0x10000000u)
+
+#define NS_PER_SEC          (1000000000ull)
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                          USER ADJUSTABLE                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+#define CONTROL_PROTECTION      (true)
+#define REARM_LEAD_NS           (2000000ull)   /* Minimum distance to "now" when reprogramming after a clock step */
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                      DEFINES AND LOCAL VARIABLES                     */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+typedef struct
+{
+    TC6Events_EgDone_t doneCb;
+    void *pTag;
+    uint64_t anchorNs;      /* PTP time of the first pulse, in ns since epoch */
+    uint32_t widthNs;
+    uint32_t intervalNs;    /* 0 for one-shot */
+    uint32_t pulses;
+    uint8_t idx;
+    bool activeHigh;
+    TC6Events_EgState_t state;
+} TC6EventsEg_t;
+
+typedef struct
+{
+    TC6Events_OnCapture_t captureCb;
+    void *pTag;
+    uint32_t secHigh;       /* ECxTSSECH of the burst read in progress */
+    uint32_t secLow;        /* ECxTSSECL of the burst read in progress */
+    uint8_t idx;
+    bool enabled;
+} TC6EventsCap_t;
+
+typedef struct
+{
+    TC6_t *pTC6;
+    TC6EventsEg_t eg[TC6EVENTS_EG_COUNT];
+    TC6EventsCap_t cap[TC6EVENTS_CAP_COUNT];
+    TC6Events_Capture_t ring[TC6EVENTS_CAP_RING_SIZE];
+    TC6Events_CaptureStats_t capStats;
+    uint32_t stepTsl;
+    uint8_t ringIn;
+    uint8_t ringOut;
+    bool initialized;
+} TC6Events_t;
+
+static TC6Events_t m_ev[TC6_MAX_INSTANCES] = { 0 };
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                      PRIVATE FUNCTION PROTOTYPES                     */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static TC6Events_t *GetContext(TC6_t *pTC6);
+static bool Schedule(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, uint32_t intervalNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag);
+static bool ArmEg(TC6Events_t *pEv, TC6EventsEg_t *pEg, uint64_t startNs);
+static void OnEgArmed(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
+static void OnStepTime(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
+static void OnSevStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
+static void OnCaptureRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag);
+static void DeliverCapture(TC6Events_t *pEv, TC6EventsCap_t *pCap, uint64_t timestampNs);
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                         PUBLIC FUNCTIONS                             */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+bool TC6Events_Init(TC6_t *pInst)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if (NULL != pEv) {
+        uint8_t i;
+        for (i = 0u; i < TC6EVENTS_EG_COUNT; i++) {
+            (void)memset(&pEv->eg[i], 0, sizeof(TC6EventsEg_t));
+            pEv->eg[i].idx = i;
+        }
+        for (i = 0u; i < TC6EVENTS_CAP_COUNT; i++) {
+            (void)memset(&pEv->cap[i], 0, sizeof(TC6EventsCap_t));
+            pEv->cap[i].idx = i;
+        }
+        (void)memset(&pEv->capStats, 0, sizeof(pEv->capStats));
+        pEv->ringIn = 0u;
+        pEv->ringOut = 0u;
+        /* SEVINTEN is a set register, enable EG0DONE..EG3DONE, then let SEV raise STATUS1 */
+        success = TC6_WriteRegister(pInst, SEVINTEN, SEV_EGDONE_MASK, CONTROL_PROTECTION, NULL, NULL);
+        if (success) {
+            success = TC6_ReadModifyWriteRegister(pInst, OA_IMASK1, 0u, IMASK1_SEVM, CONTROL_PROTECTION, NULL, NULL);
+        }
+        pEv->initialized = success;
+    }
+    return success;
+}
+
+bool TC6Events_EgOneShot(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag)
+{
+    return Schedule(pInst, eg, startSec, startNs, widthNs, 0u, activeHigh, doneCb, pTag);
+}
+
+bool TC6Events_EgPeriodic(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, uint32_t intervalNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag)
+{
+    bool success = false;
+    if ((0u != intervalNs) && (widthNs < intervalNs)) {
+        success = Schedule(pInst, eg, startSec, startNs, widthNs, intervalNs, activeHigh, doneCb, pTag);
+    }
+    return success;
+}
+
+bool TC6Events_EgStop(TC6_t *pInst, uint8_t eg)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && (eg < TC6EVENTS_EG_COUNT)) {
+        success = TC6_WriteRegister(pInst, EG0STNS + (eg * EG_REG_STRIDE) + EG_CTL_OFFSET, EGCTL_STOP, CONTROL_PROTECTION, NULL, NULL);
+        if (success) {
+            pEv->eg[eg].state = TC6Events_EgState_Idle;
+        }
+    }
+    return success;
+}
+
+TC6Events_EgState_t TC6Events_GetEgState(TC6_t *pInst, uint8_t eg, uint32_t *pPulses)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    TC6Events_EgState_t state = TC6Events_EgState_Idle;
+    if ((NULL != pEv) && (eg < TC6EVENTS_EG_COUNT)) {
+        state = pEv->eg[eg].state;
+        if (NULL != pPulses) {
+            *pPulses = pEv->eg[eg].pulses;
+        }
+    }
+    return state;
+}
+
+bool TC6Events_CaptureEnable(TC6_t *pInst, uint8_t input, TC6Events_Edge_t edge, TC6Events_OnCapture_t captureCb, void *pTag)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && pEv->initialized && (input < TC6EVENTS_CAP_COUNT)) {
+        TC6EventsCap_t *pCap = &pEv->cap[input];
+        pCap->captureCb = captureCb;
+        pCap->pTag = pTag;
+        success = TC6_WriteRegister(pInst, EC0CTL + input, ECCTL_EN | ((uint32_t)edge << ECCTL_EDGE_POS), CONTROL_PROTECTION, NULL, NULL);
+        if (success) {
+            /* SEVINTEN is a set register, the other sources stay enabled */
+            success = TC6_WriteRegister(pInst, SEVINTEN, (1u << (SEV_ECCAP_POS + input)) | (1u << (SEV_ECOVF_POS + input)), CONTROL_PROTECTION, NULL, NULL);
+        }
+        pCap->enabled = success;
+    }
+    return success;
+}
+
+bool TC6Events_CaptureDisable(TC6_t *pInst, uint8_t input)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && (input < TC6EVENTS_CAP_COUNT)) {
+        success = TC6_WriteRegister(pInst, EC0CTL + input, 0u, CONTROL_PROTECTION, NULL, NULL);
+        if (success) {
+            pEv->cap[input].enabled = false;
+        }
+    }
+    return success;
+}
+
+bool TC6Events_CaptureGet(TC6_t *pInst, TC6Events_Capture_t *pCapture)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && (NULL != pCapture) && (pEv->ringIn != pEv->ringOut)) {
+        *pCapture = pEv->ring[pEv->ringOut];
+        pEv->ringOut = (uint8_t)((pEv->ringOut + 1u) % TC6EVENTS_CAP_RING_SIZE);
+        success = true;
+    }
+    return success;
+}
+
+bool TC6Events_GetCaptureStats(TC6_t *pInst, TC6Events_CaptureStats_t *pStats)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && (NULL != pStats)) {
+        *pStats = pEv->capStats;
+        success = true;
+    }
+    return success;
+}
+
+bool TC6Events_CaptureInject(TC6_t *pInst, uint8_t input, uint64_t timestampNs)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && (input < TC6EVENTS_CAP_COUNT) && pEv->cap[input].enabled) {
+        DeliverCapture(pEv, &pEv->cap[input], timestampNs);
+        success = true;
+    }
+    return success;
+}
+
+bool TC6Events_OnClockStep(TC6_t *pInst)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = true;
+    if ((NULL != pEv) && pEv->initialized) {
+        bool active = false;
+        uint8_t i;
+        for (i = 0u; i < TC6EVENTS_EG_COUNT; i++) {
+            TC6Events_EgState_t s = pEv->eg[i].state;
+            if ((TC6Events_EgState_Pending == s) || (TC6Events_EgState_Armed == s) || (TC6Events_EgState_Running == s)) {
+                active = true;
+            }
+        }
+        if (active) {
+            /* The new time is known only to the MAC-PHY, read it back in a single transaction */
+            success = TC6_ReadRegisters(pInst, MAC_TSL, 2u, CONTROL_PROTECTION, OnStepTime, pEv);
+        }
+    }
+    return success;
+}
+
+void TC6Events_OnStatus(TC6_t *pInst)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    if ((NULL != pEv) && pEv->initialized) {
+        while (!TC6_ReadRegister(pInst, SEVSTS, CONTROL_PROTECTION, OnSevStatus, pEv)) {
+            TC6_Service(pInst, true);
+        }
+    }
+}
+
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+/*                  PRIVATE FUNCTION IMPLEMENTATIONS                    */
+/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+
+static TC6Events_t *GetContext(TC6_t *pTC6)
+{
+    TC6Events_t *pEv = NULL;
+    uint8_t i;
+    /* Find existing entry */
+    for (i = 0u; (NULL == pEv) && (i < TC6_MAX_INSTANCES); i++) {
+        if (m_ev[i].pTC6 == pTC6) {
+            pEv = &m_ev[i];
+        }
+    }
+    /* If not found, find free entry */
+    for (i = 0u; (NULL == pEv) && (i < TC6_MAX_INSTANCES); i++) {
+        if (NULL == m_ev[i].pTC6) {
+            pEv = &m_ev[i];
+            pEv->pTC6 = pTC6;
+        }
+    }
+    return pEv;
+}
+
+static bool Schedule(TC6_t *pInst, uint8_t eg, uint64_t startSec, uint32_t startNs, uint32_t widthNs, uint32_t intervalNs, bool activeHigh, TC6Events_EgDone_t doneCb, void *pTag)
+{
+    TC6Events_t *pEv = GetContext(pInst);
+    bool success = false;
+    if ((NULL != pEv) && pEv->initialized && (eg < TC6EVENTS_EG_COUNT) && (startNs < NS_PER_SEC) && (0u != widthNs)) {
+        TC6EventsEg_t *pEg = &pEv->eg[eg];
+        pEg->doneCb = doneCb;
+        pEg->pTag = pTag;
+        pEg->anchorNs = (startSec * NS_PER_SEC) + startNs;
+        pEg->widthNs = widthNs;
+        pEg->intervalNs = intervalNs;
+        pEg->activeHigh = activeHigh;
+        pEg->pulses = 0u;
+        success = ArmEg(pEv, pEg, pEg->anchorNs);
+    }
+    return success;
+}
+
+static bool ArmEg(TC6Events_t *pEv, TC6EventsEg_t *pEg, uint64_t startNs)
+{
+    const uint32_t base = EG0STNS + (pEg->idx * EG_REG_STRIDE);
+    uint64_t sec = startNs / NS_PER_SEC;
+    uint32_t regs[EG_REG_COUNT];
+    bool success;
+
+    regs[0] = (uint32_t)(startNs % NS_PER_SEC);         /* EGxSTNS */
+    regs[1] = (uint32_t)sec;                            /* EGxSTSECL */
+    regs[2] = (uint32_t)((sec >> 32) & 0xFFFFu);        /* EGxSTSECH */
+    regs[3] = pEg->widthNs;                             /* EGxPW */
+    regs[4] = pEg->intervalNs;                          /* EGxIT */
+    regs[5] = EGCTL_START;                              /* EGxCTL, absolute start time */
+    if (pEg->activeHigh) {
+        regs[5] |= EGCTL_AH;
+    }
+    if (0u != pEg->intervalNs) {
+        regs[5] |= EGCTL_REP;
+    }
+    /* Stop first, so a running train never sees a half written start time */
+    success = TC6_WriteRegister(pEv->pTC6, base + EG_CTL_OFFSET, EGCTL_STOP, CONTROL_PROTECTION, NULL, NULL);
+    if (success) {
+        success = TC6_WriteRegisters(pEv->pTC6, base, regs, EG_REG_COUNT, CONTROL_PROTECTION, OnEgArmed, pEg);
+    }
+    pEg->state = success ? TC6Events_EgState_Pending : TC6Events_EgState_Failed;
+    return success;
+}
+
+static void OnEgArmed(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+    TC6EventsEg_t *pEg = pTag;
+    (void)addr;
+    (void)value;
+    (void)pGlobalTag;
+    if (TC6Events_EgState_Pending == pEg->state) {
+        if (success) {
+            pEg->state = (0u != pEg->intervalNs) ? TC6Events_EgState_Running : TC6Events_EgState_Armed;
+        } else {
+            pEg->state = TC6Events_EgState_Failed;
+            if (NULL != pEg->doneCb) {
+                pEg->doneCb(pInst, pEg->idx, false, pEg->pTag);
+            }
+        }
+    }
+}
+
+static void OnStepTime(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+    TC6Events_t *pEv = pTag;
+    (void)pGlobalTag;
+    if (MAC_TSL == addr) {
+        pEv->stepTsl = value;
+    } else if (success && (MAC_TN == addr)) {
+        uint8_t i;
+        for (i = 0u; i < TC6EVENTS_EG_COUNT; i++) {
+            TC6EventsEg_t *pEg = &pEv->eg[i];
+            /* MAC_TSH is not read, the upper seconds are taken over from the programmed start time */
+            uint64_t nowNs = ((((pEg->anchorNs / NS_PER_SEC) & 0xFFFF00000000ull) | pEv->stepTsl) * NS_PER_SEC) + value;
+            uint64_t earliest = nowNs + REARM_LEAD_NS;
+            uint64_t startNs = pEg->anchorNs;
+            if ((TC6Events_EgState_Pending != pEg->state) && (TC6Events_EgState_Armed != pEg->state) && (TC6Events_EgState_Running != pEg->state)) {
+                continue;
+            }
+            if ((startNs < earliest) && (0u != pEg->intervalNs)) {
+                /* Keep the pulse train on its original grid */
+                uint64_t k = ((earliest - startNs) + pEg->intervalNs - 1u) / pEg->intervalNs;
+                startNs += k * pEg->intervalNs;
+            }
+            if (startNs >= earliest) {
+                while (!ArmEg(pEv, pEg, startNs)) {
+                    TC6_Service(pInst, true);
+                }
+            } else {
+                pEg->state = TC6Events_EgState_Failed;
+                if (NULL != pEg->doneCb) {
+                    pEg->doneCb(pInst, pEg->idx, false, pEg->pTag);
+                }
+            }
+        }
+    }
+}
+
+static void OnSevStatus(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+    TC6Events_t *pEv = pTag;
+    (void)pGlobalTag;
+    if (success && (0u != value)) {
+        uint8_t i;
+        for (i = 0u; i < TC6EVENTS_EG_COUNT; i++) {
+            if (0u != (value & (1u << (SEV_EGDONE_POS + i)))) {
+                TC6EventsEg_t *pEg = &pEv->eg[i];
+                pEg->pulses++;
+                if (TC6Events_EgState_Armed == pEg->state) {
+                    pEg->state = TC6Events_EgState_Done;
+                }
+                if (NULL != pEg->doneCb) {
+                    pEg->doneCb(pInst, pEg->idx, true, pEg->pTag);
+                }
+            }
+        }
+        for (i = 0u; i < TC6EVENTS_CAP_COUNT; i++) {
+            TC6EventsCap_t *pCap = &pEv->cap[i];
+            if (0u != (value & (1u << (SEV_ECOVF_POS + i)))) {
+                pEv->capStats.hwOverruns++;
+            }
+            if (pCap->enabled && (0u != (value & (1u << (SEV_ECCAP_POS + i))))) {
+                /* Seconds and nanoseconds are latched together, fetch them in one transaction */
+                while (!TC6_ReadRegisters(pInst, EC0TSSECH + (i * EC_TS_STRIDE), EC_TS_COUNT, CONTROL_PROTECTION, OnCaptureRead, pCap)) {
+                    TC6_Service(pInst, true);
+                }
+            }
+        }
+        /* Write to clear pending flags */
+        while (!TC6_WriteRegister(pInst, addr, value, CONTROL_PROTECTION, NULL, NULL)) {
+            TC6_Service(pInst, true);
+        }
+    }
+}
+
+static void OnCaptureRead(TC6_t *pInst, bool success, uint32_t addr, uint32_t value, void *pTag, void *pGlobalTag)
+{
+    TC6EventsCap_t *pCap = pTag;
+    const uint32_t base = EC0TSSECH + (pCap->idx * EC_TS_STRIDE);
+    (void)pGlobalTag;
+    if (!success) {
+        /* A failed burst reports only once, the capture is lost */
+        pCap->secHigh = 0xFFFFFFFFu;
+        GetContext(pInst)->capStats.hwOverruns++;
+    } else if (base == addr) {
+        pCap->secHigh = value;
+    } else if ((base + 1u) == addr) {
+        pCap->secLow = value;
+    } else if (0xFFFFFFFFu != pCap->secHigh) {
+        uint64_t sec = ((uint64_t)(pCap->secHigh & 0xFFFFu) << 32) | pCap->secLow;
+        DeliverCapture(GetContext(pInst), pCap, (sec * NS_PER_SEC) + value);
+    }
+}
+
+static void DeliverCapture(TC6Events_t *pEv, TC6EventsCap_t *pCap, uint64_t timestampNs)
+{
+    pEv->capStats.captures++;
+    if (NULL != pCap->captureCb) {
+        pCap->captureCb(pEv->pTC6, pCap->idx, timestampNs, pCap->pTag);
+    } else {
+        uint8_t next = (uint8_t)((pEv->ringIn + 1u) % TC6EVENTS_CAP_RING_SIZE);
+        if (next == pEv->ringOut) {
+            /* Keep the older captures, they are the ones the reader expects next */
+            pEv->capStats.ringOverruns++;
+        } else {
+            pEv->ring[pEv->ringIn].timestampNs = timestampNs;
+            pEv->ring[pEv->ringIn].input = pCap->idx;
+            pEv->ringIn = next;
+        }
+    }
+}